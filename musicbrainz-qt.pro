@@ -8,12 +8,19 @@ CONFIG += c++17
 SOURCES += \
     src/main.cpp \
     src/mainwindow.cpp \
+    src/core/mbid.cpp \
     src/api/musicbrainzapi.cpp \
     src/api/musicbrainz_response_handler.cpp \
     src/api/musicbrainzparser.cpp \
     src/api/api_utils.cpp \
     src/api/network_manager.cpp \
+    src/api/musicbrainz_api_hub.cpp \
+    src/api/response_cache.cpp \
+    src/api/entity_store.cpp \
+    src/api/json_stream_reader.cpp \
     src/models/resultitem.cpp \
+    src/models/entityrecord.cpp \
+    src/models/entitypayload.cpp \
     src/models/resulttablemodel.cpp \
     src/ui/advancedsearchwidget.cpp \
     src/ui/searchresulttab.cpp \
@@ -22,7 +29,8 @@ SOURCES += \
     src/ui/widget_helpers.cpp \
     src/services/searchservice.cpp \
     src/services/entitydetailmanager.cpp \
-    src/utils/config_manager.cpp     src/ui/settingsdialog.cpp
+    src/utils/config_manager.cpp \
+    src/utils/string_pool.cpp     src/ui/settingsdialog.cpp
 
 HEADERS += \
     src/mainwindow.h \
@@ -30,8 +38,15 @@ HEADERS += \
     src/api/musicbrainz_response_handler.h \
     src/api/musicbrainzparser.h \
     src/api/api_utils.h \
+    src/api/entity_schema.h \
     src/api/network_manager.h \
+    src/api/musicbrainz_api_hub.h \
+    src/api/response_cache.h \
+    src/api/entity_store.h \
+    src/api/json_stream_reader.h \
     src/models/resultitem.h \
+    src/models/entityrecord.h \
+    src/models/entitypayload.h \
     src/models/resulttablemodel.h \
     src/ui/advancedsearchwidget.h \
     src/ui/searchresulttab.h \
@@ -42,7 +57,10 @@ HEADERS += \
     src/services/entitydetailmanager.h \
     src/core/types.h \
     src/core/error_types.h \
+    src/core/mbid.h \
     src/utils/config_manager.h \
+    src/utils/string_pool.h \
+    src/utils/perfect_hash.h \
     src/ui/settingsdialog.h
 
 FORMS +=     ui/mainwindow.ui     ui/itemdetailtab.ui     ui/entitylistwidget.ui     ui/advancedsearchwidget.ui     ui/searchresulttab.ui     ui/settingsdialog.ui
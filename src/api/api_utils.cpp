@@ -1,8 +1,9 @@
 #include "api_utils.h"
 #include "musicbrainzparser.h"
 #include "../models/resultitem.h"
+#include "../utils/perfect_hash.h"
+#include "../core/mbid.h"
 #include <QJsonDocument>
-#include <QRegularExpression>
 #include <algorithm>
 
 // UrlBuilder 实现
@@ -143,6 +144,28 @@ QString UrlBuilder::buildCollectionUrl(const QString& collectionId, const QStrin
     return url.toString();
 }
 
+QString UrlBuilder::canonicalizeUrl(const QString& url)
+{
+    QUrl parsed(url);
+    if (!parsed.isValid()) {
+        return url;
+    }
+    
+    parsed.setScheme(parsed.scheme().toLower());
+    parsed.setHost(parsed.host().toLower());
+    parsed.setFragment(QString());
+    
+    QUrlQuery query(parsed);
+    auto items = query.queryItems();
+    std::sort(items.begin(), items.end());
+    
+    QUrlQuery sortedQuery;
+    sortedQuery.setQueryItems(items);
+    parsed.setQuery(sortedQuery);
+    
+    return parsed.toString(QUrl::FullyEncoded);
+}
+
 // ResponseParser 实现
 QJsonObject ResponseParser::parseJsonResponse(const QByteArray& data, QString* error)
 {
@@ -214,13 +237,8 @@ QString ResponseParser::extractDiscIdFromUrl(const QString& url)
 // Validator 实现
 bool Validator::isValidMbid(const QString& mbid)
 {
-    if (mbid.isEmpty()) {
-        return false;
-    }
-    
     // MBID应该是UUID格式: xxxxxxxx-xxxx-xxxx-xxxx-xxxxxxxxxxxx
-    QRegularExpression uuidRegex("^[0-9a-fA-F]{8}-[0-9a-fA-F]{4}-[0-9a-fA-F]{4}-[0-9a-fA-F]{4}-[0-9a-fA-F]{12}$");
-    return uuidRegex.match(mbid).hasMatch();
+    return Mbid::isValid(mbid);
 }
 
 bool Validator::isValidEntity(const QString& entity)
@@ -257,15 +275,53 @@ QPair<int, int> Validator::validatePagination(int limit, int offset)
 // EntityUtils 实现（合并自musicbrainz_utils）
 // =============================================================================
 
+namespace {
+
+constexpr std::size_t ENTITY_COUNT = ENTITY_MAPPINGS.size();
+
+constexpr std::array<std::string_view, ENTITY_COUNT> entityNames(bool plural)
+{
+    std::array<std::string_view, ENTITY_COUNT> names = {};
+    for (std::size_t i = 0; i < ENTITY_COUNT; ++i) {
+        names[i] = plural ? ENTITY_MAPPINGS[i].plural : ENTITY_MAPPINGS[i].singular;
+    }
+    return names;
+}
+
+/**
+ * @brief 实体类型 → ENTITY_MAPPINGS中的序号（-1表示没有映射）
+ */
+constexpr std::array<int, static_cast<std::size_t>(EntityType::Unknown) + 1> mappingIndices()
+{
+    std::array<int, static_cast<std::size_t>(EntityType::Unknown) + 1> indices = {};
+    for (int &index : indices) {
+        index = -1;
+    }
+    for (std::size_t i = 0; i < ENTITY_COUNT; ++i) {
+        indices[static_cast<std::size_t>(ENTITY_MAPPINGS[i].type)] = static_cast<int>(i);
+    }
+    return indices;
+}
+
+constexpr PerfectHashTable<ENTITY_COUNT> SINGULAR_NAMES(entityNames(false));
+constexpr PerfectHashTable<ENTITY_COUNT> PLURAL_NAMES(entityNames(true));
+constexpr auto MAPPING_INDICES = mappingIndices();
+
+static_assert(SINGULAR_NAMES.isValid() && PLURAL_NAMES.isValid(), "Entity names must hash without collisions");
+static_assert(SINGULAR_NAMES.indexOf("release-group") >= 0
+              && ENTITY_MAPPINGS[SINGULAR_NAMES.indexOf("release-group")].type == EntityType::ReleaseGroup,
+              "Singular name table must match ENTITY_MAPPINGS");
+
+} // namespace
+
 namespace EntityUtils {
 
 constexpr const EntityMapping* findEntityMapping(EntityType type) noexcept {
-    for (const auto& mapping : ENTITY_MAPPINGS) {
-        if (mapping.type == type) {
-            return &mapping;
-        }
+    const auto slot = static_cast<std::size_t>(type);
+    if (slot >= MAPPING_INDICES.size() || MAPPING_INDICES[slot] < 0) {
+        return nullptr;
     }
-    return nullptr;
+    return &ENTITY_MAPPINGS[static_cast<std::size_t>(MAPPING_INDICES[slot])];
 }
 
 QString entityTypeToString(EntityType type)
@@ -276,16 +332,16 @@ QString entityTypeToString(EntityType type)
     return "unknown";
 }
 
-EntityType stringToEntityType(const QString &typeStr)
+EntityType stringToEntityType(QStringView typeStr)
 {
-    const auto typeView = typeStr.toLatin1();
-    
-    auto it = std::find_if(ENTITY_MAPPINGS.begin(), ENTITY_MAPPINGS.end(),
-        [&typeView](const EntityMapping& mapping) {
-            return mapping.singular == typeView.data();
-        });
-    
-    return (it != ENTITY_MAPPINGS.end()) ? it->type : EntityType::Unknown;
+    const int index = SINGULAR_NAMES.indexOf(typeStr);
+    return index >= 0 ? ENTITY_MAPPINGS[static_cast<std::size_t>(index)].type : EntityType::Unknown;
+}
+
+EntityType pluralNameToEntityType(QStringView pluralName)
+{
+    const int index = PLURAL_NAMES.indexOf(pluralName);
+    return index >= 0 ? ENTITY_MAPPINGS[static_cast<std::size_t>(index)].type : EntityType::Unknown;
 }
 
 QString getEntityPluralName(EntityType type)
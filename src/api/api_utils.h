@@ -66,9 +66,16 @@ namespace EntityUtils {
     QString entityTypeToString(EntityType type);
     
     /**
-     * @brief 字符串转实体类型
+     * @brief 字符串（单数实体名）转实体类型
+     *
+     * 通过编译时构造的完美哈希表查找，不分配内存。
      */
-    EntityType stringToEntityType(const QString &typeStr);
+    EntityType stringToEntityType(QStringView typeStr);
+    
+    /**
+     * @brief 复数实体名（列表响应中的数组键名）转实体类型
+     */
+    EntityType pluralNameToEntityType(QStringView pluralName);
     
     /**
      * @brief 获取实体复数名称
@@ -93,6 +100,30 @@ enum class RequestType {
     Collection
 };
 
+/**
+ * @brief 请求优先级
+ *
+ * 网络层按优先级调度等待中的请求，保证用户直接触发的请求不会排在后台加载之后。
+ */
+enum class RequestPriority {
+    Interactive = 0,    ///< 用户交互触发（搜索、打开详情页）
+    Prefetch,           ///< 预加载（选中项预览等）
+    Bulk                ///< 后台批量加载
+};
+
+/**
+ * @brief 请求优先级数量
+ */
+constexpr int REQUEST_PRIORITY_COUNT = 3;
+
+/**
+ * @brief 请求ID
+ *
+ * MusicBrainzApi的每个请求方法都返回一个请求ID，并在结果和错误信号中原样带回，
+ * 调用方据此把响应对应到发起的请求。0表示请求在发送前就已失败。
+ */
+using RequestId = quint64;
+
 
 
 /**
@@ -156,6 +187,14 @@ public:
      */
     static QString buildCollectionUrl(const QString& collectionId = QString(), 
                                      const QString& action = QString());
+    
+    /**
+     * @brief 规范化URL，用作请求去重的键
+     * 
+     * 协议和主机名转为小写，去掉片段，查询参数按键值排序，
+     * 因此参数顺序不同但语义相同的URL得到相同的结果。
+     */
+    static QString canonicalizeUrl(const QString& url);
 };
 
 /**
@@ -0,0 +1,210 @@
+#ifndef ENTITY_SCHEMA_H
+#define ENTITY_SCHEMA_H
+
+#include <array>
+#include <string_view>
+#include "../core/types.h"
+
+// =============================================================================
+// 实体复合字段表
+// =============================================================================
+// MusicBrainzParser按这些表为每种实体类型生成专用的解析函数（见
+// MusicBrainzParser::parseEntityFields），延迟解码器也按同一张表判断字段是否存在，
+// 新增字段或实体类型时只需要修改这里。
+
+/**
+ * @brief 复合字段的解析方式
+ */
+enum class FieldKind {
+    LifeSpan,               ///< 生命周期对象
+    Area,                   ///< 地区对象
+    ArtistCredit,           ///< 艺术家署名列表
+    ReleaseEvents,          ///< 发行事件列表
+    Media,                  ///< 媒体和曲目列表
+    CoverArtArchive,        ///< 封面艺术档案信息
+    TextRepresentation,     ///< 文本表示（语言、文字）
+    Tags,                   ///< 标签列表
+    Aliases,                ///< 别名列表
+    Relations,              ///< 关系列表
+    SubEntities             ///< 子实体列表（只保留基本字段）
+};
+
+/**
+ * @brief 复合字段描述
+ *
+ * jsonKey与detailKey相同时，整理后的结果替代原始值；
+ * 不同时原始值仍按通用方式保存在jsonKey下。
+ */
+struct FieldSpec {
+    std::string_view jsonKey;                           ///< JSON中的键名
+    std::string_view detailKey;                         ///< 整理结果在ResultItem中的键名
+    FieldKind kind;                                     ///< 解析方式
+    EntityType subEntityType = EntityType::Unknown;     ///< 子实体列表的元素类型
+};
+
+/**
+ * @brief 编译时实体字段表
+ *
+ * 没有特化的实体类型没有需要整理的复合字段，所有字段按通用方式转换。
+ */
+template <EntityType Type>
+struct EntitySchema {
+    static constexpr std::array<FieldSpec, 0> fields = {};
+};
+
+template <>
+struct EntitySchema<EntityType::Artist> {
+    static constexpr std::array<FieldSpec, 11> fields = {{
+        {"life-span", "life_span", FieldKind::LifeSpan},
+        {"area", "area_info", FieldKind::Area},
+        {"begin-area", "begin_area", FieldKind::Area},
+        {"end-area", "end_area", FieldKind::Area},
+        {"recordings", "recordings", FieldKind::SubEntities, EntityType::Recording},
+        {"releases", "releases", FieldKind::SubEntities, EntityType::Release},
+        {"release-groups", "release-groups", FieldKind::SubEntities, EntityType::ReleaseGroup},
+        {"works", "works", FieldKind::SubEntities, EntityType::Work},
+        {"tags", "tags", FieldKind::Tags},
+        {"aliases", "aliases", FieldKind::Aliases},
+        {"relations", "relationships", FieldKind::Relations}
+    }};
+};
+
+template <>
+struct EntitySchema<EntityType::Release> {
+    static constexpr std::array<FieldSpec, 8> fields = {{
+        {"artist-credit", "artist-credits", FieldKind::ArtistCredit},
+        {"release-events", "release-events", FieldKind::ReleaseEvents},
+        {"media", "media", FieldKind::Media},
+        {"cover-art-archive", "cover-art-archive", FieldKind::CoverArtArchive},
+        {"text-representation", "text-representation", FieldKind::TextRepresentation},
+        {"tags", "tags", FieldKind::Tags},
+        {"aliases", "aliases", FieldKind::Aliases},
+        {"relations", "relationships", FieldKind::Relations}
+    }};
+};
+
+template <>
+struct EntitySchema<EntityType::Recording> {
+    static constexpr std::array<FieldSpec, 8> fields = {{
+        {"artist-credit", "artist-credits", FieldKind::ArtistCredit},
+        {"recordings", "recordings", FieldKind::SubEntities, EntityType::Recording},
+        {"releases", "releases", FieldKind::SubEntities, EntityType::Release},
+        {"release-groups", "release-groups", FieldKind::SubEntities, EntityType::ReleaseGroup},
+        {"works", "works", FieldKind::SubEntities, EntityType::Work},
+        {"tags", "tags", FieldKind::Tags},
+        {"aliases", "aliases", FieldKind::Aliases},
+        {"relations", "relationships", FieldKind::Relations}
+    }};
+};
+
+template <>
+struct EntitySchema<EntityType::ReleaseGroup> {
+    static constexpr std::array<FieldSpec, 8> fields = {{
+        {"artist-credit", "artist-credits", FieldKind::ArtistCredit},
+        {"recordings", "recordings", FieldKind::SubEntities, EntityType::Recording},
+        {"releases", "releases", FieldKind::SubEntities, EntityType::Release},
+        {"release-groups", "release-groups", FieldKind::SubEntities, EntityType::ReleaseGroup},
+        {"works", "works", FieldKind::SubEntities, EntityType::Work},
+        {"tags", "tags", FieldKind::Tags},
+        {"aliases", "aliases", FieldKind::Aliases},
+        {"relations", "relationships", FieldKind::Relations}
+    }};
+};
+
+template <>
+struct EntitySchema<EntityType::Work> {
+    static constexpr std::array<FieldSpec, 7> fields = {{
+        {"recordings", "recordings", FieldKind::SubEntities, EntityType::Recording},
+        {"releases", "releases", FieldKind::SubEntities, EntityType::Release},
+        {"release-groups", "release-groups", FieldKind::SubEntities, EntityType::ReleaseGroup},
+        {"works", "works", FieldKind::SubEntities, EntityType::Work},
+        {"tags", "tags", FieldKind::Tags},
+        {"aliases", "aliases", FieldKind::Aliases},
+        {"relations", "relationships", FieldKind::Relations}
+    }};
+};
+
+template <>
+struct EntitySchema<EntityType::Label> {
+    static constexpr std::array<FieldSpec, 8> fields = {{
+        {"area", "area_info", FieldKind::Area},
+        {"recordings", "recordings", FieldKind::SubEntities, EntityType::Recording},
+        {"releases", "releases", FieldKind::SubEntities, EntityType::Release},
+        {"release-groups", "release-groups", FieldKind::SubEntities, EntityType::ReleaseGroup},
+        {"works", "works", FieldKind::SubEntities, EntityType::Work},
+        {"tags", "tags", FieldKind::Tags},
+        {"aliases", "aliases", FieldKind::Aliases},
+        {"relations", "relationships", FieldKind::Relations}
+    }};
+};
+
+template <>
+struct EntitySchema<EntityType::Area> {
+    static constexpr std::array<FieldSpec, 4> fields = {{
+        {"life-span", "life_span", FieldKind::LifeSpan},
+        {"tags", "tags", FieldKind::Tags},
+        {"aliases", "aliases", FieldKind::Aliases},
+        {"relations", "relationships", FieldKind::Relations}
+    }};
+};
+
+template <>
+struct EntitySchema<EntityType::Place> {
+    static constexpr std::array<FieldSpec, 5> fields = {{
+        {"life-span", "life_span", FieldKind::LifeSpan},
+        {"area", "area_info", FieldKind::Area},
+        {"tags", "tags", FieldKind::Tags},
+        {"aliases", "aliases", FieldKind::Aliases},
+        {"relations", "relationships", FieldKind::Relations}
+    }};
+};
+
+template <>
+struct EntitySchema<EntityType::Event> {
+    static constexpr std::array<FieldSpec, 4> fields = {{
+        {"life-span", "life_span", FieldKind::LifeSpan},
+        {"tags", "tags", FieldKind::Tags},
+        {"aliases", "aliases", FieldKind::Aliases},
+        {"relations", "relationships", FieldKind::Relations}
+    }};
+};
+
+template <>
+struct EntitySchema<EntityType::Instrument> {
+    static constexpr std::array<FieldSpec, 3> fields = {{
+        {"tags", "tags", FieldKind::Tags},
+        {"aliases", "aliases", FieldKind::Aliases},
+        {"relations", "relationships", FieldKind::Relations}
+    }};
+};
+
+template <>
+struct EntitySchema<EntityType::Series> {
+    static constexpr std::array<FieldSpec, 3> fields = {{
+        {"tags", "tags", FieldKind::Tags},
+        {"aliases", "aliases", FieldKind::Aliases},
+        {"relations", "relationships", FieldKind::Relations}
+    }};
+};
+
+/**
+ * @brief 在实体字段表中查找JSON键
+ * @return 字段描述；键不是该实体类型的复合字段时返回空指针
+ */
+template <EntityType Type>
+constexpr const FieldSpec *findFieldSpec(std::string_view jsonKey) noexcept
+{
+    for (const FieldSpec &spec : EntitySchema<Type>::fields) {
+        if (spec.jsonKey == jsonKey) {
+            return &spec;
+        }
+    }
+    return nullptr;
+}
+
+static_assert(findFieldSpec<EntityType::Artist>("life-span")->kind == FieldKind::LifeSpan,
+              "Artist schema must map life-span");
+static_assert(findFieldSpec<EntityType::Release>("life-span") == nullptr,
+              "Release schema has no life-span");
+
+#endif // ENTITY_SCHEMA_H
@@ -0,0 +1,569 @@
+#include "entity_store.h"
+#include "../models/resultitem.h"
+#include <QDir>
+#include <QMutexLocker>
+#include <QSaveFile>
+#include <QDebug>
+#include <algorithm>
+#include <vector>
+
+namespace {
+
+constexpr quint32 DATA_MAGIC = 0x5344424d;      // "MBDS"
+constexpr quint32 INDEX_MAGIC = 0x5849424d;     // "MBIX"
+constexpr quint32 RECORD_MAGIC = 0x5245424d;    // "MBER"
+constexpr quint32 STORE_VERSION = 1;
+
+/**
+ * @brief 数据文件头
+ */
+struct DataHeader {
+    quint32 magic;
+    quint32 version;
+    quint64 reserved;
+};
+
+/**
+ * @brief MBID → 起始槽位（UUID的各位近似随机，混合两半后取高位）
+ */
+quint32 homeSlot(const Mbid &mbid, quint32 capacity)
+{
+    const quint64 mixed = (mbid.high() ^ mbid.low()) * 0x9E3779B97F4A7C15ull;
+    return quint32(mixed >> 32) & (capacity - 1);
+}
+
+} // namespace
+
+/**
+ * @brief 数据文件中每条记录的记录头，后面紧跟payloadSize字节的CBOR负载
+ */
+struct EntityStore::RecordHeader {
+    quint32 magic;              ///< RECORD_MAGIC
+    quint32 payloadSize;        ///< 负载字节数
+    quint64 high;               ///< MBID前8字节
+    quint64 low;                ///< MBID后8字节
+    qint64 fetchedAt;           ///< 获取时间（自纪元起的秒数）
+    quint32 includeStamp;       ///< include参数的哈希
+    quint16 entityType;         ///< 实体类型
+    quint16 formatVersion;      ///< EntityPayload的格式版本
+};
+
+/**
+ * @brief 索引文件头，后面紧跟capacity个槽位
+ */
+struct EntityStore::IndexHeader {
+    quint32 magic;              ///< INDEX_MAGIC；重建中途为0
+    quint32 version;            ///< STORE_VERSION
+    quint32 capacity;           ///< 槽位数（2的幂）
+    quint32 count;              ///< 已用槽位数
+    qint64 dataSize;            ///< 已索引的数据文件长度
+    qint64 liveBytes;           ///< 被索引引用的记录字节数
+};
+
+/**
+ * @brief 索引槽位（与记录头的字段对应，新鲜度检查不需要读取数据文件）
+ */
+struct EntityStore::IndexSlot {
+    quint64 high;
+    quint64 low;
+    qint64 offset;              ///< 记录在数据文件中的偏移，0表示空槽位
+    qint64 fetchedAt;
+    quint32 recordSize;         ///< 记录头加负载的字节数
+    quint32 includeStamp;
+    quint16 entityType;
+    quint16 formatVersion;
+    quint32 reserved;
+};
+
+EntityStore::EntityStore()
+{
+    // 文件格式依赖这些结构的布局
+    static_assert(sizeof(DataHeader) == 16, "Unexpected data header layout");
+    static_assert(sizeof(RecordHeader) == 40, "Unexpected record header layout");
+    static_assert(sizeof(IndexHeader) == 32, "Unexpected index header layout");
+    static_assert(sizeof(IndexSlot) == 48, "Unexpected index slot layout");
+}
+
+EntityStore::~EntityStore()
+{
+    close();
+}
+
+// =============================================================================
+// 打开和关闭
+// =============================================================================
+
+bool EntityStore::open(const QString &directory)
+{
+    QMutexLocker locker(&m_mutex);
+    if (!openLocked(directory)) {
+        closeLocked();
+        return false;
+    }
+    return true;
+}
+
+void EntityStore::close()
+{
+    QMutexLocker locker(&m_mutex);
+    closeLocked();
+}
+
+bool EntityStore::isOpen() const
+{
+    QMutexLocker locker(&m_mutex);
+    return m_index != nullptr;
+}
+
+bool EntityStore::openLocked(const QString &directory)
+{
+    closeLocked();
+
+    if (!QDir().mkpath(directory)) {
+        qWarning() << "EntityStore: Cannot create directory" << directory;
+        return false;
+    }
+
+    m_dataFile.setFileName(directory + "/entities.dat");
+    if (!m_dataFile.open(QIODevice::ReadWrite)) {
+        qWarning() << "EntityStore: Cannot open" << m_dataFile.fileName() << m_dataFile.errorString();
+        return false;
+    }
+
+    // 数据文件头不符（新文件或旧版本）时重新开始
+    DataHeader dataHeader = {};
+    const bool dataValid = m_dataFile.read(reinterpret_cast<char *>(&dataHeader), sizeof(dataHeader)) == qint64(sizeof(dataHeader))
+        && dataHeader.magic == DATA_MAGIC && dataHeader.version == STORE_VERSION;
+    if (!dataValid) {
+        dataHeader = {DATA_MAGIC, STORE_VERSION, 0};
+        if (!m_dataFile.resize(0) || !m_dataFile.seek(0)
+            || m_dataFile.write(reinterpret_cast<const char *>(&dataHeader), sizeof(dataHeader)) != qint64(sizeof(dataHeader))
+            || !m_dataFile.flush()) {
+            qWarning() << "EntityStore: Cannot initialize" << m_dataFile.fileName();
+            return false;
+        }
+    }
+
+    m_indexFile.setFileName(directory + "/entities.idx");
+    if (!m_indexFile.open(QIODevice::ReadWrite)) {
+        qWarning() << "EntityStore: Cannot open" << m_indexFile.fileName() << m_indexFile.errorString();
+        return false;
+    }
+
+    bool indexValid = false;
+    if (dataValid && m_indexFile.size() >= qint64(sizeof(IndexHeader))) {
+        m_index = m_indexFile.map(0, m_indexFile.size());
+        if (m_index) {
+            const IndexHeader *header = indexHeader();
+            const quint32 capacity = header->capacity;
+            indexValid = header->magic == INDEX_MAGIC && header->version == STORE_VERSION
+                && capacity >= MIN_CAPACITY && (capacity & (capacity - 1)) == 0
+                && m_indexFile.size() == qint64(sizeof(IndexHeader)) + qint64(capacity) * qint64(sizeof(IndexSlot))
+                && qint64(header->count) * 2 <= capacity
+                && header->dataSize >= qint64(sizeof(DataHeader)) && header->dataSize <= m_dataFile.size();
+        }
+    }
+
+    if (!indexValid) {
+        qDebug() << "EntityStore: Rebuilding index for" << directory;
+        if (!rebuildIndex()) {
+            return false;
+        }
+    } else if (indexHeader()->dataSize < m_dataFile.size()) {
+        // 上次退出前追加的记录还没进入索引
+        if (!indexRecords(indexHeader()->dataSize)) {
+            return false;
+        }
+    }
+
+    m_directory = directory;
+
+    const IndexHeader *header = indexHeader();
+    if (header->dataSize > COMPACT_MIN_BYTES && header->liveBytes * 2 < header->dataSize) {
+        compactLocked();
+    }
+
+    qDebug() << "EntityStore: Opened" << directory << "with" << indexHeader()->count << "entities,"
+             << m_dataFile.size() << "bytes";
+    return m_index != nullptr;
+}
+
+void EntityStore::closeLocked()
+{
+    if (m_index) {
+        m_indexFile.unmap(m_index);
+        m_index = nullptr;
+    }
+    m_indexFile.close();
+    m_dataFile.close();
+    m_directory.clear();
+}
+
+// =============================================================================
+// 查找
+// =============================================================================
+
+EntityPayload EntityStore::find(const Mbid &mbid, EntityType type, const QString &includes, int maxAgeSeconds) const
+{
+    QMutexLocker locker(&m_mutex);
+
+    bool stale = false;
+    const IndexSlot *slot = findFresh(mbid, type, includes, maxAgeSeconds, &stale);
+    if (!slot) {
+        if (stale) {
+            m_stats.staleMisses++;
+        } else {
+            m_stats.misses++;
+        }
+        return EntityPayload();
+    }
+
+    const qint64 payloadSize = qint64(slot->recordSize) - qint64(sizeof(RecordHeader));
+    QByteArray bytes;
+    if (m_dataFile.seek(slot->offset + qint64(sizeof(RecordHeader)))) {
+        bytes = m_dataFile.read(payloadSize);
+    }
+
+    const EntityPayload payload = bytes.size() == payloadSize ? EntityPayload::fromCbor(bytes) : EntityPayload();
+    if (payload.isNull() || payload.mbid() != mbid) {
+        qWarning() << "EntityStore: Unreadable record for" << mbid << "at offset" << slot->offset;
+        m_stats.misses++;
+        return EntityPayload();
+    }
+
+    m_stats.hits++;
+    return payload;
+}
+
+bool EntityStore::contains(const Mbid &mbid, EntityType type, const QString &includes, int maxAgeSeconds) const
+{
+    QMutexLocker locker(&m_mutex);
+    bool stale = false;
+    return findFresh(mbid, type, includes, maxAgeSeconds, &stale) != nullptr;
+}
+
+const EntityStore::IndexSlot *EntityStore::findFresh(const Mbid &mbid, EntityType type, const QString &includes,
+                                                     int maxAgeSeconds, bool *stale) const
+{
+    *stale = false;
+    if (!m_index || mbid.isNull()) {
+        return nullptr;
+    }
+
+    const IndexSlot *slot = probe(mbid);
+    if (!slot || slot->offset == 0
+        || slot->entityType != quint16(type)
+        || slot->includeStamp != includeStamp(includes)
+        || slot->formatVersion != EntityPayload::FORMAT_VERSION) {
+        return nullptr;
+    }
+
+    if (maxAgeSeconds >= 0 && QDateTime::currentSecsSinceEpoch() - slot->fetchedAt > maxAgeSeconds) {
+        *stale = true;
+        return nullptr;
+    }
+    return slot;
+}
+
+EntityStore::IndexSlot *EntityStore::probe(const Mbid &mbid) const
+{
+    const quint32 capacity = indexHeader()->capacity;
+    IndexSlot *slots = indexSlots();
+
+    // 线性探测；负载因子不超过1/2，探测长度很短
+    quint32 index = homeSlot(mbid, capacity);
+    for (quint32 step = 0; step < capacity; ++step) {
+        IndexSlot *slot = slots + index;
+        if (slot->offset == 0 || (slot->high == mbid.high() && slot->low == mbid.low())) {
+            return slot;
+        }
+        index = (index + 1) & (capacity - 1);
+    }
+    return nullptr;
+}
+
+EntityStore::IndexHeader *EntityStore::indexHeader() const
+{
+    return reinterpret_cast<IndexHeader *>(m_index);
+}
+
+EntityStore::IndexSlot *EntityStore::indexSlots() const
+{
+    return reinterpret_cast<IndexSlot *>(m_index + sizeof(IndexHeader));
+}
+
+quint32 EntityStore::includeStamp(const QString &includes)
+{
+    // FNV-1a
+    quint32 hash = 2166136261u;
+    for (QChar c : includes) {
+        hash = (hash ^ c.unicode()) * 16777619u;
+    }
+    return hash;
+}
+
+// =============================================================================
+// 写入
+// =============================================================================
+
+bool EntityStore::insert(const EntityPayload &payload, const QString &includes, const QDateTime &fetchedAt)
+{
+    const Mbid mbid = payload.mbid();
+    if (payload.isNull() || mbid.isNull()) {
+        return false;
+    }
+
+    const QByteArray bytes = payload.toCbor();
+
+    RecordHeader record = {};
+    record.magic = RECORD_MAGIC;
+    record.payloadSize = quint32(bytes.size());
+    record.high = mbid.high();
+    record.low = mbid.low();
+    record.fetchedAt = fetchedAt.isValid() ? fetchedAt.toSecsSinceEpoch() : QDateTime::currentSecsSinceEpoch();
+    record.includeStamp = includeStamp(includes);
+    record.entityType = quint16(payload.type());
+    record.formatVersion = quint16(EntityPayload::FORMAT_VERSION);
+
+    QMutexLocker locker(&m_mutex);
+    if (!m_index) {
+        return false;
+    }
+
+    // 先追加数据再更新索引，中途失败时截掉写了一半的记录
+    const qint64 offset = m_dataFile.size();
+    if (!m_dataFile.seek(offset)
+        || m_dataFile.write(reinterpret_cast<const char *>(&record), sizeof(record)) != qint64(sizeof(record))
+        || m_dataFile.write(bytes) != bytes.size()
+        || !m_dataFile.flush()) {
+        qWarning() << "EntityStore: Failed to append record for" << mbid << m_dataFile.errorString();
+        m_dataFile.resize(offset);
+        return false;
+    }
+
+    if (!addToIndex(record, offset)) {
+        return false;
+    }
+    indexHeader()->dataSize = m_dataFile.size();
+    return true;
+}
+
+bool EntityStore::insert(const ResultItem &item, const QString &includes, const QDateTime &fetchedAt)
+{
+    return insert(EntityPayload::fromItem(item), includes, fetchedAt);
+}
+
+void EntityStore::clear()
+{
+    QMutexLocker locker(&m_mutex);
+    if (!m_index) {
+        return;
+    }
+
+    if (!m_dataFile.resize(qint64(sizeof(DataHeader))) || !createIndex(MIN_CAPACITY)) {
+        qWarning() << "EntityStore: Failed to clear" << m_directory;
+        closeLocked();
+        return;
+    }
+    indexHeader()->magic = INDEX_MAGIC;
+}
+
+bool EntityStore::compact()
+{
+    QMutexLocker locker(&m_mutex);
+    return m_index && compactLocked();
+}
+
+EntityStore::Stats EntityStore::stats() const
+{
+    QMutexLocker locker(&m_mutex);
+    Stats result = m_stats;
+    if (m_index) {
+        result.records = int(indexHeader()->count);
+        result.liveBytes = indexHeader()->liveBytes;
+        result.dataBytes = m_dataFile.size();
+    }
+    return result;
+}
+
+// =============================================================================
+// 索引维护
+// =============================================================================
+
+bool EntityStore::createIndex(quint32 capacity)
+{
+    if (m_index) {
+        m_indexFile.unmap(m_index);
+        m_index = nullptr;
+    }
+
+    // 先截断再扩展，新槽位全部为0（空）
+    const qint64 size = qint64(sizeof(IndexHeader)) + qint64(capacity) * qint64(sizeof(IndexSlot));
+    if (!m_indexFile.resize(0) || !m_indexFile.resize(size)) {
+        qWarning() << "EntityStore: Cannot resize index" << m_indexFile.errorString();
+        return false;
+    }
+    m_index = m_indexFile.map(0, size);
+    if (!m_index) {
+        qWarning() << "EntityStore: Cannot map index" << m_indexFile.errorString();
+        return false;
+    }
+
+    // 文件头有效之前中途退出，下次打开时会从数据文件重建
+    IndexHeader *header = indexHeader();
+    header->magic = 0;
+    header->version = STORE_VERSION;
+    header->capacity = capacity;
+    header->count = 0;
+    header->dataSize = qint64(sizeof(DataHeader));
+    header->liveBytes = 0;
+    return true;
+}
+
+bool EntityStore::rebuildIndex()
+{
+    if (!createIndex(MIN_CAPACITY)) {
+        return false;
+    }
+    // dataSize只随补录推进，此后的中途退出由下次打开时继续补录
+    indexHeader()->magic = INDEX_MAGIC;
+    return indexRecords(qint64(sizeof(DataHeader)));
+}
+
+bool EntityStore::indexRecords(qint64 from)
+{
+    const qint64 size = m_dataFile.size();
+    qint64 offset = from;
+    while (offset + qint64(sizeof(RecordHeader)) <= size) {
+        RecordHeader record;
+        if (!m_dataFile.seek(offset)
+            || m_dataFile.read(reinterpret_cast<char *>(&record), sizeof(record)) != qint64(sizeof(record))
+            || record.magic != RECORD_MAGIC
+            || qint64(record.payloadSize) > size - offset - qint64(sizeof(RecordHeader))) {
+            break;
+        }
+        if (!addToIndex(record, offset)) {
+            return false;
+        }
+        offset += qint64(sizeof(RecordHeader)) + record.payloadSize;
+    }
+
+    if (offset < size) {
+        qWarning() << "EntityStore: Discarding" << (size - offset) << "bytes of incomplete records";
+        m_dataFile.resize(offset);
+    }
+    indexHeader()->dataSize = offset;
+    return true;
+}
+
+bool EntityStore::addToIndex(const RecordHeader &record, qint64 offset)
+{
+    if ((qint64(indexHeader()->count) + 1) * 2 > indexHeader()->capacity && !growIndex()) {
+        return false;
+    }
+
+    IndexSlot *slot = probe(Mbid(record.high, record.low));
+    if (!slot) {
+        return false;
+    }
+
+    IndexHeader *header = indexHeader();
+    const quint32 recordSize = quint32(sizeof(RecordHeader)) + record.payloadSize;
+    if (slot->offset != 0) {
+        // 同一实体的旧记录成为垃圾
+        header->liveBytes -= slot->recordSize;
+    } else {
+        header->count++;
+    }
+
+    slot->high = record.high;
+    slot->low = record.low;
+    slot->offset = offset;
+    slot->fetchedAt = record.fetchedAt;
+    slot->recordSize = recordSize;
+    slot->includeStamp = record.includeStamp;
+    slot->entityType = record.entityType;
+    slot->formatVersion = record.formatVersion;
+    slot->reserved = 0;
+    header->liveBytes += recordSize;
+    return true;
+}
+
+bool EntityStore::growIndex()
+{
+    const IndexHeader old = *indexHeader();
+    std::vector<IndexSlot> live;
+    live.reserve(old.count);
+    const IndexSlot *slots = indexSlots();
+    for (quint32 i = 0; i < old.capacity; ++i) {
+        if (slots[i].offset != 0) {
+            live.push_back(slots[i]);
+        }
+    }
+
+    if (!createIndex(old.capacity * 2)) {
+        return false;
+    }
+
+    IndexHeader *header = indexHeader();
+    for (const IndexSlot &slot : live) {
+        *probe(Mbid(slot.high, slot.low)) = slot;
+    }
+    header->count = old.count;
+    header->liveBytes = old.liveBytes;
+    header->dataSize = old.dataSize;
+    header->magic = INDEX_MAGIC;
+    return true;
+}
+
+bool EntityStore::compactLocked()
+{
+    const IndexHeader *header = indexHeader();
+    std::vector<IndexSlot> live;
+    live.reserve(header->count);
+    const IndexSlot *slots = indexSlots();
+    for (quint32 i = 0; i < header->capacity; ++i) {
+        if (slots[i].offset != 0) {
+            live.push_back(slots[i]);
+        }
+    }
+    // 按原顺序写出，保持记录的相对位置
+    std::sort(live.begin(), live.end(), [](const IndexSlot &a, const IndexSlot &b) {
+        return a.offset < b.offset;
+    });
+
+    const qint64 before = m_dataFile.size();
+    QSaveFile output(m_dataFile.fileName());
+    if (!output.open(QIODevice::WriteOnly)) {
+        qWarning() << "EntityStore: Cannot compact" << output.errorString();
+        return false;
+    }
+
+    const DataHeader dataHeader = {DATA_MAGIC, STORE_VERSION, 0};
+    output.write(reinterpret_cast<const char *>(&dataHeader), sizeof(dataHeader));
+    for (const IndexSlot &slot : live) {
+        QByteArray record;
+        if (m_dataFile.seek(slot.offset)) {
+            record = m_dataFile.read(slot.recordSize);
+        }
+        if (record.size() != qint64(slot.recordSize)) {
+            qWarning() << "EntityStore: Cannot read record at offset" << slot.offset << "while compacting";
+            output.cancelWriting();
+            return false;
+        }
+        output.write(record);
+    }
+
+    // 替换文件前先关闭（Windows不能替换打开中的文件），再从新文件重建索引
+    const QString fileName = m_dataFile.fileName();
+    m_dataFile.close();
+    const bool committed = output.commit();
+    m_dataFile.setFileName(fileName);
+    if (!m_dataFile.open(QIODevice::ReadWrite) || !rebuildIndex()) {
+        closeLocked();
+        return false;
+    }
+
+    qDebug() << "EntityStore: Compacted" << before << "->" << m_dataFile.size() << "bytes";
+    return committed;
+}
@@ -0,0 +1,176 @@
+#ifndef ENTITY_STORE_H
+#define ENTITY_STORE_H
+
+#include <QDateTime>
+#include <QFile>
+#include <QMutex>
+#include <QString>
+#include "../core/types.h"
+#include "../core/mbid.h"
+#include "../models/entitypayload.h"
+
+class ResultItem;
+
+/**
+ * @class EntityStore
+ * @brief 按MBID索引的本地实体存储
+ *
+ * 保存解析完成的详情结果（EntityPayload），重启后再次查看同一实体时
+ * 不需要重新请求网络。存储目录中有两个文件：
+ *
+ * - entities.dat：只追加的数据文件。每条记录是定长的记录头（MBID、实体类型、
+ *   include集合标记、获取时间、格式版本）加上EntityPayload的CBOR编码。
+ *   同一实体更新时追加新记录，旧记录成为垃圾，打开时垃圾过多则压缩。
+ * - entities.idx：内存映射的开放寻址哈希表，MBID → 记录偏移。槽位中同时保存
+ *   类型、include标记和获取时间，新鲜度检查只访问映射内存，命中时读取一次数据文件。
+ *
+ * 先追加数据再更新索引，索引头记录已索引的数据长度：进程中途退出时，
+ * 下次打开会补录索引之后追加的完整记录，并截掉不完整的尾部；
+ * 索引文件损坏或缺失时从数据文件重建。两个文件都使用本机字节序，不跨机器共享。
+ *
+ * 所有接口都是线程安全的。
+ *
+ * **使用示例：**
+ * ```cpp
+ * EntityStore store;
+ * store.open(QStandardPaths::writableLocation(QStandardPaths::CacheLocation) + "/entities");
+ *
+ * const QString includes = EntityUtils::getDefaultIncludes(EntityType::Artist);
+ * store.insert(*detailedItem, includes);
+ *
+ * const EntityPayload cached = store.find(mbid, EntityType::Artist, includes, 7 * 24 * 3600);
+ * if (!cached.isNull()) {
+ *     // 无需网络请求
+ * }
+ * ```
+ */
+class EntityStore
+{
+public:
+    /**
+     * @struct Stats
+     * @brief 存储统计
+     */
+    struct Stats {
+        int records = 0;            ///< 索引中的实体数
+        qint64 dataBytes = 0;       ///< 数据文件大小
+        qint64 liveBytes = 0;       ///< 仍被索引引用的记录字节数
+        qint64 hits = 0;            ///< 命中次数
+        qint64 misses = 0;          ///< 未找到（或类型、include集合不符）的次数
+        qint64 staleMisses = 0;     ///< 找到但已超过新鲜期的次数
+    };
+
+    EntityStore();
+    ~EntityStore();
+
+    /**
+     * @brief 打开（必要时创建）存储目录
+     * @param directory 存储目录
+     * @return 是否成功；失败时存储保持关闭，所有查找都不命中
+     */
+    bool open(const QString &directory);
+
+    /**
+     * @brief 关闭存储
+     */
+    void close();
+
+    bool isOpen() const;
+
+    /**
+     * @brief 查找实体
+     * @param mbid 实体MBID
+     * @param type 实体类型
+     * @param includes 请求的include参数（与写入时不同则不命中）
+     * @param maxAgeSeconds 新鲜期（秒），负数表示不限
+     * @return 存储的详情；不存在、不符或已过期时返回空值
+     */
+    EntityPayload find(const Mbid &mbid, EntityType type, const QString &includes, int maxAgeSeconds) const;
+
+    /**
+     * @brief 是否有可用的副本（只检查索引，不读取数据文件）
+     * @see find()
+     */
+    bool contains(const Mbid &mbid, EntityType type, const QString &includes, int maxAgeSeconds) const;
+
+    /**
+     * @brief 保存实体详情
+     * @param payload 详情结果，必须带有MBID
+     * @param includes 获取该结果时使用的include参数
+     * @param fetchedAt 获取时间，默认为当前时间
+     * @return 是否写入成功
+     */
+    bool insert(const EntityPayload &payload, const QString &includes, const QDateTime &fetchedAt = QDateTime());
+
+    /**
+     * @brief 保存解析得到的结果项
+     * @see insert(const EntityPayload &, const QString &, const QDateTime &)
+     */
+    bool insert(const ResultItem &item, const QString &includes, const QDateTime &fetchedAt = QDateTime());
+
+    /**
+     * @brief 清空存储
+     */
+    void clear();
+
+    /**
+     * @brief 重写数据文件，丢弃已被覆盖的旧记录
+     * @return 是否成功
+     */
+    bool compact();
+
+    /**
+     * @brief 获取统计信息
+     */
+    Stats stats() const;
+
+private:
+    struct IndexHeader;
+    struct IndexSlot;
+    struct RecordHeader;
+
+    // 禁用拷贝和赋值操作符
+    EntityStore(const EntityStore&) = delete;
+    EntityStore& operator=(const EntityStore&) = delete;
+
+    static constexpr quint32 MIN_CAPACITY = 1024;               ///< 索引的最小槽位数
+    static constexpr qint64 COMPACT_MIN_BYTES = 4 * 1024 * 1024;  ///< 数据文件小于该大小时不压缩
+
+    /**
+     * @brief include参数的稳定哈希（写入文件，不能使用带随机种子的qHash）
+     */
+    static quint32 includeStamp(const QString &includes);
+
+    IndexHeader *indexHeader() const;
+    IndexSlot *indexSlots() const;
+
+    /**
+     * @brief 查找MBID所在的槽位或应插入的空槽位
+     */
+    IndexSlot *probe(const Mbid &mbid) const;
+
+    /**
+     * @brief 查找可用的槽位（调用方已持有锁）
+     * @param stale 返回槽位存在但已超过新鲜期
+     */
+    const IndexSlot *findFresh(const Mbid &mbid, EntityType type, const QString &includes,
+                               int maxAgeSeconds, bool *stale) const;
+
+    bool openLocked(const QString &directory);
+    void closeLocked();
+    bool createIndex(quint32 capacity);
+    bool rebuildIndex();
+    bool indexRecords(qint64 from);
+    bool addToIndex(const RecordHeader &record, qint64 offset);
+    bool growIndex();
+    bool compactLocked();
+
+    QString m_directory;            ///< 存储目录
+    mutable QFile m_dataFile;       ///< 数据文件（读写）
+    QFile m_indexFile;              ///< 索引文件（映射）
+    uchar *m_index = nullptr;       ///< 索引文件的映射地址
+    mutable QMutex m_mutex;         ///< 保护以下所有成员和文件位置
+    mutable Stats m_stats;          ///< 命中统计
+};
+
+#endif // ENTITY_STORE_H
@@ -0,0 +1,217 @@
+#include "json_stream_reader.h"
+#include <QJsonDocument>
+#include <QJsonArray>
+#include <QJsonParseError>
+
+namespace {
+bool isJsonWhitespace(char c)
+{
+    return c == ' ' || c == '\n' || c == '\r' || c == '\t';
+}
+}
+
+QList<JsonStreamReader::Event> JsonStreamReader::feed(const QByteArray &chunk)
+{
+    QList<Event> events;
+    if (m_state == State::Done || m_state == State::Error) {
+        return events;
+    }
+
+    m_buffer.append(chunk);
+
+    while (m_pos < m_buffer.size() && m_state != State::Error && m_state != State::Done) {
+        const char c = m_buffer.at(m_pos);
+
+        switch (m_state) {
+            case State::BeforeRoot:
+                if (c == '{') {
+                    m_state = State::ExpectKey;
+                } else if (!isJsonWhitespace(c)) {
+                    fail("Response is not a JSON object");
+                }
+                m_pos++;
+                break;
+
+            case State::ExpectKey:
+                if (c == '"') {
+                    m_tokenStart = m_pos;
+                    m_escape = false;
+                    m_state = State::InKey;
+                } else if (c == '}') {
+                    m_state = State::Done;
+                } else if (!isJsonWhitespace(c)) {
+                    fail("Expected member name");
+                }
+                m_pos++;
+                break;
+
+            case State::InKey:
+                if (m_escape) {
+                    m_escape = false;
+                } else if (c == '\\') {
+                    m_escape = true;
+                } else if (c == '"') {
+                    bool ok = false;
+                    m_currentKey = parseValue(m_buffer.mid(m_tokenStart, m_pos - m_tokenStart + 1), &ok).toString();
+                    m_tokenStart = -1;
+                    if (!ok) {
+                        fail("Invalid member name");
+                        break;
+                    }
+                    m_state = State::ExpectColon;
+                }
+                m_pos++;
+                break;
+
+            case State::ExpectColon:
+                if (c == ':') {
+                    m_state = State::ExpectValue;
+                } else if (!isJsonWhitespace(c)) {
+                    fail("Expected ':' after member name");
+                }
+                m_pos++;
+                break;
+
+            case State::ExpectValue:
+                if (c == '[') {
+                    Event event;
+                    event.kind = Event::Kind::ArrayBegin;
+                    event.key = m_currentKey;
+                    events.append(event);
+                    m_state = State::ExpectElement;
+                    m_pos++;
+                } else if (isJsonWhitespace(c)) {
+                    m_pos++;
+                } else {
+                    // 值的第一个字符由InValue处理
+                    m_tokenStart = m_pos;
+                    m_inElement = false;
+                    m_depth = 0;
+                    m_inString = false;
+                    m_escape = false;
+                    m_state = State::InValue;
+                }
+                break;
+
+            case State::ExpectElement:
+                if (c == ']') {
+                    m_state = State::AfterMember;
+                    m_pos++;
+                } else if (c == ',' || isJsonWhitespace(c)) {
+                    m_pos++;
+                } else {
+                    m_tokenStart = m_pos;
+                    m_inElement = true;
+                    m_depth = 0;
+                    m_inString = false;
+                    m_escape = false;
+                    m_state = State::InValue;
+                }
+                break;
+
+            case State::InValue:
+                if (m_inString) {
+                    if (m_escape) {
+                        m_escape = false;
+                    } else if (c == '\\') {
+                        m_escape = true;
+                    } else if (c == '"') {
+                        m_inString = false;
+                        if (m_depth == 0) {
+                            // 字符串标量在结束引号处完成
+                            finishValue(m_pos + 1, events);
+                            break;
+                        }
+                    }
+                    m_pos++;
+                    break;
+                }
+
+                if (c == '"') {
+                    m_inString = true;
+                } else if (c == '{' || c == '[') {
+                    m_depth++;
+                } else if (c == '}' || c == ']') {
+                    if (m_depth == 0) {
+                        // 数字等标量后直接跟着结束符，结束符留给外层状态
+                        finishValue(m_pos, events);
+                        break;
+                    }
+                    if (--m_depth == 0) {
+                        finishValue(m_pos + 1, events);
+                        break;
+                    }
+                } else if (m_depth == 0 && (c == ',' || isJsonWhitespace(c))) {
+                    finishValue(m_pos, events);
+                    break;
+                }
+                m_pos++;
+                break;
+
+            case State::AfterMember:
+                if (c == ',') {
+                    m_state = State::ExpectKey;
+                } else if (c == '}') {
+                    m_state = State::Done;
+                } else if (!isJsonWhitespace(c)) {
+                    fail("Expected ',' or '}' after member value");
+                }
+                m_pos++;
+                break;
+
+            case State::Done:
+            case State::Error:
+                break;
+        }
+    }
+
+    // 丢弃已经处理完的字节，只保留当前未完成的成员名或值
+    const int keep = m_tokenStart >= 0 ? m_tokenStart : m_pos;
+    if (keep > 0) {
+        m_buffer.remove(0, keep);
+        m_pos -= keep;
+        if (m_tokenStart >= 0) {
+            m_tokenStart -= keep;
+        }
+    }
+    if (m_state == State::Done) {
+        m_buffer.clear();
+        m_pos = 0;
+    }
+
+    return events;
+}
+
+void JsonStreamReader::finishValue(int end, QList<Event> &events)
+{
+    Event event;
+    event.kind = m_inElement ? Event::Kind::ArrayElement : Event::Kind::Member;
+    event.key = m_currentKey;
+    event.json = m_buffer.mid(m_tokenStart, end - m_tokenStart);
+    events.append(event);
+
+    m_tokenStart = -1;
+    m_pos = end;
+    m_state = m_inElement ? State::ExpectElement : State::AfterMember;
+}
+
+void JsonStreamReader::fail(const QString &message)
+{
+    m_state = State::Error;
+    m_error = message;
+    m_buffer.clear();
+    m_pos = 0;
+    m_tokenStart = -1;
+}
+
+QJsonValue JsonStreamReader::parseValue(const QByteArray &json, bool *ok)
+{
+    // QJsonDocument只接受对象或数组，标量包一层数组再取出
+    QJsonParseError error;
+    const QJsonDocument doc = QJsonDocument::fromJson("[" + json + "]", &error);
+    const bool valid = error.error == QJsonParseError::NoError && doc.isArray() && doc.array().size() == 1;
+    if (ok) {
+        *ok = valid;
+    }
+    return valid ? doc.array().first() : QJsonValue();
+}
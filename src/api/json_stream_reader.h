@@ -0,0 +1,109 @@
+#ifndef JSON_STREAM_READER_H
+#define JSON_STREAM_READER_H
+
+#include <QByteArray>
+#include <QString>
+#include <QList>
+#include <QJsonValue>
+
+/**
+ * @class JsonStreamReader
+ * @brief 增量式JSON切分器
+ *
+ * 按数据到达的顺序逐块输入响应体，把根对象拆成一个个小片段：
+ * - 根对象的数组成员：数组中的每个元素单独输出（例如搜索结果中的每个实体、
+ *   详情中的每条录音/发行/关系）
+ * - 根对象的其他成员：整个值作为一个片段输出
+ *
+ * 切分器只扫描字节、跟踪字符串和嵌套层级，不构建任何文档；
+ * 已输出的字节立即丢弃，因此缓冲区只保存当前尚未完整的片段。
+ * 每个片段再由调用方单独解析，峰值内存与单个实体成正比，而不是与整个响应成正比。
+ *
+ * 切分器假设输入是合法的JSON，只做必要的结构检查；
+ * 片段本身的语法错误在解析片段时发现。
+ */
+class JsonStreamReader
+{
+public:
+    /**
+     * @struct Event
+     * @brief 切分出的一个片段
+     */
+    struct Event {
+        enum class Kind {
+            Member,         ///< 根对象的非数组成员，json为完整的值
+            ArrayBegin,     ///< 根对象的数组成员开始，json为空
+            ArrayElement    ///< 根对象数组成员中的一个元素
+        };
+
+        Kind kind = Kind::Member;
+        QString key;        ///< 根对象中的成员名
+        QByteArray json;    ///< 值的原始JSON文本
+    };
+
+    JsonStreamReader() = default;
+
+    /**
+     * @brief 输入一块数据
+     * @param chunk 新到达的字节
+     * @return 本次输入后新完成的片段
+     */
+    QList<Event> feed(const QByteArray &chunk);
+
+    /**
+     * @brief 根对象是否已经完整结束
+     */
+    bool isFinished() const { return m_state == State::Done; }
+
+    /**
+     * @brief 是否遇到结构错误
+     */
+    bool hasError() const { return m_state == State::Error; }
+
+    /**
+     * @brief 错误信息
+     */
+    QString errorString() const { return m_error; }
+
+    /**
+     * @brief 当前缓冲的字节数（尚未完整的片段）
+     */
+    int bufferedBytes() const { return m_buffer.size(); }
+
+    /**
+     * @brief 把单个JSON值的文本解析为QJsonValue
+     * @param json 值的原始文本（对象、数组、字符串、数字、布尔或null）
+     * @param ok 输出是否解析成功（可选）
+     */
+    static QJsonValue parseValue(const QByteArray &json, bool *ok = nullptr);
+
+private:
+    enum class State {
+        BeforeRoot,     ///< 等待根对象的 {
+        ExpectKey,      ///< 等待成员名或 }
+        InKey,          ///< 正在读取成员名
+        ExpectColon,    ///< 等待 :
+        ExpectValue,    ///< 等待成员值
+        ExpectElement,  ///< 在根成员数组中，等待元素或 ]
+        InValue,        ///< 正在读取一个值（成员值或数组元素）
+        AfterMember,    ///< 等待 , 或 }
+        Done,           ///< 根对象已结束
+        Error           ///< 结构错误
+    };
+
+    void fail(const QString &message);
+    void finishValue(int end, QList<Event> &events);
+
+    QByteArray m_buffer;            ///< 尚未处理完的字节
+    int m_pos = 0;                  ///< 扫描位置（相对m_buffer）
+    int m_tokenStart = -1;          ///< 当前成员名或值的起始位置
+    State m_state = State::BeforeRoot;
+    QString m_currentKey;           ///< 当前根成员名
+    bool m_inElement = false;       ///< 当前值是否为数组元素
+    int m_depth = 0;                ///< 当前值内部的嵌套层级
+    bool m_inString = false;        ///< 是否在字符串内
+    bool m_escape = false;          ///< 上一个字符是否为转义符
+    QString m_error;
+};
+
+#endif // JSON_STREAM_READER_H
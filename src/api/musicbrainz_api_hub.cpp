@@ -0,0 +1,682 @@
+#include "musicbrainz_api_hub.h"
+#include "musicbrainzapi.h"
+#include "musicbrainzparser.h"
+#include "musicbrainz_response_handler.h"
+#include "../utils/config_manager.h"
+#include <QCoreApplication>
+#include <QMutex>
+#include <QMutexLocker>
+#include <QNetworkReply>
+#include <QThread>
+#include <QThreadPool>
+#include <QElapsedTimer>
+#include <QStandardPaths>
+#include <QDebug>
+
+MusicBrainzApiHub *MusicBrainzApiHub::instance()
+{
+    static QMutex mutex;
+    static QPointer<MusicBrainzApiHub> hub;
+
+    QMutexLocker locker(&mutex);
+    if (!hub) {
+        hub = new MusicBrainzApiHub();
+
+        // 中心对象始终属于主线程，随应用对象一起销毁
+        if (QCoreApplication *app = QCoreApplication::instance()) {
+            if (hub->thread() != app->thread()) {
+                hub->moveToThread(app->thread());
+            }
+            hub->setParent(app);
+        }
+    }
+    return hub;
+}
+
+MusicBrainzApiHub::MusicBrainzApiHub(QObject *parent)
+    : QObject(parent)
+    , m_networkManager(new NetworkManager(this))
+    , m_parser(new MusicBrainzParser(this))
+    , m_responseHandler(new MusicBrainzResponseHandler(m_parser, this))
+    , m_userAgent(ConfigManager::instance().network().userAgent)
+    , m_parsePool(new QThreadPool(this))
+    , m_nextTicket(0)
+{
+    loadParseConfig();
+    connect(&ConfigManager::instance(), &ConfigManager::apiConfigChanged,
+            this, &MusicBrainzApiHub::loadParseConfig);
+    loadStoreConfig();
+    connect(&ConfigManager::instance(), &ConfigManager::networkConfigChanged,
+            this, &MusicBrainzApiHub::loadStoreConfig);
+
+    connect(m_networkManager, &NetworkManager::requestFinished,
+            this, &MusicBrainzApiHub::onRequestFinished);
+    connect(m_networkManager, &NetworkManager::requestError,
+            this, &MusicBrainzApiHub::onRequestError);
+    connect(m_networkManager, &NetworkManager::requestDataAvailable,
+            this, &MusicBrainzApiHub::onRequestDataAvailable);
+    connect(m_networkManager, &NetworkManager::requestRetrying,
+            this, &MusicBrainzApiHub::onRequestRetrying);
+
+    qDebug() << "MusicBrainzApiHub initialized with" << m_parsePool->maxThreadCount() << "parse threads";
+}
+
+MusicBrainzApiHub::~MusicBrainzApiHub()
+{
+    // 工作线程使用解析器和响应处理器，必须在它们销毁前结束
+    m_parseQueue.clear();
+    m_parsePool->clear();
+    m_parsePool->waitForDone();
+}
+
+template<typename Func>
+void MusicBrainzApiHub::runOnHubThread(Func &&func)
+{
+    if (QThread::currentThread() == thread()) {
+        func();
+    } else {
+        QMetaObject::invokeMethod(this, std::forward<Func>(func), Qt::QueuedConnection);
+    }
+}
+
+// =============================================================================
+// 公共接口
+// =============================================================================
+
+RequestId MusicBrainzApiHub::submit(MusicBrainzApi *subscriber, const QString &url, RequestType type,
+                                    const QVariantMap &context, const QString &method, const QByteArray &data,
+                                    const QString &username, const QString &password, RequestPriority priority,
+                                    RequestId ticket)
+{
+    if (method != "GET" && method != "POST" && method != "PUT" && method != "DELETE") {
+        qCritical() << "MusicBrainzApiHub: Unsupported HTTP method:" << method;
+        return 0;
+    }
+
+    Subscriber entry;
+    entry.api = subscriber;
+    entry.context = context;
+    entry.ticket = ticket != 0 ? ticket : reserveTicket();
+
+    runOnHubThread([this, entry, url, type, method, data, username, password, priority]() {
+        enqueue(entry, url, type, method, data, username, password, priority);
+    });
+
+    return entry.ticket;
+}
+
+RequestId MusicBrainzApiHub::reserveTicket()
+{
+    return m_nextTicket.fetchAndAddRelaxed(1) + 1;
+}
+
+EntityPayload MusicBrainzApiHub::findStoredDetails(const Mbid &mbid, EntityType type, const QString &includes) const
+{
+    return m_entityStore.find(mbid, type, includes, m_entityStoreMaxAge.loadRelaxed());
+}
+
+bool MusicBrainzApiHub::hasStoredDetails(const Mbid &mbid, EntityType type, const QString &includes) const
+{
+    return m_entityStore.contains(mbid, type, includes, m_entityStoreMaxAge.loadRelaxed());
+}
+
+void MusicBrainzApiHub::loadStoredDetails(MusicBrainzApi *subscriber, RequestId ticket, const Mbid &mbid,
+                                          EntityType type, const QString &includes)
+{
+    QPointer<MusicBrainzApi> api = subscriber;
+    m_parsePool->start([this, api, ticket, mbid, type, includes]() {
+        const EntityPayload stored = findStoredDetails(mbid, type, includes);
+        if (!api) {
+            return;
+        }
+        QMetaObject::invokeMethod(api, [api, stored, type, ticket]() {
+            if (api) {
+                api->deliverStoredDetails(stored, type, ticket);
+            }
+        }, Qt::QueuedConnection);
+    });
+}
+
+void MusicBrainzApiHub::cancel(MusicBrainzApi *subscriber, RequestId ticket)
+{
+    if (ticket == 0) {
+        return;
+    }
+
+    runOnHubThread([this, subscriber, ticket]() {
+        auto it = m_ticketRequests.find(ticket);
+        if (it == m_ticketRequests.end()) {
+            return;
+        }
+        const quint64 requestId = it.value();
+        m_ticketRequests.erase(it);
+
+        removeSubscribers(requestId, [subscriber, ticket](const Subscriber &entry) {
+            return entry.ticket == ticket && entry.api.data() == subscriber;
+        });
+    });
+}
+
+void MusicBrainzApiHub::cancelAll(MusicBrainzApi *subscriber)
+{
+    // 调用方可能正在析构：跨线程转发到中心线程时QPointer已经清空，
+    // 因此同时移除所有已失效的调用方
+    runOnHubThread([this, subscriber]() {
+        const QList<quint64> requestIds = m_pendingRequests.keys();
+        for (quint64 requestId : requestIds) {
+            removeSubscribers(requestId, [subscriber](const Subscriber &entry) {
+                return entry.api.isNull() || entry.api.data() == subscriber;
+            });
+        }
+    });
+}
+
+void MusicBrainzApiHub::setUserAgent(const QString &userAgent)
+{
+    runOnHubThread([this, userAgent]() {
+        m_userAgent = userAgent;
+        qDebug() << "MusicBrainzApiHub: User-Agent set to:" << userAgent;
+    });
+}
+
+void MusicBrainzApiHub::setProxy(const QString &host, int port,
+                                 const QString &username, const QString &password)
+{
+    runOnHubThread([this, host, port, username, password]() {
+        m_networkManager->setProxy(host, port, username, password);
+    });
+}
+
+MusicBrainzApiHub::Metrics MusicBrainzApiHub::metrics() const
+{
+    Metrics metrics = m_metrics;
+    metrics.inFlightCount = m_pendingRequests.size();
+    metrics.parseQueueDepth = m_parseQueue.size() + m_activeParseJobs;
+    metrics.parseQueuedBytes = m_parseQueuedBytes;
+    metrics.scheduler = m_networkManager->schedulerMetrics();
+    return metrics;
+}
+
+// =============================================================================
+// 请求调度与合并
+// =============================================================================
+
+void MusicBrainzApiHub::enqueue(const Subscriber &subscriber, const QString &url, RequestType type,
+                                const QString &method, const QByteArray &data,
+                                const QString &username, const QString &password, RequestPriority priority)
+{
+    m_metrics.submittedCount++;
+
+    // 只有GET请求可以合并；认证请求的键中带上用户名，避免不同账户共享响应
+    QString coalesceKey;
+    if (method == "GET") {
+        coalesceKey = UrlBuilder::canonicalizeUrl(url);
+        if (!username.isEmpty()) {
+            coalesceKey += "|" + username;
+        }
+
+        auto inFlight = m_inFlightRequests.constFind(coalesceKey);
+        if (inFlight != m_inFlightRequests.constEnd()) {
+            auto pending = m_pendingRequests.find(inFlight.value());
+            if (pending != m_pendingRequests.end()) {
+                qDebug() << "MusicBrainzApiHub: Coalescing request with in-flight request" << inFlight.value() << "-" << url;
+                pending->subscribers.append(subscriber);
+                m_ticketRequests.insert(subscriber.ticket, inFlight.value());
+                m_metrics.coalescedCount++;
+                return;
+            }
+        }
+    }
+
+    qDebug() << "MusicBrainzApiHub: Sending request -" << url;
+
+    quint64 requestId;
+    if (!username.isEmpty()) {
+        requestId = m_networkManager->sendAuthenticatedRequest(url, m_userAgent, username, password, method, data, priority);
+    } else {
+        // 查询、浏览类响应可以缓存；搜索结果变化快，始终走网络
+        const bool useCache = method == "GET" && type != RequestType::Search
+                              && type != RequestType::Collection;
+        requestId = m_networkManager->sendRequest(url, m_userAgent, priority, useCache);
+    }
+
+    if (requestId == 0) {
+        notifyError(subscriber, QString("Failed to send %1 request").arg(method), 0);
+        return;
+    }
+
+    m_metrics.networkRequestCount++;
+
+    PendingRequest pending;
+    pending.type = type;
+    pending.coalesceKey = coalesceKey;
+    pending.subscribers.append(subscriber);
+    m_pendingRequests.insert(requestId, pending);
+    m_ticketRequests.insert(subscriber.ticket, requestId);
+
+    if (!coalesceKey.isEmpty()) {
+        m_inFlightRequests.insert(coalesceKey, requestId);
+    }
+}
+
+void MusicBrainzApiHub::onRequestFinished(QNetworkReply *reply, const QString &url, quint64 requestId)
+{
+    reply->deleteLater();
+
+    auto it = m_pendingRequests.find(requestId);
+    if (it == m_pendingRequests.end()) {
+        qWarning() << "MusicBrainzApiHub: Unknown request finished:" << url;
+        return;
+    }
+
+    const int httpCode = reply->attribute(QNetworkRequest::HttpStatusCodeAttribute).toInt();
+
+    // 检查HTTP错误
+    if (reply->error() != QNetworkReply::NoError) {
+        const PendingRequest pending = it.value();
+        m_pendingRequests.erase(it);
+        if (!pending.coalesceKey.isEmpty()) {
+            m_inFlightRequests.remove(pending.coalesceKey);
+        }
+        releaseTickets(pending);
+
+        const QString errorMessage = reply->errorString();
+        qCritical() << "HTTP Error" << httpCode << ":" << errorMessage;
+        for (const Subscriber &subscriber : pending.subscribers) {
+            notifyError(subscriber, errorMessage, httpCode);
+        }
+        return;
+    }
+
+    // 所有调用方都已销毁，不再解析
+    bool hasSubscriber = false;
+    for (const Subscriber &subscriber : it->subscribers) {
+        if (subscriber.api) {
+            hasSubscriber = true;
+            break;
+        }
+    }
+    if (!hasSubscriber) {
+        const PendingRequest pending = it.value();
+        m_pendingRequests.erase(it);
+        if (!pending.coalesceKey.isEmpty()) {
+            m_inFlightRequests.remove(pending.coalesceKey);
+        }
+        releaseTickets(pending);
+        return;
+    }
+
+    QVariantMap parseContext = parseContextFor(it.value());
+    if (it->type == RequestType::Collection) {
+        // 对于集合操作，需要传递HTTP状态码
+        parseContext["httpStatusCode"] = httpCode;
+    }
+
+    // 解析期间请求仍留在在途表中：相同的新请求可以继续合并，取消也照常生效
+    it->parsing = true;
+
+    ParseJob job;
+    job.requestId = requestId;
+    job.type = it->type;
+    job.data = reply->readAll();
+    job.context = parseContext;
+    job.httpCode = httpCode;
+    // 已经开始流式解析的响应，剩余数据作为最后一块
+    job.stream = it->stream;
+    job.lastChunk = true;
+    job.generation = it->generation;
+    enqueueParse(job);
+}
+
+void MusicBrainzApiHub::onRequestDataAvailable(QNetworkReply *reply, quint64 requestId)
+{
+    auto it = m_pendingRequests.find(requestId);
+    if (it == m_pendingRequests.end()) {
+        return;
+    }
+
+    // 只流式解析成功的响应；错误响应留给onRequestFinished整体处理
+    const int httpCode = reply->attribute(QNetworkRequest::HttpStatusCodeAttribute).toInt();
+    if (httpCode < 200 || httpCode >= 300) {
+        return;
+    }
+
+    if (!it->stream) {
+        it->stream = m_responseHandler->createStreamingState(it->type, parseContextFor(it.value()));
+        if (!it->stream) {
+            // 不支持流式解析的请求类型，数据留在回复中，完成后整体解析
+            return;
+        }
+    }
+
+    ParseJob job;
+    job.requestId = requestId;
+    job.type = it->type;
+    job.data = reply->readAll();
+    job.httpCode = httpCode;
+    job.stream = it->stream;
+    job.lastChunk = false;
+    job.generation = it->generation;
+    if (!job.data.isEmpty()) {
+        enqueueParse(job);
+    }
+}
+
+void MusicBrainzApiHub::onRequestRetrying(quint64 requestId, int attempt, int delayMs)
+{
+    Q_UNUSED(attempt)
+    Q_UNUSED(delayMs)
+
+    // 失败的回复可能已经输入了一部分数据，重试时从头开始新的流式解析；
+    // 旧回复还在排队或正在解析的数据块的结果一律作废
+    auto it = m_pendingRequests.find(requestId);
+    if (it != m_pendingRequests.end()) {
+        it->stream.reset();
+        it->generation++;
+    }
+}
+
+QVariantMap MusicBrainzApiHub::parseContextFor(const PendingRequest &pending) const
+{
+    // 解析上下文取第一个仍然存在的调用方的（合并的请求URL相同，上下文等价）
+    for (const Subscriber &subscriber : pending.subscribers) {
+        if (subscriber.api) {
+            return subscriber.context;
+        }
+    }
+    return pending.subscribers.isEmpty() ? QVariantMap() : pending.subscribers.first().context;
+}
+
+void MusicBrainzApiHub::onRequestError(const QString &error, const QString &url, quint64 requestId)
+{
+    const PendingRequest pending = m_pendingRequests.take(requestId);
+    if (!pending.coalesceKey.isEmpty()) {
+        m_inFlightRequests.remove(pending.coalesceKey);
+    }
+    releaseTickets(pending);
+
+    qCritical() << "MusicBrainzApiHub network error:" << error << "for URL:" << url;
+
+    for (const Subscriber &subscriber : pending.subscribers) {
+        notifyError(subscriber, error, 0);
+    }
+}
+
+void MusicBrainzApiHub::removeSubscribers(quint64 requestId,
+                                          const std::function<bool(const Subscriber &)> &match)
+{
+    auto it = m_pendingRequests.find(requestId);
+    if (it == m_pendingRequests.end()) {
+        return;
+    }
+
+    QList<Subscriber> &subscribers = it->subscribers;
+    for (int i = subscribers.size() - 1; i >= 0; --i) {
+        if (match(subscribers.at(i))) {
+            m_ticketRequests.remove(subscribers.at(i).ticket);
+            subscribers.removeAt(i);
+            m_metrics.cancelledCount++;
+        }
+    }
+
+    if (!subscribers.isEmpty()) {
+        return;
+    }
+
+    // 没有人再等待这个响应：出队或中止网络请求，不再占用速率配额和解析时间
+    if (!it->coalesceKey.isEmpty()) {
+        m_inFlightRequests.remove(it->coalesceKey);
+    }
+    const bool parsing = it->parsing;
+    m_pendingRequests.erase(it);
+    if (!parsing) {
+        m_networkManager->cancelRequest(requestId);
+    }
+    m_metrics.abortedCount++;
+
+    qDebug() << "MusicBrainzApiHub: Cancelled network request" << requestId;
+}
+
+void MusicBrainzApiHub::releaseTickets(const PendingRequest &pending)
+{
+    for (const Subscriber &subscriber : pending.subscribers) {
+        m_ticketRequests.remove(subscriber.ticket);
+    }
+}
+
+// =============================================================================
+// 响应解析
+// =============================================================================
+
+void MusicBrainzApiHub::loadStoreConfig()
+{
+    const auto &networkConfig = ConfigManager::instance().network();
+    m_entityStoreMaxAge.storeRelaxed(networkConfig.entityStoreMaxAgeSeconds);
+
+    if (!networkConfig.entityStoreEnabled) {
+        m_entityStore.close();
+        return;
+    }
+    if (m_entityStore.isOpen()) {
+        return;
+    }
+
+    const QString cacheDir = QStandardPaths::writableLocation(QStandardPaths::CacheLocation);
+    if (cacheDir.isEmpty()) {
+        qWarning() << "MusicBrainzApiHub: No writable cache location, entity store disabled";
+        return;
+    }
+    m_entityStore.open(cacheDir + "/entities");
+}
+
+int MusicBrainzApiHub::parseThreadCount(int configured)
+{
+    if (configured > 0) {
+        return configured;
+    }
+    // 默认留一个核心给GUI线程
+    return qBound(1, QThread::idealThreadCount() - 1, 4);
+}
+
+void MusicBrainzApiHub::loadParseConfig()
+{
+    const auto &apiConfig = ConfigManager::instance().api();
+    m_parsePool->setMaxThreadCount(parseThreadCount(apiConfig.parseThreads));
+    m_parseQueueLimit = qint64(qMax(1, apiConfig.parseQueueLimitMb)) * 1024 * 1024;
+
+    startParseJobs();
+    updateParseBackpressure();
+}
+
+void MusicBrainzApiHub::enqueueParse(const ParseJob &job)
+{
+    m_parseQueue.enqueue(job);
+    m_parseQueuedBytes += job.data.size();
+
+    updateParseBackpressure();
+    startParseJobs();
+}
+
+void MusicBrainzApiHub::startParseJobs()
+{
+    // 只把线程数以内的任务交给线程池，其余留在自己的队列里，
+    // 这样取消的请求在开始解析前就能被跳过
+    int index = 0;
+    while (m_activeParseJobs < m_parsePool->maxThreadCount() && index < m_parseQueue.size()) {
+        // 同一个流式请求的数据块必须依次解析，前一块还在解析时跳过
+        const ParseJob &candidate = m_parseQueue.at(index);
+        if (candidate.stream && m_busyStreams.contains(candidate.requestId)) {
+            index++;
+            continue;
+        }
+
+        const ParseJob job = m_parseQueue.takeAt(index);
+
+        const auto pending = m_pendingRequests.constFind(job.requestId);
+        if (pending == m_pendingRequests.constEnd() || pending->generation != job.generation) {
+            // 解析前已被取消，或者属于重试前的旧回复
+            m_parseQueuedBytes -= job.data.size();
+            continue;
+        }
+
+        m_activeParseJobs++;
+        if (job.stream) {
+            m_busyStreams.insert(job.requestId);
+        }
+
+        MusicBrainzResponseHandler *handler = m_responseHandler;
+        m_parsePool->start([this, handler, job]() {
+            QElapsedTimer timer;
+            timer.start();
+            const ParsedResponse response = job.stream
+                ? handler->feedStreaming(job.stream.data(), job.data, job.lastChunk)
+                : handler->handleResponse(job.type, job.data, job.context);
+            const qint64 elapsedMs = timer.elapsed();
+
+            // 完整的详情结果写入本地实体存储（存储未打开时直接返回）
+            if (response.type == RequestType::Details && response.success && !response.partial
+                && !response.entity.isNull()) {
+                m_entityStore.insert(response.entity, job.context.value("includes").toString());
+            }
+
+            const quint64 requestId = job.requestId;
+            const qint64 bytes = job.data.size();
+            const int httpCode = job.httpCode;
+            const bool lastChunk = job.lastChunk;
+            const quint32 generation = job.generation;
+            QMetaObject::invokeMethod(this, [this, requestId, bytes, response, httpCode, elapsedMs, lastChunk, generation]() {
+                onParseFinished(requestId, bytes, response, httpCode, elapsedMs, lastChunk, generation);
+            }, Qt::QueuedConnection);
+        });
+    }
+
+    updateParseBackpressure();
+}
+
+void MusicBrainzApiHub::onParseFinished(quint64 requestId, qint64 bytes, const ParsedResponse &response,
+                                        int httpCode, qint64 elapsedMs, bool lastChunk, quint32 generation)
+{
+    m_activeParseJobs--;
+    m_busyStreams.remove(requestId);
+    m_parseQueuedBytes -= bytes;
+    m_metrics.totalParseMs += elapsedMs;
+    m_metrics.maxParseMs = qMax(m_metrics.maxParseMs, elapsedMs);
+
+    // 重试前的旧回复解析出的结果（包括中间结果、解析错误）已经作废，请求继续等待新回复
+    auto it = m_pendingRequests.find(requestId);
+    if (it != m_pendingRequests.end() && it->generation == generation) {
+        if (response.partial) {
+            // 流式解析的中间结果：先交付已解析的实体，请求继续在途
+            if (!response.items.isEmpty()) {
+                deliverResponse(it.value(), response, httpCode);
+            }
+        } else {
+            PendingRequest pending = it.value();
+            m_pendingRequests.erase(it);
+            if (!pending.coalesceKey.isEmpty()) {
+                m_inFlightRequests.remove(pending.coalesceKey);
+            }
+            releaseTickets(pending);
+            m_metrics.parsedCount++;
+
+            // 数据还没下载完就解析失败，不再需要剩余的数据
+            if (!lastChunk) {
+                m_networkManager->cancelRequest(requestId);
+            }
+
+            deliverResponse(pending, response, httpCode);
+        }
+    }
+
+    startParseJobs();
+}
+
+void MusicBrainzApiHub::updateParseBackpressure()
+{
+    // 滞回：超过上限时暂停，降到一半以下才恢复，避免频繁切换
+    if (m_parseQueuedBytes > m_parseQueueLimit) {
+        m_networkManager->setDispatchPaused(true);
+    } else if (m_parseQueuedBytes <= m_parseQueueLimit / 2) {
+        m_networkManager->setDispatchPaused(false);
+    }
+}
+
+void MusicBrainzApiHub::deliverResponse(PendingRequest &pending, const ParsedResponse &response, int httpCode)
+{
+    // 原条目交给与中心同线程的第一个调用方，流式结果的各部分都交给同一个调用方
+    if (pending.itemOwner == 0) {
+        for (const Subscriber &subscriber : pending.subscribers) {
+            if (subscriber.api && subscriber.api->thread() == thread()) {
+                pending.itemOwner = subscriber.ticket;
+                break;
+            }
+        }
+    }
+
+    // 投递前先为所有调用方准备好结果：同线程的调用方收到结果后可能立即修改条目，
+    // 也可能取消或提交请求（pending随之失效）
+    QList<QPair<Subscriber, ParsedResponse>> deliveries;
+    for (Subscriber &subscriber : pending.subscribers) {
+        if (!subscriber.api) {
+            continue;
+        }
+
+        ParsedResponse copy = response;
+        if (subscriber.ticket != pending.itemOwner) {
+            for (QSharedPointer<ResultItem> &item : copy.items) {
+                if (!item) {
+                    continue;
+                }
+                QSharedPointer<ResultItem> &detached = subscriber.itemCopies[item.data()];
+                if (!detached) {
+                    detached = item->clone();
+                }
+                item = detached;
+            }
+        }
+        deliveries.append(qMakePair(subscriber, copy));
+    }
+
+    if (deliveries.size() > 1) {
+        qDebug() << "MusicBrainzApiHub: Delivering coalesced response to" << deliveries.size() << "subscribers";
+    }
+
+    for (const auto &delivery : deliveries) {
+        QPointer<MusicBrainzApi> api = delivery.first.api;
+        const ParsedResponse result = delivery.second;
+        const QVariantMap context = delivery.first.context;
+        const RequestId ticket = delivery.first.ticket;
+
+        if (!api) {
+            continue;
+        }
+        if (api->thread() == thread()) {
+            api->deliverResponse(result, context, ticket, httpCode);
+        } else {
+            QMetaObject::invokeMethod(api, [api, result, context, ticket, httpCode]() {
+                if (api) {
+                    api->deliverResponse(result, context, ticket, httpCode);
+                }
+            }, Qt::QueuedConnection);
+        }
+    }
+}
+
+void MusicBrainzApiHub::notifyError(const Subscriber &subscriber, const QString &error, int httpCode)
+{
+    QPointer<MusicBrainzApi> api = subscriber.api;
+    if (!api) {
+        return;
+    }
+
+    const RequestId ticket = subscriber.ticket;
+    if (api->thread() == thread()) {
+        api->deliverError(error, ticket, httpCode);
+    } else {
+        QMetaObject::invokeMethod(api, [api, error, ticket, httpCode]() {
+            if (api) {
+                api->deliverError(error, ticket, httpCode);
+            }
+        }, Qt::QueuedConnection);
+    }
+}
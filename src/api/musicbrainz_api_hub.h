@@ -0,0 +1,295 @@
+#ifndef MUSICBRAINZ_API_HUB_H
+#define MUSICBRAINZ_API_HUB_H
+
+#include <QObject>
+#include <QHash>
+#include <QList>
+#include <QPointer>
+#include <QVariantMap>
+#include <QAtomicInteger>
+#include <QQueue>
+#include <QSet>
+#include <QSharedPointer>
+#include <functional>
+#include "api_utils.h"
+#include "network_manager.h"
+#include "entity_store.h"
+
+class MusicBrainzApi;
+class MusicBrainzParser;
+class MusicBrainzResponseHandler;
+class ResultItem;
+class QNetworkReply;
+class QThreadPool;
+struct ParsedResponse;
+struct StreamingParseState;
+
+/**
+ * @class MusicBrainzApiHub
+ * @brief 进程内共享的MusicBrainz API请求中心
+ *
+ * 所有MusicBrainzApi实例都只是轻量的外观对象，实际的网络请求、
+ * 速率限制、请求合并和响应解析都由唯一的MusicBrainzApiHub完成：
+ * - 一个NetworkManager（一个连接池、一个令牌桶、一组优先级队列）
+ * - 一个解析器和响应处理器，在有界的工作线程池上解析响应
+ * - 全局的在途请求表，不同服务对同一URL的请求只发送一次
+ *
+ * **线程模型：**
+ * 中心对象属于主线程。instance()、submit()、setUserAgent()、setProxy()
+ * 可以在任意线程调用，跨线程调用会被转发到中心所在线程执行；
+ * 结果通过排队调用投递回各个MusicBrainzApi所在的线程。
+ * metrics()和networkManager()只能在中心所在线程使用。
+ *
+ * **响应解析：**
+ * 响应体读出后交给解析线程池（线程数由ApiConfig::parseThreads决定），
+ * JSON解析和ResultItem构建都不在GUI线程上进行，完成的结果再回到中心线程分发。
+ * 等待解析的响应体总量超过ApiConfig::parseQueueLimitMb时暂停发送新请求，
+ * 降到一半以下再恢复，因此内存占用有上限。
+ * 搜索和浏览请求在数据到达时就开始流式解析：同一请求的数据块按顺序
+ * 依次交给解析线程，已解析的实体以partial结果提前交付；详情响应下载完成后整体解析。
+ *
+ * **结果分发：**
+ * 合并请求的解析结果只解析一次，但条目是可变的（延迟解码、补充详情），
+ * 因此只有与中心同线程的第一个调用方直接接收解析出的条目，其他调用方各自收到深拷贝。
+ * 流式结果的后续部分和最终结果复用同一份副本，调用方看到的条目保持不变。
+ *
+ * **取消：**
+ * 取消只会移除对应的调用方；合并请求的最后一个调用方被取消时，
+ * 网络请求本身才会从调度队列移除或中止，响应也不再解析。
+ *
+ * **本地实体存储：**
+ * 启用NetworkConfig::entityStoreEnabled时，解析完成的详情结果在解析线程上写入
+ * EntityStore，MusicBrainzApi::getDetails在新鲜期内直接从存储返回，不经过网络。
+ * 读取数据文件和解码同样在解析线程上进行，调用方所在线程只检查索引。
+ */
+class MusicBrainzApiHub : public QObject
+{
+    Q_OBJECT
+
+public:
+    /**
+     * @struct Metrics
+     * @brief 请求中心统计信息
+     */
+    struct Metrics {
+        qint64 submittedCount = 0;      ///< 提交的请求总数
+        qint64 coalescedCount = 0;      ///< 合并到在途请求的请求数
+        qint64 networkRequestCount = 0; ///< 实际发出的网络请求数
+        qint64 cancelledCount = 0;      ///< 被调用方取消的请求数
+        qint64 abortedCount = 0;        ///< 因无人等待而取消的网络请求数
+        int inFlightCount = 0;          ///< 当前等待响应的网络请求数
+        int parseQueueDepth = 0;        ///< 等待或正在解析的响应数
+        qint64 parseQueuedBytes = 0;    ///< 等待或正在解析的响应体总字节数
+        qint64 parsedCount = 0;         ///< 累计解析的响应数
+        qint64 totalParseMs = 0;        ///< 累计解析耗时（毫秒，工作线程上）
+        qint64 maxParseMs = 0;          ///< 单个响应的最长解析耗时（毫秒）
+        NetworkManager::SchedulerMetrics scheduler;  ///< 调度器统计
+    };
+
+    /**
+     * @brief 获取共享实例
+     *
+     * 首次调用时创建，挂在QCoreApplication下，随应用退出销毁。
+     */
+    static MusicBrainzApiHub *instance();
+
+    ~MusicBrainzApiHub() override;
+
+    /**
+     * @brief 提交请求
+     * @param subscriber 接收结果的API外观对象
+     * @param url 请求URL
+     * @param type 请求类型
+     * @param context 请求上下文
+     * @param method HTTP方法
+     * @param data 请求体
+     * @param username 认证用户名，为空表示匿名请求
+     * @param password 认证密码
+     * @param priority 请求优先级
+     * @param ticket 已经用reserveTicket()分配的请求ID，为0时分配新的请求ID
+     * @return 请求ID（非0），结果投递时原样带回；不支持的HTTP方法返回0
+     */
+    RequestId submit(MusicBrainzApi *subscriber, const QString &url, RequestType type,
+                     const QVariantMap &context, const QString &method, const QByteArray &data,
+                     const QString &username, const QString &password, RequestPriority priority,
+                     RequestId ticket = 0);
+
+    /**
+     * @brief 分配一个请求ID
+     *
+     * 用于不经过网络、由调用方直接投递的结果（如本地实体存储命中），
+     * 保证与submit返回的请求ID不重复。
+     */
+    RequestId reserveTicket();
+
+    /**
+     * @brief 在本地实体存储中查找新鲜的详情结果
+     * @param mbid 实体MBID
+     * @param type 实体类型
+     * @param includes 请求的include参数
+     * @return 存储的结果；存储未启用、没有副本或已过期时返回空值
+     *
+     * 可以在任意线程调用。
+     */
+    EntityPayload findStoredDetails(const Mbid &mbid, EntityType type, const QString &includes) const;
+
+    /**
+     * @brief 本地实体存储中是否有新鲜的详情结果（不读取数据文件）
+     * @see findStoredDetails()
+     */
+    bool hasStoredDetails(const Mbid &mbid, EntityType type, const QString &includes) const;
+
+    /**
+     * @brief 在解析线程池中读取本地实体存储中的详情结果
+     * @param subscriber 接收结果的API外观对象
+     * @param ticket 请求ID（由reserveTicket()分配）
+     * @param mbid 实体MBID
+     * @param type 实体类型
+     * @param includes 请求的include参数
+     *
+     * 读取数据文件和解码不占用调用方线程，结果总是排队投递给subscriber；
+     * 副本在读取前被淘汰或已过期时投递空值，由调用方改走网络。
+     */
+    void loadStoredDetails(MusicBrainzApi *subscriber, RequestId ticket, const Mbid &mbid,
+                           EntityType type, const QString &includes);
+
+    /**
+     * @brief 获取本地实体存储
+     */
+    EntityStore *entityStore() { return &m_entityStore; }
+
+    /**
+     * @brief 取消请求
+     * @param subscriber 发起请求的API外观对象
+     * @param ticket submit返回的请求ID
+     *
+     * 取消后该调用方不会再收到结果或错误。
+     */
+    void cancel(MusicBrainzApi *subscriber, RequestId ticket);
+
+    /**
+     * @brief 取消某个调用方的所有请求
+     * @param subscriber API外观对象（可以是正在析构的对象）
+     */
+    void cancelAll(MusicBrainzApi *subscriber);
+
+    /**
+     * @brief 设置全局User-Agent
+     */
+    void setUserAgent(const QString &userAgent);
+
+    /**
+     * @brief 设置全局代理服务器
+     */
+    void setProxy(const QString &host, int port,
+                  const QString &username = QString(),
+                  const QString &password = QString());
+
+    /**
+     * @brief 获取统计信息
+     */
+    Metrics metrics() const;
+
+    /**
+     * @brief 获取共享的网络管理器
+     */
+    NetworkManager *networkManager() const { return m_networkManager; }
+
+    /**
+     * @brief 计算解析线程数
+     * @param configured ApiConfig::parseThreads，<=0表示自动
+     * @return 配置的线程数；自动时为核心数减一（给GUI线程留一个核心），限制在1到4之间
+     */
+    static int parseThreadCount(int configured);
+
+private slots:
+    void onRequestFinished(QNetworkReply *reply, const QString &url, quint64 requestId);
+    void onRequestError(const QString &error, const QString &url, quint64 requestId);
+    void onRequestDataAvailable(QNetworkReply *reply, quint64 requestId);
+    void onRequestRetrying(quint64 requestId, int attempt, int delayMs);
+
+private:
+    explicit MusicBrainzApiHub(QObject *parent = nullptr);
+
+    /**
+     * @struct Subscriber
+     * @brief 等待某个网络请求结果的调用方
+     */
+    struct Subscriber {
+        QPointer<MusicBrainzApi> api;   ///< 接收结果的外观对象
+        QVariantMap context;            ///< 调用方的请求上下文
+        RequestId ticket = 0;           ///< submit返回的请求ID
+        QHash<const ResultItem *, QSharedPointer<ResultItem>> itemCopies;  ///< 交给该调用方的条目副本（原条目 -> 副本）
+    };
+
+    /**
+     * @struct PendingRequest
+     * @brief 已提交到调度队列、等待响应的网络请求
+     */
+    struct PendingRequest {
+        RequestType type = RequestType::Generic;
+        QString coalesceKey;            ///< 合并键（规范化URL），不可合并的请求为空
+        QList<Subscriber> subscribers;  ///< 等待该响应的所有调用方
+        bool parsing = false;           ///< 响应已收到，正在等待解析
+        RequestId itemOwner = 0;        ///< 直接接收解析出的原条目的调用方，0表示尚未交付
+        QSharedPointer<StreamingParseState> stream;  ///< 流式解析状态，未开始流式解析时为空
+        quint32 generation = 0;         ///< 回复的代数，每次重试递增，旧回复的解析结果据此丢弃
+    };
+
+    /**
+     * @struct ParseJob
+     * @brief 等待解析线程处理的响应
+     */
+    struct ParseJob {
+        quint64 requestId = 0;          ///< 网络请求ID
+        RequestType type = RequestType::Generic;
+        QByteArray data;                ///< 原始响应体
+        QVariantMap context;            ///< 解析上下文
+        int httpCode = 0;               ///< HTTP状态码
+        QSharedPointer<StreamingParseState> stream;  ///< 流式解析状态，整体解析时为空
+        bool lastChunk = true;          ///< 是否为该响应的最后一块数据
+        quint32 generation = 0;         ///< 数据所属回复的代数（见PendingRequest::generation）
+    };
+
+    void enqueue(const Subscriber &subscriber, const QString &url, RequestType type,
+                 const QString &method, const QByteArray &data,
+                 const QString &username, const QString &password, RequestPriority priority);
+    void enqueueParse(const ParseJob &job);
+    void startParseJobs();
+    void onParseFinished(quint64 requestId, qint64 bytes, const ParsedResponse &response,
+                         int httpCode, qint64 elapsedMs, bool lastChunk, quint32 generation);
+    QVariantMap parseContextFor(const PendingRequest &pending) const;
+    void deliverResponse(PendingRequest &pending, const ParsedResponse &response, int httpCode);
+    void updateParseBackpressure();
+    void loadParseConfig();
+    void loadStoreConfig();
+    void notifyError(const Subscriber &subscriber, const QString &error, int httpCode);
+    void removeSubscribers(quint64 requestId, const std::function<bool(const Subscriber &)> &match);
+    void releaseTickets(const PendingRequest &pending);
+
+    template<typename Func>
+    void runOnHubThread(Func &&func);
+
+    NetworkManager *m_networkManager;
+    MusicBrainzParser *m_parser;
+    MusicBrainzResponseHandler *m_responseHandler;
+    QString m_userAgent;
+
+    // 解析线程池（解析器和响应处理器无状态，可以在多个工作线程上同时使用）
+    QThreadPool *m_parsePool;
+    QQueue<ParseJob> m_parseQueue;                      ///< 等待空闲解析线程的响应
+    int m_activeParseJobs = 0;                          ///< 正在解析的响应数
+    QSet<quint64> m_busyStreams;                        ///< 正在解析数据块的流式请求（同一请求的数据块依次解析）
+    qint64 m_parseQueuedBytes = 0;                      ///< 等待或正在解析的响应体总字节数
+    qint64 m_parseQueueLimit = 32 * 1024 * 1024;        ///< 触发背压的字节数上限
+
+    QHash<quint64, PendingRequest> m_pendingRequests;   ///< 网络请求ID -> 等待中的请求
+    QHash<QString, quint64> m_inFlightRequests;         ///< 合并键 -> 在途网络请求ID
+    QHash<RequestId, quint64> m_ticketRequests;         ///< 请求ID -> 网络请求ID
+    QAtomicInteger<quint64> m_nextTicket;               ///< 已分配的最大请求ID
+    EntityStore m_entityStore;                          ///< 本地实体存储（线程安全，解析线程直接写入）
+    QAtomicInt m_entityStoreMaxAge;                     ///< 本地实体存储的新鲜期（秒）
+    Metrics m_metrics;
+};
+
+#endif // MUSICBRAINZ_API_HUB_H
@@ -1,7 +1,7 @@
 /**
  * @file musicbrainz_response_handler.cpp
  * @brief MusicBrainz API响应处理器实现
- * 
+ *
  * 该文件实现了MusicBrainzResponseHandler类，负责处理来自MusicBrainz API的各种响应。
  * 主要功能包括：
  * - 解析搜索结果响应
@@ -10,7 +10,7 @@
  * - 处理通用API查询响应
  * - 处理浏览功能响应
  * - 处理用户集合相关操作响应
- * 
+ *
  * @author MusicBrainzQt Team
  * @date 2024
  */
@@ -30,141 +30,291 @@ MusicBrainzResponseHandler::MusicBrainzResponseHandler(MusicBrainzParser *parser
 {
 }
 
-void MusicBrainzResponseHandler::handleSearchResponse(const QByteArray& data, const QVariantMap& context)
+ParsedResponse MusicBrainzResponseHandler::handleResponse(RequestType type, const QByteArray& data, const QVariantMap& context)
+{
+    switch (type) {
+        case RequestType::Search:
+            return handleSearchResponse(data, context);
+        case RequestType::Details:
+            return handleDetailsResponse(data, context);
+        case RequestType::DiscId:
+            return handleDiscIdResponse(data, context);
+        case RequestType::Generic:
+            return handleGenericResponse(data, context);
+        case RequestType::Browse:
+            return handleBrowseResponse(data, context);
+        case RequestType::Collection:
+            return handleCollectionResponse(data, context);
+    }
+
+    return makeError(type, "Unknown request type");
+}
+
+ParsedResponse MusicBrainzResponseHandler::makeError(RequestType type, const QString &message)
+{
+    ParsedResponse response;
+    response.type = type;
+    response.success = false;
+    response.errorMessage = message;
+    return response;
+}
+
+ParsedResponse MusicBrainzResponseHandler::handleSearchResponse(const QByteArray& data, const QVariantMap& context)
 {
     EntityType entityType = static_cast<EntityType>(context.value("entityType").toInt());
-    
+
+    // 响应体只解析一次，验证、错误检查、分页和实体解析共用同一个文档
     QString error;
-    QJsonObject obj = ResponseParser::parseJsonResponse(data, &error);
-    if (!error.isEmpty()) {
-        emit errorOccurred("Failed to parse search response: " + error);
-        return;
+    QJsonObject obj;
+    if (!MusicBrainzParser::parseRootObject(data, &obj, &error)) {
+        return makeError(RequestType::Search, "Failed to parse search response: " + error);
     }
-    
-    QList<QSharedPointer<ResultItem>> results = m_parser->parseSearchResponse(data, entityType);
+
+    ParsedResponse response;
+    response.type = RequestType::Search;
+    response.entityType = entityType;
+    // 列表中的大部分行不会被打开，复合字段延迟到首次访问时解码
+    response.items = m_parser->parseSearchResponse(obj, entityType, true);
     auto pagination = ResponseParser::extractPagination(obj);
-    
-    qDebug() << "Search completed -" << results.size() << "results, total:" << pagination.first << "offset:" << pagination.second;
-    
-    emit searchResultsReady(results, pagination.first, pagination.second);
+    response.totalCount = pagination.first;
+    response.offset = pagination.second;
+
+    qDebug() << "Search completed -" << response.items.size() << "results, total:" << pagination.first << "offset:" << pagination.second;
+
+    return response;
 }
 
-void MusicBrainzResponseHandler::handleDetailsResponse(const QByteArray& data, const QVariantMap& context)
+ParsedResponse MusicBrainzResponseHandler::handleDetailsResponse(const QByteArray& data, const QVariantMap& context)
 {
     EntityType entityType = static_cast<EntityType>(context.value("entityType").toInt());
-    
-    auto detailedItem = m_parser->parseDetailsResponse(data, entityType);
-    
-    QVariantMap details;
+
+    QString error;
+    QJsonObject obj;
+    if (!MusicBrainzParser::parseRootObject(data, &obj, &error)) {
+        return makeError(RequestType::Details, "Failed to parse details response: " + error);
+    }
+
+    return buildDetailsResponse(obj, entityType);
+}
+
+ParsedResponse MusicBrainzResponseHandler::buildDetailsResponse(const QJsonObject &root, EntityType entityType)
+{
+    auto detailedItem = m_parser->parseDetailsResponse(root, entityType);
+
+    ParsedResponse response;
+    response.type = RequestType::Details;
+    response.entityType = entityType;
+
     if (detailedItem) {
-        details["id"] = detailedItem->getId();
-        details["name"] = detailedItem->getName();
-        details["type"] = EntityUtils::entityTypeToString(detailedItem->getType());
-        details["disambiguation"] = detailedItem->getDisambiguation();
-        
-        const QVariantMap &detailData = detailedItem->getDetailData();
-        for (auto it = detailData.constBegin(); it != detailData.constEnd(); ++it) {
-            details[it.key()] = it.value();
-        }
+        response.entity = EntityPayload::fromItem(*detailedItem);
     }
-    
-    emit detailsReady(details, entityType);
+
+    return response;
 }
 
-void MusicBrainzResponseHandler::handleDiscIdResponse(const QByteArray& data, const QVariantMap& context)
+ParsedResponse MusicBrainzResponseHandler::handleDiscIdResponse(const QByteArray& data, const QVariantMap& context)
 {
-    QString discId = context.value("discId").toString();
-    
+    Q_UNUSED(context)
+
     QString error;
     QJsonObject obj = ResponseParser::parseJsonResponse(data, &error);
     if (!error.isEmpty()) {
-        emit errorOccurred("Failed to parse DiscID response: " + error);
-        return;
+        return makeError(RequestType::DiscId, "Failed to parse DiscID response: " + error);
     }
-    
-    QList<QSharedPointer<ResultItem>> releases;
-    if (obj.contains("disc") && obj["disc"].toObject().contains("release-list")) {        
+
+    ParsedResponse response;
+    response.type = RequestType::DiscId;
+    response.entityType = EntityType::Release;
+
+    if (obj.contains("disc") && obj["disc"].toObject().contains("release-list")) {
         QJsonArray releaseArray = obj["disc"].toObject()["release-list"].toArray();
         for (const QJsonValue &value : releaseArray) {
-            auto release = m_parser->parseEntity(value.toObject(), EntityType::Release);
+            auto release = m_parser->parseEntity(value.toObject(), EntityType::Release, true);
             if (release) {
-                releases.append(release);
+                response.items.append(release);
             }
         }
     }
-    
-    emit discIdLookupReady(releases, discId);
+
+    return response;
 }
 
-void MusicBrainzResponseHandler::handleGenericResponse(const QByteArray& data, const QVariantMap& context)
+ParsedResponse MusicBrainzResponseHandler::handleGenericResponse(const QByteArray& data, const QVariantMap& context)
 {
-    QString entity = context.value("entity").toString();
-    QString id = context.value("id").toString();
-    
+    Q_UNUSED(context)
+
     QString error;
     QJsonObject obj = ResponseParser::parseJsonResponse(data, &error);
     if (!error.isEmpty()) {
-        emit errorOccurred("Failed to parse generic response: " + error);
-        return;
+        return makeError(RequestType::Generic, "Failed to parse generic response: " + error);
     }
-    
-    QVariantMap result = obj.toVariantMap();
-    emit genericQueryReady(result, entity, id);
+
+    ParsedResponse response;
+    response.type = RequestType::Generic;
+    response.data = obj.toVariantMap();
+    return response;
 }
 
-void MusicBrainzResponseHandler::handleBrowseResponse(const QByteArray& data, const QVariantMap& context)
+ParsedResponse MusicBrainzResponseHandler::handleBrowseResponse(const QByteArray& data, const QVariantMap& context)
 {
     QString entity = context.value("entity").toString();
-    
+
     QString error;
-    QJsonObject obj = ResponseParser::parseJsonResponse(data, &error);
-    if (!error.isEmpty()) {
-        emit errorOccurred("Failed to parse browse response: " + error);
-        return;
+    QJsonObject obj;
+    if (!MusicBrainzParser::parseRootObject(data, &obj, &error)) {
+        return makeError(RequestType::Browse, "Failed to parse browse response: " + error);
     }
-    
-    EntityType entityType = EntityUtils::stringToEntityType(entity);
-    QList<QSharedPointer<ResultItem>> results = m_parser->parseSearchResponse(data, entityType);
+
+    ParsedResponse response;
+    response.type = RequestType::Browse;
+    response.entityType = EntityUtils::stringToEntityType(entity);
+    response.items = m_parser->parseSearchResponse(obj, response.entityType, true);
     auto pagination = ResponseParser::extractPagination(obj);
-    
-    emit browseResultsReady(results, entity, pagination.first, pagination.second);
+    response.totalCount = pagination.first;
+    response.offset = pagination.second;
+
+    return response;
+}
+
+// =============================================================================
+// 流式解析
+// =============================================================================
+
+QSharedPointer<StreamingParseState> MusicBrainzResponseHandler::createStreamingState(RequestType type, const QVariantMap& context) const
+{
+    // 详情响应只有一个实体，逐个成员拼装并不能降低峰值内存（拼装出的JSON对象和
+    // 转换出的详细数据会同时存在），因此只有列表响应流式解析
+    EntityType entityType = EntityType::Unknown;
+    switch (type) {
+        case RequestType::Search:
+            entityType = static_cast<EntityType>(context.value("entityType").toInt());
+            break;
+        case RequestType::Browse:
+            entityType = EntityUtils::stringToEntityType(context.value("entity").toString());
+            break;
+        default:
+            return {};
+    }
+
+    // 需要知道实体数组的成员名，类型未知时退回整体解析
+    if (entityType == EntityType::Unknown) {
+        return {};
+    }
+
+    auto state = QSharedPointer<StreamingParseState>::create();
+    state->type = type;
+    state->entityType = entityType;
+    state->result.type = type;
+    state->result.entityType = entityType;
+    state->listKey = EntityUtils::getEntityPluralName(entityType);
+    return state;
 }
 
-void MusicBrainzResponseHandler::handleCollectionResponse(const QByteArray& data, const QVariantMap& context)
+ParsedResponse MusicBrainzResponseHandler::feedStreaming(StreamingParseState *state, const QByteArray& chunk, bool finished)
+{
+    state->bytesReceived += chunk.size();
+    const QList<JsonStreamReader::Event> events = state->reader.feed(chunk);
+
+    ParsedResponse partial;
+    partial.type = state->type;
+    partial.entityType = state->entityType;
+    partial.partial = true;
+
+    for (const JsonStreamReader::Event &event : events) {
+        // 列表：每个实体单独解析，其他数组（如搜索结果外的附加数据）忽略
+        if (event.kind == JsonStreamReader::Event::Kind::ArrayElement) {
+            if (event.key != state->listKey) {
+                continue;
+            }
+            QJsonParseError parseError;
+            const QJsonDocument entityDoc = QJsonDocument::fromJson(event.json, &parseError);
+            if (parseError.error != QJsonParseError::NoError) {
+                return makeError(state->type, "Failed to parse response: " + parseError.errorString());
+            }
+            if (!entityDoc.isObject()) {
+                return makeError(state->type, "Failed to parse response: entity is not an object");
+            }
+            auto item = m_parser->parseEntity(entityDoc.object(), state->entityType, true);
+            if (item) {
+                partial.items.append(item);
+            }
+        } else if (event.kind == JsonStreamReader::Event::Kind::Member) {
+            if (event.key != "count" && event.key != "offset" && event.key != "error") {
+                continue;
+            }
+            bool ok = false;
+            const QJsonValue value = JsonStreamReader::parseValue(event.json, &ok);
+            if (!ok) {
+                return makeError(state->type, "Failed to parse response: invalid value for " + event.key);
+            }
+            if (event.key == "count") {
+                state->result.totalCount = value.toInt();
+            } else if (event.key == "offset") {
+                state->result.offset = value.toInt();
+            } else {
+                state->result.success = false;
+                state->result.errorMessage = value.toString();
+            }
+        }
+    }
+
+    state->result.items.append(partial.items);
+    partial.totalCount = state->result.totalCount;
+    partial.offset = state->result.offset;
+
+    if (state->reader.hasError()) {
+        return makeError(state->type, "Failed to parse response: " + state->reader.errorString());
+    }
+
+    if (!finished) {
+        return partial;
+    }
+
+    if (!state->reader.isFinished()) {
+        return makeError(state->type, "Failed to parse response: unexpected end of data");
+    }
+
+    qDebug() << "Streaming parse completed -" << state->result.items.size() << "results from"
+             << state->bytesReceived << "bytes, total:" << state->result.totalCount;
+    return state->result;
+}
+
+ParsedResponse MusicBrainzResponseHandler::handleCollectionResponse(const QByteArray& data, const QVariantMap& context)
 {
     QString operation = context.value("operation").toString();
-    QString collectionId = context.value("collectionId").toString();
-    
+
+    ParsedResponse response;
+    response.type = RequestType::Collection;
+
+    if (operation == "add" || operation == "remove") {
+        // 集合修改操作
+        int httpStatusCode = context.value("httpStatusCode", 0).toInt();
+        response.operationSucceeded = (httpStatusCode >= 200 && httpStatusCode < 300);
+        return response;
+    }
+
     QString error;
     QJsonObject obj = ResponseParser::parseJsonResponse(data, &error);
     if (!error.isEmpty()) {
-        emit errorOccurred("Failed to parse collection response: " + error);
-        return;
+        return makeError(RequestType::Collection, "Failed to parse collection response: " + error);
     }
-    
+
     if (operation == "list") {
         // 用户集合列表
-        QList<QVariantMap> collections = ResponseParser::parseCollectionList(obj);
-        emit userCollectionsReady(collections);
+        response.collections = ResponseParser::parseCollectionList(obj);
     }
     else if (operation == "contents") {
         // 集合内容
-        QList<QSharedPointer<ResultItem>> contents;
         if (obj.contains("release-list")) {
-            QJsonArray releaseArray = obj["release-list"].toArray();            
+            QJsonArray releaseArray = obj["release-list"].toArray();
             for (const QJsonValue &value : releaseArray) {
-                auto release = m_parser->parseEntity(value.toObject(), EntityType::Release);
+                auto release = m_parser->parseEntity(value.toObject(), EntityType::Release, true);
                 if (release) {
-                    contents.append(release);
+                    response.items.append(release);
                 }
             }
         }
-        emit collectionContentsReady(contents, collectionId);
-    }
-    else if (operation == "add" || operation == "remove") {
-        // 集合修改操作
-        int httpStatusCode = context.value("httpStatusCode", 0).toInt();
-        bool success = (httpStatusCode >= 200 && httpStatusCode < 300);
-        emit collectionModified(success, collectionId, operation);
     }
+
+    return response;
 }
@@ -5,16 +5,58 @@
 #include <QVariantMap>
 #include <QList>
 #include <QSharedPointer>
+#include <QJsonObject>
 #include "../core/types.h"
+#include "../models/entitypayload.h"
+#include "api_utils.h"
+#include "json_stream_reader.h"
 
 class ResultItem;
 class MusicBrainzParser;
 class QNetworkReply;
 
+/**
+ * @struct ParsedResponse
+ * @brief 一次API响应的解析结果
+ *
+ * 响应只解析一次，结果再分发给所有等待同一请求的调用方。
+ * 不同请求类型只使用其中的一部分字段。
+ */
+struct ParsedResponse {
+    RequestType type = RequestType::Generic;        ///< 请求类型
+    bool success = true;                            ///< 是否解析成功
+    QString errorMessage;                           ///< 解析失败时的错误信息
+    EntityType entityType = EntityType::Unknown;    ///< 实体类型（搜索、详情）
+    QList<QSharedPointer<ResultItem>> items;        ///< 实体列表（搜索、浏览、DiscID、集合内容）
+    EntityPayload entity;                           ///< 详情结果（解析线程上编码，共享传递）
+    QVariantMap data;                               ///< 通用查询结果
+    QList<QVariantMap> collections;                 ///< 用户集合列表
+    int totalCount = 0;                             ///< 总结果数
+    int offset = 0;                                 ///< 结果偏移量
+    bool operationSucceeded = false;                ///< 集合修改是否成功
+    bool partial = false;                           ///< 流式解析的中间结果，items只包含新到达的部分
+};
+
+/**
+ * @struct StreamingParseState
+ * @brief 一个响应的流式解析状态
+ *
+ * 由MusicBrainzResponseHandler::createStreamingState创建。
+ * 同一时刻只能被一个线程使用，调用方按数据到达的顺序依次调用feedStreaming。
+ */
+struct StreamingParseState {
+    RequestType type = RequestType::Generic;        ///< 请求类型
+    EntityType entityType = EntityType::Unknown;    ///< 实体类型
+    QString listKey;                                ///< 列表响应中实体数组的成员名
+    JsonStreamReader reader;                        ///< 增量切分器
+    ParsedResponse result;                          ///< 已解析的全部实体和分页信息
+    qint64 bytesReceived = 0;                       ///< 已输入的字节数
+};
+
 /**
  * @class MusicBrainzResponseHandler
  * @brief MusicBrainz API响应处理器
- * 
+ *
  * 负责处理从MusicBrainz API收到的各种响应，包括：
  * - 搜索结果解析
  * - 详情信息解析
@@ -22,6 +64,15 @@ class QNetworkReply;
  * - 通用查询响应
  * - 浏览结果
  * - 集合操作响应
+ *
+ * 处理器只负责把原始数据解析为ParsedResponse，
+ * 由MusicBrainzApi把结果分发给各个调用方。
+ *
+ * 搜索和浏览响应还支持流式解析：响应体边下载边用JsonStreamReader切分，
+ * 每个实体单独解析，不需要在内存中同时保留整个响应体、整个JSON文档和完整的QVariant副本；
+ * 已解析的实体可以在下载完成前先行交付。详情响应只有一个实体，整体解析。
+ *
+ * 处理器没有可变状态，可以在多个线程上同时使用。
  */
 class MusicBrainzResponseHandler : public QObject
 {
@@ -35,116 +86,85 @@ public:
      */
     explicit MusicBrainzResponseHandler(MusicBrainzParser *parser, QObject *parent = nullptr);
 
+    /**
+     * @brief 按请求类型解析响应
+     * @param type 请求类型
+     * @param data API返回的原始数据
+     * @param context 请求上下文信息
+     * @return 解析结果
+     */
+    ParsedResponse handleResponse(RequestType type, const QByteArray& data, const QVariantMap& context);
+
     /**
      * @brief 处理搜索响应
      * @param data API返回的原始数据
      * @param context 请求上下文信息，包含entityType等
      */
-    void handleSearchResponse(const QByteArray& data, const QVariantMap& context);
-    
+    ParsedResponse handleSearchResponse(const QByteArray& data, const QVariantMap& context);
+
     /**
      * @brief 处理详情响应
      * @param data API返回的原始数据
      * @param context 请求上下文信息，包含entityType等
      */
-    void handleDetailsResponse(const QByteArray& data, const QVariantMap& context);
-    
+    ParsedResponse handleDetailsResponse(const QByteArray& data, const QVariantMap& context);
+
     /**
      * @brief 处理DiscID查找响应
      * @param data API返回的原始数据
      * @param context 请求上下文信息，包含discId等
      */
-    void handleDiscIdResponse(const QByteArray& data, const QVariantMap& context);
-    
+    ParsedResponse handleDiscIdResponse(const QByteArray& data, const QVariantMap& context);
+
     /**
      * @brief 处理通用查询响应
      * @param data API返回的原始数据
      * @param context 请求上下文信息，包含entity、id等
      */
-    void handleGenericResponse(const QByteArray& data, const QVariantMap& context);
-    
+    ParsedResponse handleGenericResponse(const QByteArray& data, const QVariantMap& context);
+
     /**
      * @brief 处理浏览响应
      * @param data API返回的原始数据
      * @param context 请求上下文信息，包含entity等
      */
-    void handleBrowseResponse(const QByteArray& data, const QVariantMap& context);
-    
+    ParsedResponse handleBrowseResponse(const QByteArray& data, const QVariantMap& context);
+
     /**
      * @brief 处理集合操作响应
      * @param data API返回的原始数据
      * @param context 请求上下文信息，包含operation、collectionId等
      */
-    void handleCollectionResponse(const QByteArray& data, const QVariantMap& context);
+    ParsedResponse handleCollectionResponse(const QByteArray& data, const QVariantMap& context);
 
-signals:
-    /**
-     * @brief 搜索结果准备就绪信号
-     * @param results 搜索结果列表
-     * @param totalCount 总结果数
-     * @param offset 偏移量
-     */
-    void searchResultsReady(const QList<QSharedPointer<ResultItem>>& results, int totalCount, int offset);
-    
-    /**
-     * @brief 详情信息准备就绪信号
-     * @param details 详情信息映射
-     * @param entityType 实体类型
-     */
-    void detailsReady(const QVariantMap& details, EntityType entityType);
-    
-    /**
-     * @brief DiscID查找结果准备就绪信号
-     * @param releases 发行版列表
-     * @param discId 光盘ID
-     */
-    void discIdLookupReady(const QList<QSharedPointer<ResultItem>>& releases, const QString& discId);
-    
-    /**
-     * @brief 通用查询结果准备就绪信号
-     * @param result 查询结果
-     * @param entity 实体类型字符串
-     * @param id 实体ID
-     */
-    void genericQueryReady(const QVariantMap& result, const QString& entity, const QString& id);
-    
-    /**
-     * @brief 浏览结果准备就绪信号
-     * @param results 浏览结果列表
-     * @param entity 实体类型字符串
-     * @param totalCount 总结果数
-     * @param offset 偏移量
-     */
-    void browseResultsReady(const QList<QSharedPointer<ResultItem>>& results, const QString& entity, int totalCount, int offset);
-    
     /**
-     * @brief 用户集合列表准备就绪信号
-     * @param collections 集合列表
+     * @brief 创建流式解析状态
+     * @param type 请求类型
+     * @param context 请求上下文信息
+     * @return 解析状态；该请求不支持流式解析（详情等非列表响应）时返回空指针
      */
-    void userCollectionsReady(const QList<QVariantMap>& collections);
-    
+    QSharedPointer<StreamingParseState> createStreamingState(RequestType type, const QVariantMap& context) const;
+
     /**
-     * @brief 集合内容准备就绪信号
-     * @param contents 集合内容
-     * @param collectionId 集合ID
+     * @brief 输入一块响应数据
+     * @param state 流式解析状态
+     * @param chunk 新到达的字节
+     * @param finished 是否为最后一块（响应已下载完成）
+     * @return 未完成时为partial结果（只包含新解析出的实体）；完成时为完整结果
      */
-    void collectionContentsReady(const QList<QSharedPointer<ResultItem>>& contents, const QString& collectionId);
-    
+    ParsedResponse feedStreaming(StreamingParseState *state, const QByteArray& chunk, bool finished);
+
+private:
     /**
-     * @brief 集合修改完成信号
-     * @param success 操作是否成功
-     * @param collectionId 集合ID
-     * @param operation 操作类型（add/remove）
+     * @brief 构造解析失败的结果
      */
-    void collectionModified(bool success, const QString& collectionId, const QString& operation);
-    
+    static ParsedResponse makeError(RequestType type, const QString &message);
+
     /**
-     * @brief 错误发生信号
-     * @param errorMessage 错误消息
+     * @brief 从详情响应的根对象构造结果
      */
-    void errorOccurred(const QString& errorMessage);
+    ParsedResponse buildDetailsResponse(const QJsonObject &root, EntityType entityType);
 
-private:
     /**
      * @brief MusicBrainz解析器指针
      */
@@ -1,68 +1,59 @@
 #include "musicbrainzapi.h"
-#include "musicbrainzparser.h"
+#include "musicbrainz_api_hub.h"
 #include "musicbrainz_response_handler.h"
-#include "network_manager.h"
 #include "api_utils.h"
 #include "../models/resultitem.h"
 #include "../core/error_types.h"
-#include <QNetworkReply>
 #include <QJsonDocument>
 #include <QJsonObject>
 #include <QJsonArray>
 #include <QUrlQuery>
 #include <QUrl>
+#include <QCoreApplication>
 #include <QDebug>
 
 MusicBrainzApi::MusicBrainzApi(QObject *parent)
     : QObject(parent)
-    , m_networkManager(new NetworkManager(this))
-    , m_parser(new MusicBrainzParser(this))
-    , m_responseHandler(new MusicBrainzResponseHandler(m_parser, this))
-    , m_userAgent("MusicBrainzQt/1.0 (https://github.com/MoeclubL/MusicBrainzQt)")
     , m_lastHttpCode(0)
     , m_version("1.0.0")
-{    
-    // 连接网络管理器信号
-    connect(m_networkManager, &NetworkManager::requestFinished,
-            this, &MusicBrainzApi::onRequestFinished);
-    connect(m_networkManager, &NetworkManager::requestError,
-            this, &MusicBrainzApi::onRequestError);
-    
-    // 连接响应处理器信号
-    connect(m_responseHandler, &MusicBrainzResponseHandler::searchResultsReady,
-            this, &MusicBrainzApi::searchResultsReady);
-    connect(m_responseHandler, &MusicBrainzResponseHandler::detailsReady,
-            this, &MusicBrainzApi::detailsReady);
-    connect(m_responseHandler, &MusicBrainzResponseHandler::discIdLookupReady,
-            this, &MusicBrainzApi::discIdLookupReady);
-    connect(m_responseHandler, &MusicBrainzResponseHandler::genericQueryReady,
-            this, &MusicBrainzApi::genericQueryReady);
-    connect(m_responseHandler, &MusicBrainzResponseHandler::browseResultsReady,
-            this, &MusicBrainzApi::browseResultsReady);
-    connect(m_responseHandler, &MusicBrainzResponseHandler::userCollectionsReady,
-            this, &MusicBrainzApi::userCollectionsReady);
-    connect(m_responseHandler, &MusicBrainzResponseHandler::collectionContentsReady,
-            this, &MusicBrainzApi::collectionContentsReady);
-    connect(m_responseHandler, &MusicBrainzResponseHandler::collectionModified,
-            this, &MusicBrainzApi::collectionModified);
-    connect(m_responseHandler, &MusicBrainzResponseHandler::errorOccurred,
-            this, &MusicBrainzApi::errorOccurred);
-            
-    qDebug() << "MusicBrainzApi initialized with optimized architecture";
+{
+    // 确保共享请求中心已创建
+    MusicBrainzApiHub::instance();
 }
 
 MusicBrainzApi::~MusicBrainzApi()
 {
-    // NetworkManager会自动清理未完成的请求
+    // 未完成的请求随外观对象一起取消：无人等待的网络请求会被出队或中止。
+    // 应用对象析构时共享中心也在销毁，此时不再访问它
+    if (QCoreApplication::instance()) {
+        cancelAllRequests();
+    }
+}
+
+void MusicBrainzApi::cancelRequest(RequestId requestId)
+{
+    if (requestId == 0) {
+        return;
+    }
+    if (m_storeTickets.remove(requestId)) {
+        return;
+    }
+    MusicBrainzApiHub::instance()->cancel(this, requestId);
+}
+
+void MusicBrainzApi::cancelAllRequests()
+{
+    m_storeTickets.clear();
+    MusicBrainzApiHub::instance()->cancelAll(this);
 }
 
-void MusicBrainzApi::search(const QString &query, EntityType type, int limit, int offset)
+RequestId MusicBrainzApi::search(const QString &query, EntityType type, int limit, int offset)
 {
     // 使用Validator进行参数验证
     QString cleanedQuery = Validator::validateAndCleanQuery(query);
     if (cleanedQuery.isEmpty()) {
-        emit errorOccurred("Empty search query");
-        return;
+        emit errorOccurred("Empty search query", 0);
+        return 0;
     }
     
     auto pagination = Validator::validatePagination(limit, offset);
@@ -70,8 +61,8 @@ void MusicBrainzApi::search(const QString &query, EntityType type, int limit, in
     // 使用UrlBuilder构建URL
     QString url = UrlBuilder::buildSearchUrl(cleanedQuery, type, pagination.first, pagination.second);
     if (url.isEmpty()) {
-        emit errorOccurred("Invalid entity type for search");
-        return;
+        emit errorOccurred("Invalid entity type for search", 0);
+        return 0;
     }
     
     // 创建请求上下文
@@ -81,39 +72,62 @@ void MusicBrainzApi::search(const QString &query, EntityType type, int limit, in
     context["limit"] = pagination.first;
     context["offset"] = pagination.second;
     
-    sendRequestInternal(url, RequestType::Search, context);
+    // 搜索总是由用户直接触发，使用最高优先级
+    return sendRequestInternal(url, RequestType::Search, context, "GET", QByteArray(), false,
+                        RequestPriority::Interactive);
 }
 
-void MusicBrainzApi::getDetails(const QString &mbid, EntityType type)
+RequestId MusicBrainzApi::getDetails(const QString &mbid, EntityType type, RequestPriority priority)
 {
     // 使用Validator验证MBID
     if (!Validator::isValidMbid(mbid)) {
         qCritical() << "MusicBrainzApi::getDetails - Invalid MBID:" << mbid;
-        emit errorOccurred("Invalid MBID format");
-        return;
+        emit errorOccurred("Invalid MBID format", 0);
+        return 0;
     }
     
     // 使用UrlBuilder构建URL
     QString url = UrlBuilder::buildDetailsUrl(mbid, type);
     if (url.isEmpty()) {
-        emit errorOccurred("Invalid entity type for details");
-        return;
+        emit errorOccurred("Invalid entity type for details", 0);
+        return 0;
     }
     
+    const QString includes = EntityUtils::getDefaultIncludes(type);
+    
     // 创建请求上下文
     QVariantMap context;
     context["mbid"] = mbid;
     context["entityType"] = static_cast<int>(type);
+    context["includes"] = includes;
+    
+    // 本地实体存储中有新鲜副本时不走网络：这里只查索引，
+    // 读取数据文件和解码在解析线程上进行，结果在调用方拿到请求ID之后才发出
+    MusicBrainzApiHub *hub = MusicBrainzApiHub::instance();
+    const Mbid key = Mbid::fromString(mbid);
+    if (hub->hasStoredDetails(key, type, includes)) {
+        const RequestId ticket = hub->reserveTicket();
+        m_storeTickets.insert(ticket, StoreRequest{url, context, priority});
+        hub->loadStoredDetails(this, ticket, key, type, includes);
+        
+        qDebug() << "MusicBrainzApi::getDetails - MBID:" << mbid << "loading from entity store";
+        return ticket;
+    }
     
     qDebug() << "MusicBrainzApi::getDetails - MBID:" << mbid << "Type:" << static_cast<int>(type);
     
-    sendRequestInternal(url, RequestType::Details, context);
+    return sendRequestInternal(url, RequestType::Details, context, "GET", QByteArray(), false, priority);
+}
+
+bool MusicBrainzApi::hasStoredDetails(const QString &mbid, EntityType type) const
+{
+    return MusicBrainzApiHub::instance()->hasStoredDetails(Mbid::fromString(mbid), type,
+                                                           EntityUtils::getDefaultIncludes(type));
 }
 
 void MusicBrainzApi::setUserAgent(const QString &userAgent)
 {
-    m_userAgent = userAgent;
-    qDebug() << "User-Agent set to:" << userAgent;
+    MusicBrainzApiHub::instance()->setUserAgent(userAgent);
 }
 
 void MusicBrainzApi::setAuthentication(const QString &username, const QString &password)
@@ -126,8 +140,8 @@ void MusicBrainzApi::setAuthentication(const QString &username, const QString &p
 void MusicBrainzApi::setProxy(const QString &host, int port, 
                              const QString &username, const QString &password)
 {
-    // 配置NetworkManager的代理设置
-    m_networkManager->setProxy(host, port, username, password);
+    // 配置共享请求中心的代理设置
+    MusicBrainzApiHub::instance()->setProxy(host, port, username, password);
     qDebug() << "Proxy set to:" << host << ":" << port;
 }
 
@@ -135,11 +149,11 @@ void MusicBrainzApi::setProxy(const QString &host, int port,
 // 扩展API方法实现
 // =============================================================================
 
-void MusicBrainzApi::lookupDiscId(const QString &discId)
+RequestId MusicBrainzApi::lookupDiscId(const QString &discId)
 {
     if (discId.isEmpty()) {
-        emit errorOccurred("Empty DiscID provided");
-        return;
+        emit errorOccurred("Empty DiscID provided", 0);
+        return 0;
     }
     
     QString url = UrlBuilder::buildDiscIdUrl(discId);
@@ -149,16 +163,16 @@ void MusicBrainzApi::lookupDiscId(const QString &discId)
     
     qDebug() << "MusicBrainzApi::lookupDiscId - DiscID:" << discId;
     
-    sendRequestInternal(url, RequestType::DiscId, context);
+    return sendRequestInternal(url, RequestType::DiscId, context);
 }
 
-void MusicBrainzApi::genericQuery(const QString &entity, const QString &id,
+RequestId MusicBrainzApi::genericQuery(const QString &entity, const QString &id,
                                  const QString &resource, const QStringList &includes,
                                  const QVariantMap &params)
 {
     if (!Validator::isValidEntity(entity)) {
-        emit errorOccurred("Invalid entity type provided");
-        return;
+        emit errorOccurred("Invalid entity type provided", 0);
+        return 0;
     }
     
     QString url = UrlBuilder::buildGenericUrl(entity, id, resource, includes, params);
@@ -170,15 +184,15 @@ void MusicBrainzApi::genericQuery(const QString &entity, const QString &id,
     
     qDebug() << "MusicBrainzApi::genericQuery - Entity:" << entity << "ID:" << id;
     
-    sendRequestInternal(url, RequestType::Generic, context);
+    return sendRequestInternal(url, RequestType::Generic, context);
 }
 
-void MusicBrainzApi::browse(const QString &entity, const QString &relatedEntity,
+RequestId MusicBrainzApi::browse(const QString &entity, const QString &relatedEntity,
                            const QString &relatedId, int limit, int offset)
 {
     if (!Validator::isValidEntity(entity) || relatedEntity.isEmpty() || relatedId.isEmpty()) {
-        emit errorOccurred("Invalid browse parameters");
-        return;
+        emit errorOccurred("Invalid browse parameters", 0);
+        return 0;
     }
     
     auto pagination = Validator::validatePagination(limit, offset);
@@ -194,14 +208,14 @@ void MusicBrainzApi::browse(const QString &entity, const QString &relatedEntity,
     
     qDebug() << "MusicBrainzApi::browse - Entity:" << entity << "Related:" << relatedEntity;
     
-    sendRequestInternal(url, RequestType::Browse, context);
+    return sendRequestInternal(url, RequestType::Browse, context);
 }
 
-void MusicBrainzApi::getUserCollections()
+RequestId MusicBrainzApi::getUserCollections()
 {
     if (m_username.isEmpty()) {
-        emit errorOccurred("Authentication required for collection access");
-        return;
+        emit errorOccurred("Authentication required for collection access", 0);
+        return 0;
     }
     
     QString url = UrlBuilder::buildCollectionUrl();
@@ -209,14 +223,14 @@ void MusicBrainzApi::getUserCollections()
     QVariantMap context;
     context["operation"] = "list";
     
-    sendRequestInternal(url, RequestType::Collection, context, "GET", QByteArray(), true);
+    return sendRequestInternal(url, RequestType::Collection, context, "GET", QByteArray(), true);
 }
 
-void MusicBrainzApi::getCollectionContents(const QString &collectionId)
+RequestId MusicBrainzApi::getCollectionContents(const QString &collectionId)
 {
     if (collectionId.isEmpty()) {
-        emit errorOccurred("Empty collection ID provided");
-        return;
+        emit errorOccurred("Empty collection ID provided", 0);
+        return 0;
     }
     
     QString url = UrlBuilder::buildCollectionUrl(collectionId, "releases");
@@ -225,14 +239,14 @@ void MusicBrainzApi::getCollectionContents(const QString &collectionId)
     context["collectionId"] = collectionId;
     context["operation"] = "contents";
     
-    sendRequestInternal(url, RequestType::Collection, context);
+    return sendRequestInternal(url, RequestType::Collection, context);
 }
 
-void MusicBrainzApi::addToCollection(const QString &collectionId, const QStringList &releaseIds)
+RequestId MusicBrainzApi::addToCollection(const QString &collectionId, const QStringList &releaseIds)
 {
     QString url = prepareCollectionModification(collectionId, releaseIds);
     if (url.isEmpty()) {
-        return;
+        return 0;
     }
     
     QVariantMap context;
@@ -240,14 +254,14 @@ void MusicBrainzApi::addToCollection(const QString &collectionId, const QStringL
     context["operation"] = "add";
     context["releaseIds"] = releaseIds;
     
-    sendRequestInternal(url, RequestType::Collection, context, "PUT", QByteArray(), true);
+    return sendRequestInternal(url, RequestType::Collection, context, "PUT", QByteArray(), true);
 }
 
-void MusicBrainzApi::removeFromCollection(const QString &collectionId, const QStringList &releaseIds)
+RequestId MusicBrainzApi::removeFromCollection(const QString &collectionId, const QStringList &releaseIds)
 {
     QString url = prepareCollectionModification(collectionId, releaseIds);
     if (url.isEmpty()) {
-        return;
+        return 0;
     }
     
     QVariantMap context;
@@ -255,18 +269,18 @@ void MusicBrainzApi::removeFromCollection(const QString &collectionId, const QSt
     context["operation"] = "remove";
     context["releaseIds"] = releaseIds;
     
-    sendRequestInternal(url, RequestType::Collection, context, "DELETE", QByteArray(), true);
+    return sendRequestInternal(url, RequestType::Collection, context, "DELETE", QByteArray(), true);
 }
 
 QString MusicBrainzApi::prepareCollectionModification(const QString &collectionId, const QStringList &releaseIds)
 {
     if (m_username.isEmpty()) {
-        emit errorOccurred("Authentication required for collection modification");
+        emit errorOccurred("Authentication required for collection modification", 0);
         return QString();
     }
     
     if (collectionId.isEmpty() || releaseIds.isEmpty()) {
-        emit errorOccurred("Invalid collection modification parameters");
+        emit errorOccurred("Invalid collection modification parameters", 0);
         return QString();
     }
     
@@ -296,77 +310,98 @@ QString MusicBrainzApi::getVersion() const
 // 统一请求处理架构
 // =============================================================================
 
-void MusicBrainzApi::sendRequestInternal(const QString& url, RequestType type, const QVariantMap& context,
-                                         const QString &method, const QByteArray &data, bool authenticated)
+RequestId MusicBrainzApi::sendRequestInternal(const QString& url, RequestType type, const QVariantMap& context,
+                                              const QString &method, const QByteArray &data, bool authenticated,
+                                              RequestPriority priority, RequestId ticket)
 {
-    qDebug() << "MusicBrainzApi: Sending request -" << url;
+    // 请求中心返回的凭据即请求ID
+    const RequestId requestId = MusicBrainzApiHub::instance()->submit(
+        this, url, type, context, method, data,
+        authenticated ? m_username : QString(), authenticated ? m_password : QString(),
+        priority, ticket);
 
-    QNetworkReply *reply;
-    if (authenticated) {
-        reply = m_networkManager->sendAuthenticatedRequest(url, m_userAgent, m_username, m_password, method, data);
-    } else {
-        reply = m_networkManager->sendRequest(url, m_userAgent);
+    if (requestId == 0) {
+        emit errorOccurred(QString("Failed to send %1 request").arg(method), 0);
     }
-
-    // Store context and type in the reply itself
-    reply->setProperty("requestType", static_cast<int>(type));
-    reply->setProperty("requestContext", context);
+    return requestId;
 }
 
-void MusicBrainzApi::onRequestFinished(QNetworkReply *reply, const QString &url)
+void MusicBrainzApi::deliverError(const QString &error, RequestId ticket, int httpCode)
 {
-    Q_UNUSED(url); // URL is now retrieved from reply property
-
-    RequestType type = static_cast<RequestType>(reply->property("requestType").toInt());
-    QVariantMap context = reply->property("requestContext").toMap();
-
-    processResponse(reply, type, context);
+    if (httpCode != 0) {
+        m_lastHttpCode = httpCode;
+    }
+    m_lastErrorMessage = error;
+    emit errorOccurred(error, ticket);
 }
 
-void MusicBrainzApi::onRequestError(const QString &error, const QString &url)
+void MusicBrainzApi::deliverStoredDetails(const EntityPayload &stored, EntityType type, RequestId ticket)
 {
-    qCritical() << "MusicBrainzApi network error:" << error << "for URL:" << url;
-    emit errorOccurred(error);
+    // 读取期间已被取消
+    const auto it = m_storeTickets.constFind(ticket);
+    if (it == m_storeTickets.constEnd()) {
+        return;
+    }
+    const StoreRequest request = it.value();
+    m_storeTickets.erase(it);
+    
+    if (!stored.isNull()) {
+        emit detailsReady(stored, type, ticket);
+        return;
+    }
+    
+    // 检查之后副本被淘汰或过期：沿用同一个请求ID改走网络
+    qDebug() << "MusicBrainzApi::deliverStoredDetails - MBID:" << request.context.value("mbid").toString()
+             << "no longer in entity store, fetching";
+    sendRequestInternal(request.url, RequestType::Details, request.context, "GET", QByteArray(), false,
+                        request.priority, ticket);
 }
 
-void MusicBrainzApi::processResponse(QNetworkReply* reply, RequestType type, const QVariantMap& context)
+void MusicBrainzApi::deliverResponse(const ParsedResponse &response, const QVariantMap &context,
+                                     RequestId ticket, int httpCode)
 {
-    QByteArray data = reply->readAll();
-    m_lastHttpCode = reply->attribute(QNetworkRequest::HttpStatusCodeAttribute).toInt();
-    
-    // 检查HTTP错误
-    if (reply->error() != QNetworkReply::NoError) {
-        m_lastErrorMessage = reply->errorString();
-        qCritical() << "HTTP Error" << m_lastHttpCode << ":" << m_lastErrorMessage;
-        emit errorOccurred(m_lastErrorMessage);
-        reply->deleteLater();
+    m_lastHttpCode = httpCode;
+    if (!response.success) {
+        m_lastErrorMessage = response.errorMessage;
+        emit errorOccurred(response.errorMessage, ticket);
         return;
     }
     
-    // 根据请求类型分发给响应处理器
-    switch (type) {
+    if (response.partial) {
+        // 流式解析的中间结果，完整结果随后仍按请求类型发出
+        emit partialResultsReady(response.items, ticket);
+        return;
+    }
+    
+    switch (response.type) {
         case RequestType::Search:
-            m_responseHandler->handleSearchResponse(data, context);
+            emit searchResultsReady(response.items, response.totalCount, response.offset);
             break;
         case RequestType::Details:
-            m_responseHandler->handleDetailsResponse(data, context);
+            emit detailsReady(response.entity, response.entityType, ticket);
             break;
         case RequestType::DiscId:
-            m_responseHandler->handleDiscIdResponse(data, context);
+            emit discIdLookupReady(response.items, context.value("discId").toString());
             break;
         case RequestType::Generic:
-            m_responseHandler->handleGenericResponse(data, context);
+            emit genericQueryReady(response.data, context.value("entity").toString(),
+                                   context.value("id").toString());
             break;
         case RequestType::Browse:
-            m_responseHandler->handleBrowseResponse(data, context);
+            emit browseResultsReady(response.items, context.value("entity").toString(),
+                                    response.totalCount, response.offset);
             break;
-        case RequestType::Collection:
-            // 对于集合操作，需要传递HTTP状态码
-            QVariantMap contextWithStatus = context;
-            contextWithStatus["httpStatusCode"] = m_lastHttpCode;
-            m_responseHandler->handleCollectionResponse(data, contextWithStatus);
+        case RequestType::Collection: {
+            const QString operation = context.value("operation").toString();
+            const QString collectionId = context.value("collectionId").toString();
+            if (operation == "list") {
+                emit userCollectionsReady(response.collections);
+            } else if (operation == "contents") {
+                emit collectionContentsReady(response.items, collectionId);
+            } else if (operation == "add" || operation == "remove") {
+                emit collectionModified(response.operationSucceeded, collectionId, operation);
+            }
             break;
+        }
     }
-    
-    reply->deleteLater();
-}
\ No newline at end of file
+}
@@ -4,15 +4,15 @@
 #include <QObject>
 #include <QSharedPointer>
 #include <QVariantMap>
-#include <QQueue>
+#include <QSet>
+#include <QHash>
 #include "../core/types.h"
 #include "api_utils.h"
+#include "../models/entitypayload.h"
 
 class ResultItem;
-class NetworkManager;
-class MusicBrainzParser;
-class MusicBrainzResponseHandler;
-class QNetworkReply;
+class MusicBrainzApiHub;
+struct ParsedResponse;
 
 /**
  * @brief MusicBrainz Web Service API接口实现
@@ -20,10 +20,14 @@ class QNetworkReply;
  * MusicBrainzApi是MusicBrainzQt与MusicBrainz Web Service API的主要接口。
  * 它封装了所有API调用，处理HTTP请求、响应解析、错误处理和速率限制。
  * 
+ * MusicBrainzApi本身只是轻量的外观对象：网络连接、速率限制、请求合并和解析
+ * 都由进程内共享的MusicBrainzApiHub完成，各个服务可以放心地各自创建实例。
+ * 
  * 核心功能：
  * - 实体搜索：支持艺术家、专辑、录音、作品等所有实体类型的搜索
  * - 详细信息获取：获取实体的完整信息，包括关系、别名、标签等
  * - 速率限制：严格遵守MusicBrainz的1请求/秒限制
+ * - 请求合并：全进程相同的GET请求在途时只发送一次，响应解析一次后分发给所有调用方
  * - 错误处理：提供详细的错误信息和恢复机制
  * - 异步操作：所有操作都是非阻塞的，通过信号返回结果
  * 
@@ -36,10 +40,11 @@ class QNetworkReply;
  * 设计模式：
  * - 外观模式：为复杂的API提供简单接口
  * - 异步模式：使用信号槽处理异步响应
- * - 单例特征：通常每个应用实例只需一个API对象
+ * - 共享中心：所有实例共享一个MusicBrainzApiHub
  * 
  * @see https://musicbrainz.org/doc/MusicBrainz_API MusicBrainz API文档
  * @see ResultItem 实体数据容器
+ * @see MusicBrainzApiHub 共享请求中心
  */
 class MusicBrainzApi : public QObject
 {
@@ -66,21 +71,55 @@ public:
      * @param type 实体类型（艺术家、专辑等）
      * @param limit 返回结果数量限制（默认25）
      * @param offset 结果偏移量，用于分页（默认0）
+     * @return 请求ID，参数无效时返回0（同时发出errorOccurred）
      * 
      * 异步方法，结果通过searchResultsReady信号返回。
      * 支持Lucene查询语法进行复杂搜索。
      */
-    void search(const QString &query, EntityType type, int limit = 25, int offset = 0);
+    RequestId search(const QString &query, EntityType type, int limit = 25, int offset = 0);
     
     /**
      * @brief 获取实体详细信息
      * @param mbid MusicBrainz ID（UUID格式）
      * @param type 实体类型
+     * @param priority 请求优先级（后台批量加载应使用Prefetch或Bulk）
+     * @return 请求ID，随detailsReady/errorOccurred带回；参数无效时返回0
      * 
      * 异步方法，获取包含关系、别名、标签等的完整实体信息。
-     * 结果通过detailsReady信号返回。
+     * 结果通过detailsReady信号返回。本地实体存储中有新鲜副本时不发送网络请求，
+     * 副本在后台线程读取，结果同样在返回之后异步发出。
+     */
+    RequestId getDetails(const QString &mbid, EntityType type,
+                         RequestPriority priority = RequestPriority::Interactive);
+    
+    /**
+     * @brief 本地实体存储中是否有可以直接返回的详情
+     * @param mbid MusicBrainz ID
+     * @param type 实体类型
+     * @return true 如果getDetails不需要网络请求
      */
-    void getDetails(const QString &mbid, EntityType type);
+    bool hasStoredDetails(const QString &mbid, EntityType type) const;
+    
+    // =============================================================================
+    // 请求取消
+    // =============================================================================
+    
+    /**
+     * @brief 取消请求
+     * @param requestId 请求方法返回的请求ID
+     * 
+     * 取消后不会再收到该请求的结果或错误信号。如果没有其他调用方在等待
+     * 同一个响应，网络请求会从调度队列移除或直接中止。
+     */
+    void cancelRequest(RequestId requestId);
+    
+    /**
+     * @brief 取消本实例发起的所有未完成请求
+     * 
+     * 析构时会自动调用，因此把API对象挂在标签页、控件等对象下，
+     * 即可让请求的生命周期跟随其所有者。
+     */
+    void cancelAllRequests();
     
     // =============================================================================
     // 配置方法
@@ -92,6 +131,8 @@ public:
      * 
      * MusicBrainz要求所有客户端提供适当的User-Agent标识。
      * 格式：应用名/版本 (联系信息)
+     * 
+     * User-Agent由共享请求中心统一使用，设置后对所有实例生效。
      */
     void setUserAgent(const QString &userAgent);    /**
      * @brief 设置认证信息
@@ -108,6 +149,8 @@ public:
      * @param port 代理端口
      * @param username 代理用户名（可选）
      * @param password 代理密码（可选）
+     * 
+     * 代理设置在共享请求中心上，对所有实例生效。
      */
     void setProxy(const QString &host, int port, 
                   const QString &username = QString(), 
@@ -116,7 +159,7 @@ public:
      * @brief 查找DiscID对应的发行版
      * @param discId CD的DiscID
      */
-    void lookupDiscId(const QString &discId);
+    RequestId lookupDiscId(const QString &discId);
     
     /**
      * @brief 通用查询方法
@@ -126,9 +169,9 @@ public:
      * @param includes 包含的关系信息列表
      * @param params 额外查询参数
      */
-    void genericQuery(const QString &entity, const QString &id = QString(),
-                     const QString &resource = QString(), const QStringList &includes = {},
-                     const QVariantMap &params = {});
+    RequestId genericQuery(const QString &entity, const QString &id = QString(),
+                          const QString &resource = QString(), const QStringList &includes = {},
+                          const QVariantMap &params = {});
     
     /**
      * @brief 浏览相关实体
@@ -138,20 +181,20 @@ public:
      * @param limit 结果限制（默认25）
      * @param offset 结果偏移（默认0）
      */
-    void browse(const QString &entity, const QString &relatedEntity,
-               const QString &relatedId, int limit = 25, int offset = 0);
+    RequestId browse(const QString &entity, const QString &relatedEntity,
+                     const QString &relatedId, int limit = 25, int offset = 0);
     
     /**
      * @brief 获取用户集合列表
      * 需要认证
      */
-    void getUserCollections();
+    RequestId getUserCollections();
     
     /**
      * @brief 获取集合内容
      * @param collectionId 集合ID
      */
-    void getCollectionContents(const QString &collectionId);
+    RequestId getCollectionContents(const QString &collectionId);
     
     /**
      * @brief 添加到集合
@@ -159,7 +202,7 @@ public:
      * @param releaseIds 要添加的发行版ID列表
      * 需要认证
      */
-    void addToCollection(const QString &collectionId, const QStringList &releaseIds);
+    RequestId addToCollection(const QString &collectionId, const QStringList &releaseIds);
     
     /**
      * @brief 从集合移除
@@ -167,7 +210,7 @@ public:
      * @param releaseIds 要移除的发行版ID列表
      * 需要认证
      */
-    void removeFromCollection(const QString &collectionId, const QStringList &releaseIds);
+    RequestId removeFromCollection(const QString &collectionId, const QStringList &releaseIds);
     
     // =============================================================================
     // 状态查询方法
@@ -205,15 +248,27 @@ signals:
     
     /**
      * @brief 详细信息就绪信号
-     * @param details 实体详细信息（原始JSON数据）
+     * @param details 实体详细信息
      * @param type 实体类型
+     * @param requestId getDetails返回的请求ID
      */
-    void detailsReady(const QVariantMap &details, EntityType type);
+    void detailsReady(const EntityPayload &details, EntityType type, RequestId requestId);
       /**
      * @brief 错误发生信号
      * @param error 错误描述信息
+     * @param requestId 出错请求的ID；请求在发送前就失败时为0
+     */
+    void errorOccurred(const QString &error, RequestId requestId);
+    
+    /**
+     * @brief 部分结果就绪信号
+     * @param results 新解析出的实体（下载过程中已完整到达的部分）
+     * @param requestId 请求ID
+     * 
+     * 搜索和浏览的响应边下载边解析，大响应在下载完成前会多次发出本信号；
+     * 完成后仍会发出包含全部结果的searchResultsReady/browseResultsReady。
      */
-    void errorOccurred(const QString &error);
+    void partialResultsReady(const QList<QSharedPointer<ResultItem>> &results, RequestId requestId);
     
     // =============================================================================
     // 扩展信号定义
@@ -266,29 +321,57 @@ signals:
      */
     void collectionModified(bool success, const QString &collectionId, const QString &operation);
 
-private slots:
-    void onRequestFinished(QNetworkReply *reply, const QString &url);
-    void onRequestError(const QString &error, const QString &url);
-
 private:
+    friend class MusicBrainzApiHub;
+
     // 统一请求处理
-    void sendRequestInternal(const QString& url, RequestType type, const QVariantMap& context, 
-                             const QString &method = "GET", const QByteArray &data = QByteArray(), 
-                             bool authenticated = false);
-    void processResponse(QNetworkReply* reply, RequestType type, const QVariantMap& context);
+    RequestId sendRequestInternal(const QString& url, RequestType type, const QVariantMap& context, 
+                                  const QString &method = "GET", const QByteArray &data = QByteArray(), 
+                                  bool authenticated = false,
+                                  RequestPriority priority = RequestPriority::Interactive,
+                                  RequestId ticket = 0);
+
+    /**
+     * @brief 接收请求中心投递的解析结果
+     * @param response 共享的解析结果
+     * @param context 本次调用的请求上下文
+     * @param ticket 请求凭据
+     * @param httpCode HTTP状态码
+     */
+    void deliverResponse(const ParsedResponse &response, const QVariantMap &context,
+                         RequestId ticket, int httpCode);
+
+    /**
+     * @brief 接收请求中心投递的错误
+     */
+    void deliverError(const QString &error, RequestId ticket, int httpCode);
+
+    /**
+     * @brief 接收从本地实体存储读出的详情结果
+     * @param stored 存储的结果；读取前已失效时为空，此时改走网络请求
+     * @param type 实体类型
+     * @param ticket 请求凭据
+     */
+    void deliverStoredDetails(const EntityPayload &stored, EntityType type, RequestId ticket);
 
     QString prepareCollectionModification(const QString &collectionId, const QStringList &releaseIds);
 
-    NetworkManager *m_networkManager;
-    class MusicBrainzParser *m_parser;
-    class MusicBrainzResponseHandler *m_responseHandler;
-    QString m_userAgent;
-    
     // 认证信息
     QString m_username;
     QString m_password;
     
+    /**
+     * @struct StoreRequest
+     * @brief 正在从本地实体存储读取的详情请求
+     */
+    struct StoreRequest {
+        QString url;                    ///< 存储中没有副本时使用的请求URL
+        QVariantMap context;            ///< 请求上下文
+        RequestPriority priority;       ///< 请求优先级
+    };
+
     // 状态跟踪
+    QHash<RequestId, StoreRequest> m_storeTickets;  ///< 从本地实体存储返回、尚未发出的请求
     int m_lastHttpCode;
     QString m_lastErrorMessage;
     QString m_version;
@@ -1,8 +1,191 @@
 #include "musicbrainzparser.h"
 #include "api_utils.h"
+#include "entity_schema.h"
+#include "../utils/string_pool.h"
+#include "../core/mbid.h"
 #include <QDebug>
 #include <QRegularExpression>
 #include <QDate>
+#include <QSet>
+#include <QtAlgorithms>
+#include <type_traits>
+
+namespace {
+
+template <EntityType Type>
+using SchemaTag = std::integral_constant<EntityType, Type>;
+
+/**
+ * @brief 按运行时的实体类型调用对应字段表的访问函数
+ * @param visitor 接受SchemaTag<Type>参数的泛型函数
+ */
+template <typename Visitor>
+decltype(auto) visitEntitySchema(EntityType type, Visitor &&visitor)
+{
+    switch (type) {
+        case EntityType::Artist:
+            return visitor(SchemaTag<EntityType::Artist>());
+        case EntityType::Release:
+            return visitor(SchemaTag<EntityType::Release>());
+        case EntityType::Recording:
+            return visitor(SchemaTag<EntityType::Recording>());
+        case EntityType::ReleaseGroup:
+            return visitor(SchemaTag<EntityType::ReleaseGroup>());
+        case EntityType::Work:
+            return visitor(SchemaTag<EntityType::Work>());
+        case EntityType::Label:
+            return visitor(SchemaTag<EntityType::Label>());
+        case EntityType::Area:
+            return visitor(SchemaTag<EntityType::Area>());
+        case EntityType::Place:
+            return visitor(SchemaTag<EntityType::Place>());
+        case EntityType::Event:
+            return visitor(SchemaTag<EntityType::Event>());
+        case EntityType::Instrument:
+            return visitor(SchemaTag<EntityType::Instrument>());
+        case EntityType::Series:
+            return visitor(SchemaTag<EntityType::Series>());
+        default:
+            return visitor(SchemaTag<EntityType::Unknown>());
+    }
+}
+
+QLatin1String latin1(std::string_view text)
+{
+    return QLatin1String(text.data(), qsizetype(text.size()));
+}
+
+/**
+ * @brief 在字段表中查找JSON键（运行时版本）
+ *
+ * 每个字段表只有几项，线性比较比任何映射查找都快。
+ */
+template <EntityType Type>
+const FieldSpec *lookupFieldSpec(const QString &key)
+{
+    for (const FieldSpec &spec : EntitySchema<Type>::fields) {
+        if (key == latin1(spec.jsonKey)) {
+            return &spec;
+        }
+    }
+    return nullptr;
+}
+
+/**
+ * @brief 字段表中各项的结果键名，每种实体类型只构造一次
+ */
+template <EntityType Type>
+auto makeDetailKeys()
+{
+    std::array<QString, EntitySchema<Type>::fields.size()> keys;
+    for (std::size_t i = 0; i < keys.size(); ++i) {
+        keys[i] = latin1(EntitySchema<Type>::fields[i].detailKey);
+    }
+    return keys;
+}
+
+// =============================================================================
+// 实体类型检测规则
+// =============================================================================
+
+/**
+ * @brief 用于区分实体类型的特征字段（序号即位掩码中的位）
+ */
+constexpr std::array<std::string_view, 18> DETECTION_KEYS = {{
+    "type", "sort-name", "gender", "life-span",
+    "status", "barcode", "release-events", "media",
+    "length", "artist-credit",
+    "primary-type", "first-release-date",
+    "work-type", "language",
+    "label-code",
+    "iso-3166-1-codes", "iso-3166-2-codes",
+    "title"
+}};
+
+constexpr quint32 detectionKey(std::string_view key)
+{
+    for (std::size_t i = 0; i < DETECTION_KEYS.size(); ++i) {
+        if (DETECTION_KEYS[i] == key) {
+            return 1u << i;
+        }
+    }
+    return 0;
+}
+
+/**
+ * @brief 检测规则：required中的字段全部存在，且anyOf为空或其中至少一个存在
+ */
+struct DetectionRule {
+    quint32 required;
+    quint32 anyOf;
+    EntityType type;
+};
+
+constexpr std::array<DetectionRule, 7> DETECTION_RULES = {{
+    {detectionKey("type") | detectionKey("sort-name"),
+     detectionKey("gender") | detectionKey("life-span"), EntityType::Artist},
+    {detectionKey("status") | detectionKey("barcode"),
+     detectionKey("release-events") | detectionKey("media"), EntityType::Release},
+    {detectionKey("length") | detectionKey("artist-credit"), 0, EntityType::Recording},
+    {0, detectionKey("primary-type") | detectionKey("first-release-date"), EntityType::ReleaseGroup},
+    {0, detectionKey("work-type") | detectionKey("language"), EntityType::Work},
+    {0, detectionKey("label-code") | detectionKey("type"), EntityType::Label},
+    {0, detectionKey("iso-3166-1-codes") | detectionKey("iso-3166-2-codes"), EntityType::Area}
+}};
+
+/**
+ * @brief 值是否在延迟模式下留给解码器
+ *
+ * 只延迟对象和对象数组；字符串数组（如ISRC列表）转换成本很低，仍然立即转换。
+ */
+bool isDeferredValue(const QJsonValue &value)
+{
+    if (value.isObject()) {
+        return true;
+    }
+    if (value.isArray()) {
+        const QJsonArray array = value.toArray();
+        return !array.isEmpty() && (array.first().isObject() || array.first().isArray());
+    }
+    return false;
+}
+
+/**
+ * @brief 列表实体的延迟字段解码器
+ *
+ * 解码时对源对象做一次完整解析，结果与不延迟时完全相同。
+ */
+class DeferredFieldDecoder : public LazyFieldDecoder
+{
+public:
+    bool providesField(const QJsonObject &source, EntityType type, const QString &key) const override
+    {
+        if (isDeferredValue(source.value(key))) {
+            return true;
+        }
+        
+        // 按字段表改名保存的整理结果
+        return visitEntitySchema(type, [&](auto schema) {
+            for (const FieldSpec &spec : EntitySchema<decltype(schema)::value>::fields) {
+                if (spec.detailKey != spec.jsonKey && key == latin1(spec.detailKey)) {
+                    return source.contains(latin1(spec.jsonKey));
+                }
+            }
+            return false;
+        });
+    }
+    
+    QVariantMap decode(const QJsonObject &source, EntityType type) const override
+    {
+        MusicBrainzParser parser;
+        const auto item = parser.parseEntity(source, type);
+        return item ? item->getDetailData() : QVariantMap();
+    }
+};
+
+const DeferredFieldDecoder s_deferredFieldDecoder;
+
+} // namespace
 
 MusicBrainzParser::MusicBrainzParser(QObject *parent)
     : QObject(parent)
@@ -15,15 +198,19 @@ MusicBrainzParser::MusicBrainzParser(QObject *parent)
 
 QList<QSharedPointer<ResultItem>> MusicBrainzParser::parseSearchResponse(const QByteArray &data, EntityType expectedType)
 {
-    QList<QSharedPointer<ResultItem>> results;
-    
-    if (!validateJsonData(data)) {
+    QJsonObject root;
+    if (!parseRootObject(data, &root)) {
         qWarning() << "MusicBrainzParser::parseSearchResponse - Invalid JSON data";
-        return results;
+        return {};
     }
     
-    QJsonDocument doc = QJsonDocument::fromJson(data);
-    QJsonObject root = doc.object();
+    return parseSearchResponse(root, expectedType);
+}
+
+QList<QSharedPointer<ResultItem>> MusicBrainzParser::parseSearchResponse(const QJsonObject &root, EntityType expectedType,
+                                                                         bool deferCompoundFields)
+{
+    QList<QSharedPointer<ResultItem>> results;
     
     // 检查API错误
     QString error = checkForErrors(root);
@@ -34,13 +221,12 @@ QList<QSharedPointer<ResultItem>> MusicBrainzParser::parseSearchResponse(const Q
     
     // 如果没有指定类型，尝试自动检测
     EntityType actualType = expectedType;
-    if (actualType == EntityType::Unknown) {        // 通过检查root对象的键来推断类型
-        QStringList keys = root.keys();
-        QStringList entityTypes;
-        entityTypes << "artists" << "releases" << "recordings" << "release-groups" << "works" << "labels" << "areas";
-          for (const QString &entityType : entityTypes) {
-            if (keys.contains(entityType)) {
-                actualType = EntityUtils::stringToEntityType(entityType.chopped(1)); // 去掉末尾的's'
+    if (actualType == EntityType::Unknown) {
+        // 列表响应的根对象只有几个成员，逐个用完美哈希表查找复数实体名
+        for (auto it = root.constBegin(); it != root.constEnd(); ++it) {
+            const EntityType type = EntityUtils::pluralNameToEntityType(it.key());
+            if (type != EntityType::Unknown && it.value().isArray()) {
+                actualType = type;
                 break;
             }
         }
@@ -56,10 +242,11 @@ QList<QSharedPointer<ResultItem>> MusicBrainzParser::parseSearchResponse(const Q
       qDebug() << "MusicBrainzParser::parseSearchResponse - Parsing" << items.size() 
                << "items of type" << EntityUtils::entityTypeToString(actualType);
     
+    results.reserve(items.size());
     for (const QJsonValue &value : items) {
         if (value.isObject()) {
             QJsonObject itemObj = value.toObject();
-            auto resultItem = parseEntity(itemObj, actualType);
+            auto resultItem = parseEntity(itemObj, actualType, deferCompoundFields);
             if (resultItem) {
                 results.append(resultItem);
             }
@@ -71,14 +258,17 @@ QList<QSharedPointer<ResultItem>> MusicBrainzParser::parseSearchResponse(const Q
 
 QSharedPointer<ResultItem> MusicBrainzParser::parseDetailsResponse(const QByteArray &data, EntityType expectedType)
 {
-    if (!validateJsonData(data)) {
+    QJsonObject root;
+    if (!parseRootObject(data, &root)) {
         qWarning() << "MusicBrainzParser::parseDetailsResponse - Invalid JSON data";
         return nullptr;
     }
     
-    QJsonDocument doc = QJsonDocument::fromJson(data);
-    QJsonObject root = doc.object();
-    
+    return parseDetailsResponse(root, expectedType);
+}
+
+QSharedPointer<ResultItem> MusicBrainzParser::parseDetailsResponse(const QJsonObject &root, EntityType expectedType)
+{
     // 检查API错误
     QString error = checkForErrors(root);
     if (!error.isEmpty()) {
@@ -96,7 +286,8 @@ QSharedPointer<ResultItem> MusicBrainzParser::parseDetailsResponse(const QByteAr
     return parseEntity(root, actualType);
 }
 
-QSharedPointer<ResultItem> MusicBrainzParser::parseEntity(const QJsonObject &jsonObj, EntityType type)
+QSharedPointer<ResultItem> MusicBrainzParser::parseEntity(const QJsonObject &jsonObj, EntityType type,
+                                                          bool deferCompoundFields)
 {
     if (jsonObj.isEmpty()) {
         return nullptr;
@@ -107,13 +298,13 @@ QSharedPointer<ResultItem> MusicBrainzParser::parseEntity(const QJsonObject &jso
         type = detectEntityType(jsonObj);
     }
     
-    // 获取基本信息
-    QString id = getJsonString(jsonObj, "id");
-    QString name = getJsonString(jsonObj, "name");
+    // 获取基本信息（实体ID各不相同，不参与驻留）
+    QString id = jsonObj.value(QStringLiteral("id")).toString();
+    QString name = getJsonString(jsonObj, QStringLiteral("name"));
     
     // 对于某些实体类型，name字段可能叫title
     if (name.isEmpty()) {
-        name = getJsonString(jsonObj, "title");
+        name = getJsonString(jsonObj, QStringLiteral("title"));
     }
     
     if (id.isEmpty() || name.isEmpty()) {
@@ -123,14 +314,13 @@ QSharedPointer<ResultItem> MusicBrainzParser::parseEntity(const QJsonObject &jso
     
     auto resultItem = QSharedPointer<ResultItem>::create(id, name, type);
     
-    // 解析基本信息
-    parseBasicEntityInfo(resultItem, jsonObj);
+    // 解析基本信息和所有字段
+    parseBasicEntityInfo(resultItem, jsonObj, deferCompoundFields);
     
-    // 解析类型特定属性
-    parseTypeSpecificProperties(resultItem, jsonObj, type);    
-    qDebug() << "MusicBrainzParser::parseEntity - Parsed entity:" << name 
-             << "(" << EntityUtils::entityTypeToString(type) << ") with" 
-             << resultItem->getDetailData().count() << "detail properties";
+    if (deferCompoundFields) {
+        // 复合字段及其整理结果在首次访问时解码
+        resultItem->setLazySource(jsonObj, &s_deferredFieldDecoder);
+    }
     
     return resultItem;
 }
@@ -141,59 +331,37 @@ QSharedPointer<ResultItem> MusicBrainzParser::parseEntity(const QJsonObject &jso
 
 EntityType MusicBrainzParser::detectEntityType(const QJsonObject &jsonObj)
 {
-    // 通过检查特定字段来判断实体类型
-    QStringList keys = jsonObj.keys();
-    
-    // Artist 特征字段
-    if (keys.contains("type") && keys.contains("sort-name") && 
-        (keys.contains("gender") || keys.contains("life-span"))) {
-        return EntityType::Artist;
-    }
-    
-    // Release 特征字段
-    if (keys.contains("status") && keys.contains("barcode") && 
-        (keys.contains("release-events") || keys.contains("media"))) {
-        return EntityType::Release;
-    }
-    
-    // Recording 特征字段
-    if (keys.contains("length") && keys.contains("artist-credit")) {
-        return EntityType::Recording;
-    }
-    
-    // ReleaseGroup 特征字段
-    if (keys.contains("primary-type") || keys.contains("first-release-date")) {
-        return EntityType::ReleaseGroup;
-    }
-    
-    // Work 特征字段
-    if (keys.contains("work-type") || keys.contains("language")) {
-        return EntityType::Work;
-    }
-    
-    // Label 特征字段
-    if (keys.contains("label-code") || keys.contains("type")) {
-        return EntityType::Label;
-    }
+    // 按规则表依次判断，每个特征字段最多查询一次（直接查询对象，不复制键列表）
+    quint32 probed = 0;
+    quint32 present = 0;
+    const auto has = [&](quint32 keys) {
+        for (quint32 pending = keys & ~probed; pending; pending &= pending - 1) {
+            const int bit = qCountTrailingZeroBits(pending);
+            if (jsonObj.contains(latin1(DETECTION_KEYS[std::size_t(bit)]))) {
+                present |= 1u << bit;
+            }
+        }
+        probed |= keys;
+        return present & keys;
+    };
     
-    // Area 特征字段
-    if (keys.contains("iso-3166-1-codes") || keys.contains("iso-3166-2-codes")) {
-        return EntityType::Area;
+    for (const DetectionRule &rule : DETECTION_RULES) {
+        if ((has(rule.required) & rule.required) == rule.required && (!rule.anyOf || has(rule.anyOf))) {
+            return rule.type;
+        }
     }
     
     // 如果无法明确判断，使用默认逻辑
-    if (keys.contains("title")) {
-        if (keys.contains("artist-credit")) {
-            return EntityType::Recording;
-        } else {
-            return EntityType::Work;
-        }
+    constexpr quint32 titleKey = detectionKey("title");
+    constexpr quint32 artistCreditKey = detectionKey("artist-credit");
+    if (has(titleKey)) {
+        return has(artistCreditKey) ? EntityType::Recording : EntityType::Work;
     }
     
     return EntityType::Unknown;
 }
 
-QVariant MusicBrainzParser::parseJsonValue(const QJsonValue &value)
+QVariant MusicBrainzParser::parseJsonValue(const QJsonValue &value, const QString &key)
 {
     switch (value.type()) {
         case QJsonValue::Bool:
@@ -201,19 +369,24 @@ QVariant MusicBrainzParser::parseJsonValue(const QJsonValue &value)
         case QJsonValue::Double:
             return value.toDouble();
         case QJsonValue::String:
-            return value.toString();
+            return internField(key, value.toString());
         case QJsonValue::Array: {
+            // 数组元素沿用数组的成员名（如secondary-types中的每个类型）
             QVariantList list;
             QJsonArray array = value.toArray();
+            list.reserve(array.size());
             for (const QJsonValue &item : array) {
-                list.append(parseJsonValue(item));
+                list.append(parseJsonValue(item, key));
             }
             return list;
         }
         case QJsonValue::Object: {
+            // 键名总是驻留，值按各自的成员名决定
             QVariantMap map;
-            QJsonObject obj = value.toObject();            for (auto it = obj.begin(); it != obj.end(); ++it) {
-                map[it.key()] = parseJsonValue(it.value());
+            QJsonObject obj = value.toObject();
+            for (auto it = obj.begin(); it != obj.end(); ++it) {
+                const QString memberKey = StringPool::instance().intern(it.key());
+                map.insert(memberKey, parseJsonValue(it.value(), memberKey));
             }
             return map;
         }
@@ -241,14 +414,44 @@ bool MusicBrainzParser::validateJsonData(const QByteArray &data)
     return doc.isObject();
 }
 
+bool MusicBrainzParser::parseRootObject(const QByteArray &data, QJsonObject *root, QString *error)
+{
+    if (data.isEmpty()) {
+        if (error) {
+            *error = "Empty response";
+        }
+        return false;
+    }
+    
+    QJsonParseError parseError;
+    const QJsonDocument doc = QJsonDocument::fromJson(data, &parseError);
+    
+    if (parseError.error != QJsonParseError::NoError) {
+        if (error) {
+            *error = parseError.errorString();
+        }
+        return false;
+    }
+    
+    if (!doc.isObject()) {
+        if (error) {
+            *error = "Response is not a JSON object";
+        }
+        return false;
+    }
+    
+    *root = doc.object();
+    return true;
+}
+
 QString MusicBrainzParser::checkForErrors(const QJsonObject &jsonObj)
 {
-    if (jsonObj.contains("error")) {
-        return jsonObj.value("error").toString();
+    if (jsonObj.contains(QStringLiteral("error"))) {
+        return jsonObj.value(QStringLiteral("error")).toString();
     }
     
-    if (jsonObj.contains("errors")) {
-        QJsonArray errors = jsonObj.value("errors").toArray();
+    if (jsonObj.contains(QStringLiteral("errors"))) {
+        QJsonArray errors = jsonObj.value(QStringLiteral("errors")).toArray();
         QStringList errorList;
         for (const QJsonValue &error : errors) {
             errorList.append(error.toString());
@@ -263,17 +466,30 @@ QString MusicBrainzParser::checkForErrors(const QJsonObject &jsonObj)
 // 内部解析方法
 // =============================================================================
 
-void MusicBrainzParser::parseBasicEntityInfo(QSharedPointer<ResultItem> &item, const QJsonObject &jsonObj)
+void MusicBrainzParser::parseBasicEntityInfo(QSharedPointer<ResultItem> &item, const QJsonObject &jsonObj,
+                                             bool deferCompoundFields)
 {
     // 通用字段
-    item->setDisambiguation(getJsonString(jsonObj, "disambiguation"));
+    item->setDisambiguation(getJsonString(jsonObj, QStringLiteral("disambiguation")));
     
     // 评分
-    if (jsonObj.contains("score")) {
-        item->setScore(getJsonInt(jsonObj, "score"));
+    if (jsonObj.contains(QStringLiteral("score"))) {
+        item->setScore(getJsonInt(jsonObj, QStringLiteral("score")));
     }
     
-    // 递归解析所有字段为detail properties
+    // 按实体类型选择编译时生成的字段解析函数
+    visitEntitySchema(item->getType(), [&](auto schema) {
+        parseEntityFields<decltype(schema)::value>(item, jsonObj, deferCompoundFields);
+    });
+}
+
+template <EntityType Type>
+void MusicBrainzParser::parseEntityFields(QSharedPointer<ResultItem> &item, const QJsonObject &jsonObj,
+                                          bool deferCompoundFields)
+{
+    static const auto detailKeys = makeDetailKeys<Type>();
+    
+    // 只遍历一次对象的键，复合字段按字段表直接分派到专用解析
     for (auto it = jsonObj.begin(); it != jsonObj.end(); ++it) {
         const QString &key = it.key();
         const QJsonValue &value = it.value();
@@ -283,196 +499,85 @@ void MusicBrainzParser::parseBasicEntityInfo(QSharedPointer<ResultItem> &item, c
             continue;
         }
         
+        // 延迟模式下复合字段留给解码器
+        if (deferCompoundFields && isDeferredValue(value)) {
+            continue;
+        }
+        
+        // 常用标量字段直接写入定长记录
+        if (value.isString() && item->setRecordText(key, internField(key, value.toString()))) {
+            continue;
+        }
+        if (value.isDouble() && item->setRecordNumber(key, value.toDouble())) {
+            continue;
+        }
+        
+        if (const FieldSpec *spec = lookupFieldSpec<Type>(key)) {
+            const auto index = std::size_t(spec - EntitySchema<Type>::fields.data());
+            item->setDetailProperty(detailKeys[index], parseCompoundField(*spec, value));
+            
+            // 同名保存时整理结果取代原始值，改名保存时原始值仍按通用方式保留
+            if (spec->detailKey == spec->jsonKey) {
+                continue;
+            }
+        }
+        
         // 转换JSON值为QVariant
-        QVariant variantValue = parseJsonValue(value);
+        QVariant variantValue = parseJsonValue(value, key);
         item->setDetailProperty(key, variantValue);
     }
 }
 
-void MusicBrainzParser::parseTypeSpecificProperties(QSharedPointer<ResultItem> &item, const QJsonObject &jsonObj, EntityType type)
-{
-    switch (type) {
-        case EntityType::Artist:
-            parseArtistProperties(item, jsonObj);
-            break;
-        case EntityType::Release:
-            parseReleaseProperties(item, jsonObj);
-            break;
-        case EntityType::Recording:
-            parseRecordingProperties(item, jsonObj);
-            break;
-        case EntityType::ReleaseGroup:
-            parseReleaseGroupProperties(item, jsonObj);
-            break;
-        case EntityType::Work:
-            parseWorkProperties(item, jsonObj);
-            break;
-        case EntityType::Label:
-            parseLabelProperties(item, jsonObj);
-            break;
-        case EntityType::Area:
-            parseAreaProperties(item, jsonObj);
-            break;
-        default:
-            break;
-    }
-}
-
-void MusicBrainzParser::parseArtistProperties(QSharedPointer<ResultItem> &item, const QJsonObject &jsonObj)
-{
-    // 解析生命周期
-    if (jsonObj.contains("life-span")) {
-        QJsonObject lifeSpanObj = jsonObj.value("life-span").toObject();
-        QVariantMap lifeSpan = parseLifeSpan(lifeSpanObj);
-        item->setDetailProperty("life_span", lifeSpan);
-    }
-    
-    // 解析地区
-    if (jsonObj.contains("area")) {
-        QJsonObject areaObj = jsonObj.value("area").toObject();
-        QVariantMap area = parseArea(areaObj);
-        item->setDetailProperty("area_info", area);
-    }
-    
-    // 解析开始地区
-    if (jsonObj.contains("begin-area")) {
-        QJsonObject beginAreaObj = jsonObj.value("begin-area").toObject();
-        QVariantMap beginArea = parseArea(beginAreaObj);
-        item->setDetailProperty("begin_area", beginArea);
-    }
-    
-    // 解析结束地区
-    if (jsonObj.contains("end-area")) {
-        QJsonObject endAreaObj = jsonObj.value("end-area").toObject();
-        QVariantMap endArea = parseArea(endAreaObj);
-        item->setDetailProperty("end_area", endArea);
-    }
-    
-    // 解析标签
-    if (jsonObj.contains("tags")) {
-        QJsonArray tagsArray = jsonObj.value("tags").toArray();
-        QVariantList tags = parseTags(tagsArray);
-        item->setDetailProperty("tags", tags); // 使用统一键名
-    }
-    
-    // 解析别名
-    if (jsonObj.contains("aliases")) {
-        QJsonArray aliasesArray = jsonObj.value("aliases").toArray();
-        QVariantList aliases = parseAliases(aliasesArray);
-        item->setDetailProperty("aliases", aliases); // 使用统一键名
-    }
-      // 使用通用解析函数处理各种子实体列表
-    parseCommonSubEntities(item, jsonObj);
-    
-    // 解析关系
-    if (jsonObj.contains("relations")) {
-        QJsonArray relationsArray = jsonObj.value("relations").toArray();
-        qDebug() << "Artist relations found:" << relationsArray.size() << "for" << item->getName();
-        QVariantList relationships = parseRelationships(relationsArray);
-        item->setDetailProperty("relationships", relationships);
-        qDebug() << "Artist relationships stored:" << relationships.count();
-    } else {
-        qDebug() << "No relations found for artist:" << item->getName();
-    }
-}
-
-void MusicBrainzParser::parseReleaseProperties(QSharedPointer<ResultItem> &item, const QJsonObject &jsonObj)
-{
-    // 解析艺术家信息
-    parseArtistCreditProperty(item, jsonObj);
-    
-    // 解析发行事件
-    if (jsonObj.contains("release-events")) {
-        QJsonArray releaseEventsArray = jsonObj.value("release-events").toArray();
-        QVariantList releaseEvents = parseReleaseEvents(releaseEventsArray);
-        item->setDetailProperty("release-events", releaseEvents);
-    }
-    
-    // 解析媒体
-    if (jsonObj.contains("media")) {
-        QJsonArray mediaArray = jsonObj.value("media").toArray();
-        QVariantList media = parseMedia(mediaArray);
-        item->setDetailProperty("media", media);
-    }
-    
-    // 解析封面艺术档案
-    if (jsonObj.contains("cover-art-archive")) {
-        QJsonObject coverArtObj = jsonObj.value("cover-art-archive").toObject();
-        QVariantMap coverArt = parseCoverArtArchive(coverArtObj);
-        item->setDetailProperty("cover-art-archive", coverArt);
-    }
-    
-    // 解析文本表示
-    if (jsonObj.contains("text-representation")) {
-        QJsonObject textRepObj = jsonObj.value("text-representation").toObject();
-        QVariantMap textRep = parseTextRepresentation(textRepObj);
-        item->setDetailProperty("text-representation", textRep);
-    }
-    
-    // 使用通用函数解析标签、别名和关系
-    parseCommonProperties(item, jsonObj);
-}
-
-void MusicBrainzParser::parseRecordingProperties(QSharedPointer<ResultItem> &item, const QJsonObject &jsonObj)
-{
-    // 解析艺术家信息
-    parseArtistCreditProperty(item, jsonObj);
-    
-    // 使用通用函数解析子实体和通用属性
-    parseCommonSubEntities(item, jsonObj);
-    parseCommonProperties(item, jsonObj);
-}
-
-void MusicBrainzParser::parseReleaseGroupProperties(QSharedPointer<ResultItem> &item, const QJsonObject &jsonObj)
-{
-    // 解析艺术家信息
-    parseArtistCreditProperty(item, jsonObj);
-    
-    // 使用通用函数解析子实体和通用属性
-    parseCommonSubEntities(item, jsonObj);
-    parseCommonProperties(item, jsonObj);
-}
-
-void MusicBrainzParser::parseWorkProperties(QSharedPointer<ResultItem> &item, const QJsonObject &jsonObj)
-{
-    // 使用通用函数解析子实体和通用属性
-    parseCommonSubEntities(item, jsonObj);
-    parseCommonProperties(item, jsonObj);
-}
-
-void MusicBrainzParser::parseLabelProperties(QSharedPointer<ResultItem> &item, const QJsonObject &jsonObj)
-{
-    // 使用通用函数解析子实体和通用属性
-    parseCommonSubEntities(item, jsonObj);
-    parseCommonProperties(item, jsonObj);
-}
-
-void MusicBrainzParser::parseAreaProperties(QSharedPointer<ResultItem> &item, const QJsonObject &jsonObj)
-{
-    // 使用通用函数解析通用属性
-    parseCommonProperties(item, jsonObj);
+QVariant MusicBrainzParser::parseCompoundField(const FieldSpec &spec, const QJsonValue &value)
+{
+    switch (spec.kind) {
+        case FieldKind::LifeSpan:
+            return parseLifeSpan(value.toObject());
+        case FieldKind::Area:
+            return parseArea(value.toObject());
+        case FieldKind::ArtistCredit:
+            return parseArtistCredits(value.toArray());
+        case FieldKind::ReleaseEvents:
+            return parseReleaseEvents(value.toArray());
+        case FieldKind::Media:
+            return parseMedia(value.toArray());
+        case FieldKind::CoverArtArchive:
+            return parseCoverArtArchive(value.toObject());
+        case FieldKind::TextRepresentation:
+            return parseTextRepresentation(value.toObject());
+        case FieldKind::Tags:
+            return parseTags(value.toArray());
+        case FieldKind::Aliases:
+            return parseAliases(value.toArray());
+        case FieldKind::Relations:
+            return parseRelationships(value.toArray());
+        case FieldKind::SubEntities:
+            return parseSubEntityList(value.toArray(), spec.subEntityType);
+    }
+    return QVariant();
 }
 
 QVariantList MusicBrainzParser::parseArtistCredits(const QJsonArray &artistCredits)
 {
     QVariantList result;
+    result.reserve(artistCredits.size());
     
     for (const QJsonValue &value : artistCredits) {
         if (value.isObject()) {
             QJsonObject creditObj = value.toObject();
             QVariantMap credit;
             
-            credit["name"] = getJsonString(creditObj, "name");
-            credit["joinphrase"] = getJsonString(creditObj, "joinphrase");
+            credit[QStringLiteral("name")] = getJsonString(creditObj, QStringLiteral("name"));
+            credit[QStringLiteral("joinphrase")] = getJsonString(creditObj, QStringLiteral("joinphrase"));
             
-            if (creditObj.contains("artist")) {
-                QJsonObject artistObj = creditObj.value("artist").toObject();
+            if (creditObj.contains(QStringLiteral("artist"))) {
+                QJsonObject artistObj = creditObj.value(QStringLiteral("artist")).toObject();
                 QVariantMap artist;
-                artist["id"] = getJsonString(artistObj, "id");
-                artist["name"] = getJsonString(artistObj, "name");
-                artist["sort-name"] = getJsonString(artistObj, "sort-name");
-                artist["type"] = getJsonString(artistObj, "type");
-                credit["artist"] = artist;
+                artist[QStringLiteral("id")] = getJsonString(artistObj, QStringLiteral("id"));
+                artist[QStringLiteral("name")] = getJsonString(artistObj, QStringLiteral("name"));
+                artist[QStringLiteral("sort-name")] = getJsonString(artistObj, QStringLiteral("sort-name"));
+                artist[QStringLiteral("type")] = getJsonString(artistObj, QStringLiteral("type"));
+                credit[QStringLiteral("artist")] = artist;
             }
             
             result.append(credit);
@@ -485,6 +590,7 @@ QVariantList MusicBrainzParser::parseArtistCredits(const QJsonArray &artistCredi
 QVariantList MusicBrainzParser::parseRelationships(const QJsonArray &relations)
 {
     QVariantList result;
+    result.reserve(relations.size());
     
     for (const QJsonValue &value : relations) {
         if (value.isObject()) {
@@ -492,77 +598,78 @@ QVariantList MusicBrainzParser::parseRelationships(const QJsonArray &relations)
             QVariantMap relation;
             
             // 基本关系信息
-            relation.insert("type", getJsonString(relationObj, "type"));
-            relation.insert("type-id", getJsonString(relationObj, "type-id"));
-            relation.insert("direction", getJsonString(relationObj, "direction"));
-            relation.insert("begin", getJsonString(relationObj, "begin"));
-            relation.insert("end", getJsonString(relationObj, "end"));
-            relation.insert("ended", getJsonBool(relationObj, "ended"));
+            relation.insert(QStringLiteral("type"), getJsonString(relationObj, QStringLiteral("type")));
+            relation.insert(QStringLiteral("type-id"), getJsonString(relationObj, QStringLiteral("type-id")));
+            relation.insert(QStringLiteral("direction"), getJsonString(relationObj, QStringLiteral("direction")));
+            relation.insert(QStringLiteral("begin"), getJsonString(relationObj, QStringLiteral("begin")));
+            relation.insert(QStringLiteral("end"), getJsonString(relationObj, QStringLiteral("end")));
+            relation.insert(QStringLiteral("ended"), getJsonBool(relationObj, QStringLiteral("ended")));
             
             // 解析目标实体
-            if (relationObj.contains("artist")) {
-                QJsonObject targetObj = relationObj.value("artist").toObject();
+            if (relationObj.contains(QStringLiteral("artist"))) {
+                QJsonObject targetObj = relationObj.value(QStringLiteral("artist")).toObject();
                 QVariantMap target;
-                target.insert("id", getJsonString(targetObj, "id"));
-                target.insert("name", getJsonString(targetObj, "name"));
-                target.insert("sort-name", getJsonString(targetObj, "sort-name"));
-                target.insert("disambiguation", getJsonString(targetObj, "disambiguation"));
-                relation.insert("artist", target);
+                target.insert(QStringLiteral("id"), getJsonString(targetObj, QStringLiteral("id")));
+                target.insert(QStringLiteral("name"), getJsonString(targetObj, QStringLiteral("name")));
+                target.insert(QStringLiteral("sort-name"), getJsonString(targetObj, QStringLiteral("sort-name")));
+                target.insert(QStringLiteral("disambiguation"), getJsonString(targetObj, QStringLiteral("disambiguation")));
+                relation.insert(QStringLiteral("artist"), target);
             }
-            else if (relationObj.contains("release")) {
-                QJsonObject targetObj = relationObj.value("release").toObject();
+            else if (relationObj.contains(QStringLiteral("release"))) {
+                QJsonObject targetObj = relationObj.value(QStringLiteral("release")).toObject();
                 QVariantMap target;
-                target.insert("id", getJsonString(targetObj, "id"));
-                target.insert("title", getJsonString(targetObj, "title"));
-                target.insert("status", getJsonString(targetObj, "status"));
-                target.insert("disambiguation", getJsonString(targetObj, "disambiguation"));
-                relation.insert("release", target);
+                target.insert(QStringLiteral("id"), getJsonString(targetObj, QStringLiteral("id")));
+                target.insert(QStringLiteral("title"), getJsonString(targetObj, QStringLiteral("title")));
+                target.insert(QStringLiteral("status"), getJsonString(targetObj, QStringLiteral("status")));
+                target.insert(QStringLiteral("disambiguation"), getJsonString(targetObj, QStringLiteral("disambiguation")));
+                relation.insert(QStringLiteral("release"), target);
             }
-            else if (relationObj.contains("release-group")) {
-                QJsonObject targetObj = relationObj.value("release-group").toObject();
+            else if (relationObj.contains(QStringLiteral("release-group"))) {
+                QJsonObject targetObj = relationObj.value(QStringLiteral("release-group")).toObject();
                 QVariantMap target;
-                target.insert("id", getJsonString(targetObj, "id"));
-                target.insert("title", getJsonString(targetObj, "title"));
-                target.insert("primary-type", getJsonString(targetObj, "primary-type"));
-                target.insert("disambiguation", getJsonString(targetObj, "disambiguation"));
-                relation.insert("release-group", target);
+                target.insert(QStringLiteral("id"), getJsonString(targetObj, QStringLiteral("id")));
+                target.insert(QStringLiteral("title"), getJsonString(targetObj, QStringLiteral("title")));
+                target.insert(QStringLiteral("primary-type"), getJsonString(targetObj, QStringLiteral("primary-type")));
+                target.insert(QStringLiteral("disambiguation"), getJsonString(targetObj, QStringLiteral("disambiguation")));
+                relation.insert(QStringLiteral("release-group"), target);
             }
-            else if (relationObj.contains("recording")) {
-                QJsonObject targetObj = relationObj.value("recording").toObject();
+            else if (relationObj.contains(QStringLiteral("recording"))) {
+                QJsonObject targetObj = relationObj.value(QStringLiteral("recording")).toObject();
                 QVariantMap target;
-                target.insert("id", getJsonString(targetObj, "id"));
-                target.insert("title", getJsonString(targetObj, "title"));
-                target.insert("length", getJsonInt(targetObj, "length"));
-                target.insert("disambiguation", getJsonString(targetObj, "disambiguation"));
-                relation.insert("recording", target);
+                target.insert(QStringLiteral("id"), getJsonString(targetObj, QStringLiteral("id")));
+                target.insert(QStringLiteral("title"), getJsonString(targetObj, QStringLiteral("title")));
+                target.insert(QStringLiteral("length"), getJsonInt(targetObj, QStringLiteral("length")));
+                target.insert(QStringLiteral("disambiguation"), getJsonString(targetObj, QStringLiteral("disambiguation")));
+                relation.insert(QStringLiteral("recording"), target);
             }
-            else if (relationObj.contains("work")) {
-                QJsonObject targetObj = relationObj.value("work").toObject();
+            else if (relationObj.contains(QStringLiteral("work"))) {
+                QJsonObject targetObj = relationObj.value(QStringLiteral("work")).toObject();
                 QVariantMap target;
-                target.insert("id", getJsonString(targetObj, "id"));
-                target.insert("title", getJsonString(targetObj, "title"));
-                target.insert("type", getJsonString(targetObj, "type"));
-                target.insert("disambiguation", getJsonString(targetObj, "disambiguation"));
-                relation.insert("work", target);
+                target.insert(QStringLiteral("id"), getJsonString(targetObj, QStringLiteral("id")));
+                target.insert(QStringLiteral("title"), getJsonString(targetObj, QStringLiteral("title")));
+                target.insert(QStringLiteral("type"), getJsonString(targetObj, QStringLiteral("type")));
+                target.insert(QStringLiteral("disambiguation"), getJsonString(targetObj, QStringLiteral("disambiguation")));
+                relation.insert(QStringLiteral("work"), target);
             }
-            else if (relationObj.contains("url")) {
-                QJsonObject targetObj = relationObj.value("url").toObject();
+            else if (relationObj.contains(QStringLiteral("url"))) {
+                QJsonObject targetObj = relationObj.value(QStringLiteral("url")).toObject();
                 QVariantMap target;
-                target.insert("id", getJsonString(targetObj, "id"));
-                target.insert("resource", getJsonString(targetObj, "resource"));
-                relation.insert("url", target);
+                target.insert(QStringLiteral("id"), getJsonString(targetObj, QStringLiteral("id")));
+                target.insert(QStringLiteral("resource"), getJsonString(targetObj, QStringLiteral("resource")));
+                relation.insert(QStringLiteral("url"), target);
             }
             
             // 解析属性
-            if (relationObj.contains("attributes")) {
-                QJsonArray attributesArray = relationObj.value("attributes").toArray();
+            if (relationObj.contains(QStringLiteral("attributes"))) {
+                QJsonArray attributesArray = relationObj.value(QStringLiteral("attributes")).toArray();
                 QVariantList attributes;
+                attributes.reserve(attributesArray.size());
                 for (const QJsonValue &attrValue : attributesArray) {
                     if (attrValue.isString()) {
                         attributes.append(attrValue.toString());
                     }
                 }
-                relation.insert("attributes", attributes);
+                relation.insert(QStringLiteral("attributes"), attributes);
             }
             
             result.append(relation);
@@ -575,48 +682,50 @@ QVariantList MusicBrainzParser::parseRelationships(const QJsonArray &relations)
 QVariantList MusicBrainzParser::parseMedia(const QJsonArray &media)
 {
     QVariantList result;
+    result.reserve(media.size());
     
     for (const QJsonValue &value : media) {
         if (value.isObject()) {
             QJsonObject mediaObj = value.toObject();
             QVariantMap medium;
             
-            medium.insert("position", getJsonInt(mediaObj, "position"));
-            medium.insert("title", getJsonString(mediaObj, "title"));
-            medium.insert("format", getJsonString(mediaObj, "format"));
-            medium.insert("format-id", getJsonString(mediaObj, "format-id"));
-            medium.insert("track-count", getJsonInt(mediaObj, "track-count"));
+            medium.insert(QStringLiteral("position"), getJsonInt(mediaObj, QStringLiteral("position")));
+            medium.insert(QStringLiteral("title"), getJsonString(mediaObj, QStringLiteral("title")));
+            medium.insert(QStringLiteral("format"), getJsonString(mediaObj, QStringLiteral("format")));
+            medium.insert(QStringLiteral("format-id"), getJsonString(mediaObj, QStringLiteral("format-id")));
+            medium.insert(QStringLiteral("track-count"), getJsonInt(mediaObj, QStringLiteral("track-count")));
             
             // 解析曲目列表
-            if (mediaObj.contains("tracks")) {
-                QJsonArray tracksArray = mediaObj.value("tracks").toArray();
+            if (mediaObj.contains(QStringLiteral("tracks"))) {
+                QJsonArray tracksArray = mediaObj.value(QStringLiteral("tracks")).toArray();
                 QVariantList tracks;
+                tracks.reserve(tracksArray.size());
                 
                 for (const QJsonValue &trackValue : tracksArray) {
                     if (trackValue.isObject()) {
                         QJsonObject trackObj = trackValue.toObject();
                         QVariantMap track;
                         
-                        track.insert("id", getJsonString(trackObj, "id"));
-                        track.insert("position", getJsonInt(trackObj, "position"));
-                        track.insert("title", getJsonString(trackObj, "title"));
-                        track.insert("length", getJsonInt(trackObj, "length"));
-                        track.insert("number", getJsonString(trackObj, "number"));
+                        track.insert(QStringLiteral("id"), getJsonString(trackObj, QStringLiteral("id")));
+                        track.insert(QStringLiteral("position"), getJsonInt(trackObj, QStringLiteral("position")));
+                        track.insert(QStringLiteral("title"), getJsonString(trackObj, QStringLiteral("title")));
+                        track.insert(QStringLiteral("length"), getJsonInt(trackObj, QStringLiteral("length")));
+                        track.insert(QStringLiteral("number"), getJsonString(trackObj, QStringLiteral("number")));
                         
-                        if (trackObj.contains("artist-credit")) {
-                            QJsonArray artistCreditArray = trackObj.value("artist-credit").toArray();
-                            track.insert("artist-credit", parseArtistCredits(artistCreditArray));
+                        if (trackObj.contains(QStringLiteral("artist-credit"))) {
+                            QJsonArray artistCreditArray = trackObj.value(QStringLiteral("artist-credit")).toArray();
+                            track.insert(QStringLiteral("artist-credit"), parseArtistCredits(artistCreditArray));
                         }
                         
-                        if (trackObj.contains("recording")) {
-                            track.insert("recording", parseJsonValue(trackObj.value("recording")));
+                        if (trackObj.contains(QStringLiteral("recording"))) {
+                            track.insert(QStringLiteral("recording"), parseJsonValue(trackObj.value(QStringLiteral("recording"))));
                         }
                         
                         tracks.append(track);
                     }
                 }
                 
-                medium.insert("tracks", tracks);
+                medium.insert(QStringLiteral("tracks"), tracks);
             }
             
             result.append(medium);
@@ -629,14 +738,16 @@ QVariantList MusicBrainzParser::parseMedia(const QJsonArray &media)
 QVariantList MusicBrainzParser::parseTags(const QJsonArray &tags)
 {
     QVariantList result;
+    result.reserve(tags.size());
     
     for (const QJsonValue &value : tags) {
         if (value.isObject()) {
             QJsonObject tagObj = value.toObject();
             QVariantMap tag;
             
-            tag.insert("count", getJsonInt(tagObj, "count"));
-            tag.insert("name", getJsonString(tagObj, "name"));
+            tag.insert(QStringLiteral("count"), getJsonInt(tagObj, QStringLiteral("count")));
+            // 标签名在不同实体间大量重复
+            tag.insert(QStringLiteral("name"), StringPool::instance().intern(getJsonString(tagObj, QStringLiteral("name"))));
             
             result.append(tag);
         }
@@ -648,21 +759,22 @@ QVariantList MusicBrainzParser::parseTags(const QJsonArray &tags)
 QVariantList MusicBrainzParser::parseAliases(const QJsonArray &aliases)
 {
     QVariantList result;
+    result.reserve(aliases.size());
     
     for (const QJsonValue &value : aliases) {
         if (value.isObject()) {
             QJsonObject aliasObj = value.toObject();
             QVariantMap alias;
             
-            alias.insert("name", getJsonString(aliasObj, "name"));
-            alias.insert("sort-name", getJsonString(aliasObj, "sort-name"));
-            alias.insert("type", getJsonString(aliasObj, "type"));
-            alias.insert("type-id", getJsonString(aliasObj, "type-id"));
-            alias.insert("locale", getJsonString(aliasObj, "locale"));
-            alias.insert("primary", getJsonBool(aliasObj, "primary"));
-            alias.insert("begin", getJsonString(aliasObj, "begin"));
-            alias.insert("end", getJsonString(aliasObj, "end"));
-            alias.insert("ended", getJsonBool(aliasObj, "ended"));
+            alias.insert(QStringLiteral("name"), getJsonString(aliasObj, QStringLiteral("name")));
+            alias.insert(QStringLiteral("sort-name"), getJsonString(aliasObj, QStringLiteral("sort-name")));
+            alias.insert(QStringLiteral("type"), getJsonString(aliasObj, QStringLiteral("type")));
+            alias.insert(QStringLiteral("type-id"), getJsonString(aliasObj, QStringLiteral("type-id")));
+            alias.insert(QStringLiteral("locale"), getJsonString(aliasObj, QStringLiteral("locale")));
+            alias.insert(QStringLiteral("primary"), getJsonBool(aliasObj, QStringLiteral("primary")));
+            alias.insert(QStringLiteral("begin"), getJsonString(aliasObj, QStringLiteral("begin")));
+            alias.insert(QStringLiteral("end"), getJsonString(aliasObj, QStringLiteral("end")));
+            alias.insert(QStringLiteral("ended"), getJsonBool(aliasObj, QStringLiteral("ended")));
             
             result.append(alias);
         }
@@ -675,9 +787,9 @@ QVariantMap MusicBrainzParser::parseLifeSpan(const QJsonObject &lifeSpan)
 {
     QVariantMap result;
     
-    result.insert("begin", getJsonString(lifeSpan, "begin"));
-    result.insert("end", getJsonString(lifeSpan, "end"));
-    result.insert("ended", getJsonBool(lifeSpan, "ended"));
+    result.insert(QStringLiteral("begin"), getJsonString(lifeSpan, QStringLiteral("begin")));
+    result.insert(QStringLiteral("end"), getJsonString(lifeSpan, QStringLiteral("end")));
+    result.insert(QStringLiteral("ended"), getJsonBool(lifeSpan, QStringLiteral("ended")));
     
     return result;
 }
@@ -686,19 +798,19 @@ QVariantMap MusicBrainzParser::parseArea(const QJsonObject &area)
 {
     QVariantMap result;
     
-    result.insert("id", getJsonString(area, "id"));
-    result.insert("name", getJsonString(area, "name"));
-    result.insert("sort-name", getJsonString(area, "sort-name"));
-    result.insert("type", getJsonString(area, "type"));
-    result.insert("type-id", getJsonString(area, "type-id"));
+    result.insert(QStringLiteral("id"), getJsonString(area, QStringLiteral("id")));
+    result.insert(QStringLiteral("name"), getJsonString(area, QStringLiteral("name")));
+    result.insert(QStringLiteral("sort-name"), getJsonString(area, QStringLiteral("sort-name")));
+    result.insert(QStringLiteral("type"), getJsonString(area, QStringLiteral("type")));
+    result.insert(QStringLiteral("type-id"), getJsonString(area, QStringLiteral("type-id")));
     
     // ISO 代码
-    if (area.contains("iso-3166-1-codes")) {
-        result.insert("iso-3166-1-codes", parseJsonValue(area.value("iso-3166-1-codes")));
+    if (area.contains(QStringLiteral("iso-3166-1-codes"))) {
+        result.insert(QStringLiteral("iso-3166-1-codes"), parseJsonValue(area.value(QStringLiteral("iso-3166-1-codes"))));
     }
     
-    if (area.contains("iso-3166-2-codes")) {
-        result.insert("iso-3166-2-codes", parseJsonValue(area.value("iso-3166-2-codes")));
+    if (area.contains(QStringLiteral("iso-3166-2-codes"))) {
+        result.insert(QStringLiteral("iso-3166-2-codes"), parseJsonValue(area.value(QStringLiteral("iso-3166-2-codes"))));
     }
     
     return result;
@@ -707,17 +819,18 @@ QVariantMap MusicBrainzParser::parseArea(const QJsonObject &area)
 QVariantList MusicBrainzParser::parseReleaseEvents(const QJsonArray &releaseEvents)
 {
     QVariantList result;
+    result.reserve(releaseEvents.size());
     
     for (const QJsonValue &value : releaseEvents) {
         if (value.isObject()) {
             QJsonObject eventObj = value.toObject();
             QVariantMap event;
             
-            event.insert("date", getJsonString(eventObj, "date"));
+            event.insert(QStringLiteral("date"), getJsonString(eventObj, QStringLiteral("date")));
             
-            if (eventObj.contains("area")) {
-                QJsonObject areaObj = eventObj.value("area").toObject();
-                event.insert("area", parseArea(areaObj));
+            if (eventObj.contains(QStringLiteral("area"))) {
+                QJsonObject areaObj = eventObj.value(QStringLiteral("area")).toObject();
+                event.insert(QStringLiteral("area"), parseArea(areaObj));
             }
             
             result.append(event);
@@ -731,10 +844,10 @@ QVariantMap MusicBrainzParser::parseCoverArtArchive(const QJsonObject &coverArtA
 {
     QVariantMap result;
     
-    result.insert("artwork", getJsonBool(coverArtArchive, "artwork"));
-    result.insert("count", getJsonInt(coverArtArchive, "count"));
-    result.insert("front", getJsonBool(coverArtArchive, "front"));
-    result.insert("back", getJsonBool(coverArtArchive, "back"));
+    result.insert(QStringLiteral("artwork"), getJsonBool(coverArtArchive, QStringLiteral("artwork")));
+    result.insert(QStringLiteral("count"), getJsonInt(coverArtArchive, QStringLiteral("count")));
+    result.insert(QStringLiteral("front"), getJsonBool(coverArtArchive, QStringLiteral("front")));
+    result.insert(QStringLiteral("back"), getJsonBool(coverArtArchive, QStringLiteral("back")));
     
     return result;
 }
@@ -743,8 +856,8 @@ QVariantMap MusicBrainzParser::parseTextRepresentation(const QJsonObject &textRe
 {
     QVariantMap result;
     
-    result.insert("language", getJsonString(textRepresentation, "language"));
-    result.insert("script", getJsonString(textRepresentation, "script"));
+    result.insert(QStringLiteral("language"), getJsonString(textRepresentation, QStringLiteral("language")));
+    result.insert(QStringLiteral("script"), getJsonString(textRepresentation, QStringLiteral("script")));
     
     return result;
 }
@@ -755,12 +868,40 @@ QVariantMap MusicBrainzParser::parseTextRepresentation(const QJsonObject &textRe
 
 QString MusicBrainzParser::getJsonString(const QJsonObject &obj, const QString &key, const QString &defaultValue)
 {
-    if (obj.contains(key) && obj.value(key).isString()) {
-        return obj.value(key).toString();
+    const QJsonValue value = obj.value(key);
+    if (value.isString()) {
+        return internField(key, value.toString());
     }
     return defaultValue;
 }
 
+QString MusicBrainzParser::internField(const QString &key, const QString &value)
+{
+    // 取值范围很小、在实体间大量重复的字段；关系类型和别名类型都在type中
+    static const QSet<QString> internedFields = {
+        QStringLiteral("type"),
+        QStringLiteral("primary-type"),
+        QStringLiteral("secondary-types"),
+        QStringLiteral("status"),
+        QStringLiteral("country"),
+        QStringLiteral("language"),
+        QStringLiteral("script"),
+        QStringLiteral("gender"),
+        QStringLiteral("format"),
+        QStringLiteral("direction"),
+        QStringLiteral("target-type"),
+    };
+
+    if (!internedFields.contains(key)) {
+        return value;
+    }
+    // 这些字段的值通常是短文本，万一出现MBID也不驻留
+    if (value.size() == Mbid::STRING_LENGTH && Mbid::isValid(value)) {
+        return value;
+    }
+    return StringPool::instance().intern(value);
+}
+
 int MusicBrainzParser::getJsonInt(const QJsonObject &obj, const QString &key, int defaultValue)
 {
     if (obj.contains(key)) {
@@ -803,66 +944,10 @@ QJsonObject MusicBrainzParser::getJsonObject(const QJsonObject &obj, const QStri
     return QJsonObject();
 }
 
-void MusicBrainzParser::parseCommonSubEntities(QSharedPointer<ResultItem> &item, const QJsonObject &jsonObj) {
-    // 定义需要解析的子实体映射
-    static const QMap<QString, EntityType> subEntityMappings = {
-        {"recordings", EntityType::Recording},
-        {"releases", EntityType::Release},
-        {"release-groups", EntityType::ReleaseGroup},
-        {"works", EntityType::Work}
-    };
-    
-    // 遍历并解析所有存在的子实体列表
-    for (auto it = subEntityMappings.begin(); it != subEntityMappings.end(); ++it) {
-        const QString &arrayKey = it.key();
-        const EntityType &entityType = it.value();
-        
-        if (jsonObj.contains(arrayKey)) {
-            QVariantList subEntities = parseSubEntityList(jsonObj, arrayKey, entityType);
-            item->setDetailProperty(arrayKey, subEntities);
-        }
-    }
-}
-
-void MusicBrainzParser::parseCommonProperties(QSharedPointer<ResultItem> &item, const QJsonObject &jsonObj) {
-    // 解析标签
-    if (jsonObj.contains("tags")) {
-        QJsonArray tagsArray = jsonObj.value("tags").toArray();
-        QVariantList tags = parseTags(tagsArray);
-        item->setDetailProperty("tags", tags);
-    }
-    
-    // 解析别名
-    if (jsonObj.contains("aliases")) {
-        QJsonArray aliasesArray = jsonObj.value("aliases").toArray();
-        QVariantList aliases = parseAliases(aliasesArray);
-        item->setDetailProperty("aliases", aliases);
-    }
-    
-    // 解析关系
-    if (jsonObj.contains("relations")) {
-        QJsonArray relationsArray = jsonObj.value("relations").toArray();
-        QVariantList relationships = parseRelationships(relationsArray);
-        item->setDetailProperty("relationships", relationships);
-    }
-}
-
-void MusicBrainzParser::parseArtistCreditProperty(QSharedPointer<ResultItem> &item, const QJsonObject &jsonObj) {    if (jsonObj.contains("artist-credit")) {
-        QJsonArray artistCreditArray = jsonObj.value("artist-credit").toArray();
-        QVariantList artistCredits = parseArtistCredits(artistCreditArray);
-        item->setDetailProperty("artist-credits", artistCredits);
-    }
-}
-
-QVariantList MusicBrainzParser::parseSubEntityList(const QJsonObject &jsonObj, const QString &arrayKey, EntityType entityType)
+QVariantList MusicBrainzParser::parseSubEntityList(const QJsonArray &entityArray, EntityType entityType)
 {
     QVariantList result;
-    
-    if (!jsonObj.contains(arrayKey)) {
-        return result;
-    }
-    
-    QJsonArray entityArray = jsonObj.value(arrayKey).toArray();
+    result.reserve(entityArray.size());
     
     for (const QJsonValue &value : entityArray) {
         if (value.isObject()) {
@@ -872,36 +957,36 @@ QVariantList MusicBrainzParser::parseSubEntityList(const QJsonObject &jsonObj, c
             QVariantMap entityInfo;
             
             // 基本字段
-            entityInfo.insert("id", getJsonString(entityObj, "id"));
-            entityInfo.insert("name", getJsonString(entityObj, "name"));
+            entityInfo.insert(QStringLiteral("id"), getJsonString(entityObj, QStringLiteral("id")));
+            entityInfo.insert(QStringLiteral("name"), getJsonString(entityObj, QStringLiteral("name")));
             
             // 对于某些实体类型，name字段可能叫title
-            if (entityInfo.value("name").toString().isEmpty()) {
-                entityInfo.insert("name", getJsonString(entityObj, "title"));
+            if (entityInfo.value(QStringLiteral("name")).toString().isEmpty()) {
+                entityInfo.insert(QStringLiteral("name"), getJsonString(entityObj, QStringLiteral("title")));
             }
             
-            entityInfo.insert("disambiguation", getJsonString(entityObj, "disambiguation"));
+            entityInfo.insert(QStringLiteral("disambiguation"), getJsonString(entityObj, QStringLiteral("disambiguation")));
             
             // 根据实体类型添加特定字段
             switch (entityType) {
             case EntityType::Recording:
-                entityInfo.insert("length", getJsonInt(entityObj, "length"));
+                entityInfo.insert(QStringLiteral("length"), getJsonInt(entityObj, QStringLiteral("length")));
                 break;
             case EntityType::Release:
-                entityInfo.insert("date", getJsonString(entityObj, "date"));
-                entityInfo.insert("status", getJsonString(entityObj, "status"));
-                entityInfo.insert("track-count", getJsonInt(entityObj, "track-count"));
+                entityInfo.insert(QStringLiteral("date"), getJsonString(entityObj, QStringLiteral("date")));
+                entityInfo.insert(QStringLiteral("status"), getJsonString(entityObj, QStringLiteral("status")));
+                entityInfo.insert(QStringLiteral("track-count"), getJsonInt(entityObj, QStringLiteral("track-count")));
                 break;
             case EntityType::ReleaseGroup:
-                entityInfo.insert("primary-type", getJsonString(entityObj, "primary-type"));
-                entityInfo.insert("first-release-date", getJsonString(entityObj, "first-release-date"));
+                entityInfo.insert(QStringLiteral("primary-type"), getJsonString(entityObj, QStringLiteral("primary-type")));
+                entityInfo.insert(QStringLiteral("first-release-date"), getJsonString(entityObj, QStringLiteral("first-release-date")));
                 break;
             case EntityType::Work:
-                entityInfo.insert("type", getJsonString(entityObj, "type"));
+                entityInfo.insert(QStringLiteral("type"), getJsonString(entityObj, QStringLiteral("type")));
                 break;
             case EntityType::Artist:
-                entityInfo.insert("type", getJsonString(entityObj, "type"));
-                entityInfo.insert("sort-name", getJsonString(entityObj, "sort-name"));
+                entityInfo.insert(QStringLiteral("type"), getJsonString(entityObj, QStringLiteral("type")));
+                entityInfo.insert(QStringLiteral("sort-name"), getJsonString(entityObj, QStringLiteral("sort-name")));
                 break;
             default:
                 break;
@@ -15,6 +15,8 @@
 #include "../models/resultitem.h"
 #include "../core/types.h"
 
+struct FieldSpec;
+
 /**
  * @class MusicBrainzParser
  * @brief 通用的MusicBrainz数据解析器
@@ -48,6 +50,18 @@ public:
      */
     QList<QSharedPointer<ResultItem>> parseSearchResponse(const QByteArray &data, EntityType expectedType = EntityType::Unknown);
     
+    /**
+     * @brief 解析已构建好的搜索/浏览响应文档
+     * @param root 响应的JSON根对象
+     * @param expectedType 期望的实体类型（可选，用于验证）
+     * @param deferCompoundFields 是否延迟解码复合字段（见parseEntity）
+     * @return 解析后的ResultItem列表
+     * 
+     * 调用方已经解析过响应体时使用，避免重复构建JSON文档。
+     */
+    QList<QSharedPointer<ResultItem>> parseSearchResponse(const QJsonObject &root, EntityType expectedType = EntityType::Unknown,
+                                                          bool deferCompoundFields = false);
+    
     /**
      * @brief 解析详细信息响应
      * @param data JSON响应数据
@@ -56,12 +70,26 @@ public:
      */
     QSharedPointer<ResultItem> parseDetailsResponse(const QByteArray &data, EntityType expectedType = EntityType::Unknown);
     
+    /**
+     * @brief 解析已构建好的详细信息响应文档
+     * @param root 响应的JSON根对象
+     * @param expectedType 期望的实体类型（可选，用于验证）
+     * @return 解析后的ResultItem
+     */
+    QSharedPointer<ResultItem> parseDetailsResponse(const QJsonObject &root, EntityType expectedType = EntityType::Unknown);
+    
     /**
      * @brief 解析任意JSON对象为实体
      * @param jsonObj JSON对象
      * @param type 实体类型（如果已知）
+     * @param deferCompoundFields 是否延迟解码复合字段
      * @return 解析后的ResultItem
-     */    QSharedPointer<ResultItem> parseEntity(const QJsonObject &jsonObj, EntityType type = EntityType::Unknown);
+     * 
+     * 延迟模式下只转换标量字段，别名、关系、媒体、标签等复合字段（及由它们整理出的字段）
+     * 保留在源JSON对象中，由ResultItem在首次访问时解码，结果与完整解析相同。
+     * 适用于大部分行不会被打开的列表结果。
+     */    QSharedPointer<ResultItem> parseEntity(const QJsonObject &jsonObj, EntityType type = EntityType::Unknown,
+                                           bool deferCompoundFields = false);
     
     
 
@@ -77,9 +105,10 @@ public:
     static EntityType detectEntityType(const QJsonObject &jsonObj);      /**
      * @brief 递归解析JSON值为QVariant
      * @param value JSON值
+     * @param key 值所在的成员名，决定字符串值是否驻留（见internField()）
      * @return 解析后的QVariant
      */
-    static QVariant parseJsonValue(const QJsonValue &value);
+    static QVariant parseJsonValue(const QJsonValue &value, const QString &key = QString());
 
     // =============================================================================
     // 验证方法
@@ -92,6 +121,17 @@ public:
      */
     static bool validateJsonData(const QByteArray &data);
     
+    /**
+     * @brief 解析响应体为JSON根对象（只构建一次文档）
+     * @param data JSON数据
+     * @param root 输出的根对象
+     * @param error 输出的错误信息（可选）
+     * @return 数据是有效的JSON对象时返回true
+     * 
+     * 合并了validateJsonData和fromJson，验证和解析共用同一次文档构建。
+     */
+    static bool parseRootObject(const QByteArray &data, QJsonObject *root, QString *error = nullptr);
+    
     /**
      * @brief 检查解析错误
      * @param jsonObj JSON对象
@@ -108,51 +148,32 @@ private:
      * @brief 解析基本实体信息
      * @param item ResultItem实例
      * @param jsonObj JSON对象
+     * @param deferCompoundFields 是否跳过复合字段
      */
-    void parseBasicEntityInfo(QSharedPointer<ResultItem> &item, const QJsonObject &jsonObj);
+    void parseBasicEntityInfo(QSharedPointer<ResultItem> &item, const QJsonObject &jsonObj, bool deferCompoundFields);
     
     /**
-     * @brief 解析特定类型的属性
+     * @brief 按实体字段表解析对象的所有字段
+     *
+     * 每种实体类型由EntitySchema<Type>生成一个专用版本，对象的键只遍历一次：
+     * 常用标量写入定长记录，字段表中的复合字段交给对应的专用解析，
+     * 其余字段按通用方式转换。
+     *
+     * @tparam Type 实体类型
      * @param item ResultItem实例
      * @param jsonObj JSON对象
-     * @param type 实体类型
-     */
-    void parseTypeSpecificProperties(QSharedPointer<ResultItem> &item, const QJsonObject &jsonObj, EntityType type);
-    
-    /**
-     * @brief 解析Artist特定属性
-     */
-    void parseArtistProperties(QSharedPointer<ResultItem> &item, const QJsonObject &jsonObj);
-    
-    /**
-     * @brief 解析Release特定属性
-     */
-    void parseReleaseProperties(QSharedPointer<ResultItem> &item, const QJsonObject &jsonObj);
-    
-    /**
-     * @brief 解析Recording特定属性
+     * @param deferCompoundFields 是否跳过复合字段
      */
-    void parseRecordingProperties(QSharedPointer<ResultItem> &item, const QJsonObject &jsonObj);
+    template <EntityType Type>
+    void parseEntityFields(QSharedPointer<ResultItem> &item, const QJsonObject &jsonObj, bool deferCompoundFields);
     
     /**
-     * @brief 解析ReleaseGroup特定属性
+     * @brief 按字段描述解析一个复合字段
+     * @param spec 字段表中的字段描述
+     * @param value 字段的JSON值
+     * @return 整理后的结果
      */
-    void parseReleaseGroupProperties(QSharedPointer<ResultItem> &item, const QJsonObject &jsonObj);
-    
-    /**
-     * @brief 解析Work特定属性
-     */
-    void parseWorkProperties(QSharedPointer<ResultItem> &item, const QJsonObject &jsonObj);
-    
-    /**
-     * @brief 解析Label特定属性
-     */
-    void parseLabelProperties(QSharedPointer<ResultItem> &item, const QJsonObject &jsonObj);
-    
-    /**
-     * @brief 解析Area特定属性
-     */
-    void parseAreaProperties(QSharedPointer<ResultItem> &item, const QJsonObject &jsonObj);
+    QVariant parseCompoundField(const FieldSpec &spec, const QJsonValue &value);
     
     // =============================================================================
     // 复杂结构解析方法
@@ -243,6 +264,17 @@ private:
      */
     static QString getJsonString(const QJsonObject &obj, const QString &key, const QString &defaultValue = QString());
     
+    /**
+     * @brief 按字段驻留字符串值
+     *
+     * 只有取值范围很小的字段（类型、状态、国家、语言等）参与驻留；
+     * ID、名称、标题等几乎不重复的值原样返回，不占用驻留池的锁。
+     * @param key 字段名
+     * @param value 字符串值
+     * @return 驻留后的字符串，或原样返回的value
+     */
+    static QString internField(const QString &key, const QString &value);
+    
     /**
      * @brief 安全获取JSON整数值
      * @param obj JSON对象
@@ -285,32 +317,11 @@ private:
     
     /**
      * @brief 通用的子实体列表解析
-     * @param jsonObj JSON对象
-     * @param arrayKey 数组键名（如 "recordings", "releases"）
+     * @param entityArray 子实体数组（如 "recordings", "releases" 的值）
      * @param entityType 子实体类型
      * @return 子实体列表
      */
-    static QVariantList parseSubEntityList(const QJsonObject &jsonObj, const QString &arrayKey, EntityType entityType);
-      /**
-     * @brief 解析通用的子实体列表（recordings, releases, works等）
-     * @param item 目标结果项
-     * @param jsonObj JSON对象
-     */
-    void parseCommonSubEntities(QSharedPointer<ResultItem> &item, const QJsonObject &jsonObj);
-    
-    /**
-     * @brief 解析通用属性（tags, aliases, relations等）
-     * @param item 目标结果项
-     * @param jsonObj JSON对象
-     */
-    void parseCommonProperties(QSharedPointer<ResultItem> &item, const QJsonObject &jsonObj);
-    
-    /**
-     * @brief 解析艺术家信用（artist-credit）
-     * @param item 目标结果项
-     * @param jsonObj JSON对象
-     */
-    void parseArtistCreditProperty(QSharedPointer<ResultItem> &item, const QJsonObject &jsonObj);
+    static QVariantList parseSubEntityList(const QJsonArray &entityArray, EntityType entityType);
 };
 
 #endif // MUSICBRAINZPARSER_H
@@ -1,14 +1,49 @@
 #include "network_manager.h"
+#include "response_cache.h"
 #include "../core/error_types.h"
+#include "../utils/config_manager.h"
 #include <QNetworkRequest>
 #include <QNetworkProxy>
 #include <QDebug>
+#include <QtMath>
+#include <QStandardPaths>
+#include <QRandomGenerator>
+#include <QDateTime>
+
+namespace {
+// 加权轮转中各优先级（交互、预加载、批量）每轮可发送的请求数
+constexpr std::array<int, REQUEST_PRIORITY_COUNT> PRIORITY_WEIGHTS = {6, 3, 1};
+
+// 单次退避的上限（毫秒）
+constexpr int MAX_BACKOFF_MS = 60000;
+}
 
 NetworkManager::NetworkManager(QObject *parent)
     : QObject(parent)
     , m_networkManager(new QNetworkAccessManager(this))
+    , m_dispatchTimer(new QTimer(this))
 {
-    // 移除速率限制 - 不再创建定时器
+    m_dispatchTimer->setSingleShot(true);
+    connect(m_dispatchTimer, &QTimer::timeout, this, &NetworkManager::dispatchPending);
+
+    m_clock.start();
+
+    setupCache();
+    loadRetryConfig();
+    connect(&ConfigManager::instance(), &ConfigManager::networkConfigChanged,
+            this, &NetworkManager::loadRetryConfig);
+
+    // 从配置加载速率限制（ApiConfig::rateLimit 为令牌补充间隔）
+    const auto &apiConfig = ConfigManager::instance().api();
+    m_weightCredits = PRIORITY_WEIGHTS;
+    setSchedulingPolicy(apiConfig.strictPriority ? SchedulingPolicy::Strict : SchedulingPolicy::Weighted);
+    setRateLimit(apiConfig.rateLimit, apiConfig.rateBurst);
+
+    connect(&ConfigManager::instance(), &ConfigManager::apiConfigChanged, this, [this]() {
+        const auto &config = ConfigManager::instance().api();
+        setSchedulingPolicy(config.strictPriority ? SchedulingPolicy::Strict : SchedulingPolicy::Weighted);
+        setRateLimit(config.rateLimit, config.rateBurst);
+    });
 }
 
 NetworkManager::~NetworkManager()
@@ -16,65 +51,357 @@ NetworkManager::~NetworkManager()
     // QObject会自动清理子对象
 }
 
-QNetworkReply* NetworkManager::sendRequest(const QString &url, const QString &userAgent)
+quint64 NetworkManager::sendRequest(const QString &url, const QString &userAgent,
+                                    RequestPriority priority, bool useCache)
 {
-    QNetworkRequest request = createRequest(url, userAgent);
-    QNetworkReply *reply = m_networkManager->get(request);
-    
-    connect(reply, &QNetworkReply::finished,
-            this, &NetworkManager::onReplyFinished);
-    
-    qDebug() << "NetworkManager: Request sent -" << url;
-    return reply;
+    useCache = useCache && m_cache;
+    return enqueueRequest(createRequest(url, userAgent, useCache), "GET", QByteArray(), priority, useCache);
 }
 
-QNetworkReply* NetworkManager::sendAuthenticatedRequest(const QString &url, const QString &userAgent,
-                                            const QString &username, const QString &password,
-                                            const QString &method, const QByteArray &data)
+quint64 NetworkManager::sendAuthenticatedRequest(const QString &url, const QString &userAgent,
+                                                 const QString &username, const QString &password,
+                                                 const QString &method, const QByteArray &data,
+                                                 RequestPriority priority)
 {
-    QNetworkRequest request = createAuthenticatedRequest(url, userAgent, username, password);
-    QNetworkReply *reply = nullptr;
-    
-    if (method == "GET") {
-        reply = m_networkManager->get(request);
-    } else if (method == "POST") {
-        reply = m_networkManager->post(request, data);
-    } else if (method == "PUT") {
-        reply = m_networkManager->put(request, data);
-    } else if (method == "DELETE") {
-        reply = m_networkManager->deleteResource(request);
-    } else {
+    if (method != "GET" && method != "POST" && method != "PUT" && method != "DELETE") {
         qCritical() << "Unsupported HTTP method:" << method;
-        return nullptr;
+        return 0;
+    }
+
+    QNetworkRequest request = createAuthenticatedRequest(url, userAgent, username, password);
+    return enqueueRequest(request, method.toLatin1(), data, priority);
+}
+
+bool NetworkManager::cancelRequest(quint64 requestId)
+{
+    if (requestId == 0) {
+        return false;
+    }
+
+    // 还在等待令牌
+    for (auto &queue : m_pendingQueues) {
+        for (auto it = queue.begin(); it != queue.end(); ++it) {
+            if (it->id == requestId) {
+                qDebug() << "NetworkManager: Cancelled queued request -" << it->request.url().toString();
+                queue.erase(it);
+                m_metrics.cancelledCount++;
+                emit queueDepthChanged(pendingCount());
+                return true;
+            }
+        }
+    }
+
+    // 在退避中等待重试，定时器到期时找不到条目即忽略
+    if (m_delayedRetries.remove(requestId) > 0) {
+        qDebug() << "NetworkManager: Cancelled request waiting for retry -" << requestId;
+        m_metrics.cancelledCount++;
+        return true;
     }
-    
-    if (reply) {
-        connect(reply, &QNetworkReply::finished,
-                this, &NetworkManager::onReplyFinished);
-        qDebug() << "NetworkManager: Authenticated" << method << "request sent -" << url;
+
+    // 已发出：先断开连接再中止，避免把中止当作错误上报或重试
+    for (auto it = m_activeReplies.begin(); it != m_activeReplies.end(); ++it) {
+        if (it->id == requestId) {
+            QNetworkReply *reply = it.key();
+            m_activeReplies.erase(it);
+            disconnect(reply, nullptr, this, nullptr);
+            m_metrics.activeRequests = qMax(0, m_metrics.activeRequests - 1);
+            m_metrics.cancelledCount++;
+
+            qDebug() << "NetworkManager: Aborting request -" << reply->request().url().toString();
+            reply->abort();
+            reply->deleteLater();
+            return true;
+        }
     }
-    
-    return reply;
+
+    return false;
 }
 
-void NetworkManager::setProxy(const QString &host, int port, 
+void NetworkManager::setProxy(const QString &host, int port,
                              const QString &username, const QString &password)
 {
     if (host.isEmpty()) {
         m_networkManager->setProxy(QNetworkProxy::NoProxy);
         return;
     }
-    
+
     QNetworkProxy proxy(QNetworkProxy::HttpProxy, host, port);
     if (!username.isEmpty()) {
         proxy.setUser(username);
         proxy.setPassword(password);
     }
-    
+
     m_networkManager->setProxy(proxy);
     qDebug() << "Proxy configured:" << host << ":" << port;
 }
 
+void NetworkManager::setRateLimit(int intervalMs, int burst)
+{
+    refillTokens();
+
+    m_rateIntervalMs = qMax(0, intervalMs);
+    m_burst = qMax(1, burst);
+
+    if (!m_rateLimitConfigured) {
+        // 首次配置时令牌桶是满的，启动后的第一批请求不必等待
+        m_rateLimitConfigured = true;
+        m_tokens = m_burst;
+    } else {
+        // 新容量可能小于当前积累的令牌
+        m_tokens = qMin<double>(m_tokens, m_burst);
+    }
+
+    qDebug() << "NetworkManager: Rate limit set to 1 request per" << m_rateIntervalMs
+             << "ms, burst" << m_burst;
+
+    dispatchPending();
+}
+
+void NetworkManager::setDispatchPaused(bool paused)
+{
+    if (m_dispatchPaused == paused) {
+        return;
+    }
+
+    m_dispatchPaused = paused;
+    qDebug() << "NetworkManager: Dispatch" << (paused ? "paused" : "resumed");
+
+    if (!paused) {
+        dispatchPending();
+    }
+}
+
+void NetworkManager::setClock(std::function<qint64()> clock)
+{
+    m_clockOverride = std::move(clock);
+    m_lastRefillMs = nowMs();
+}
+
+void NetworkManager::setSchedulingPolicy(SchedulingPolicy policy)
+{
+    m_policy = policy;
+    m_weightCredits = PRIORITY_WEIGHTS;
+}
+
+NetworkManager::SchedulerMetrics NetworkManager::schedulerMetrics() const
+{
+    SchedulerMetrics metrics = m_metrics;
+    for (int i = 0; i < REQUEST_PRIORITY_COUNT; ++i) {
+        metrics.queueDepthByPriority[i] = m_pendingQueues[i].size();
+    }
+    metrics.queueDepth = pendingCount();
+    return metrics;
+}
+
+// =============================================================================
+// 令牌桶调度
+// =============================================================================
+
+void NetworkManager::loadRetryConfig()
+{
+    const auto &networkConfig = ConfigManager::instance().network();
+    m_maxRetries = qMax(0, networkConfig.maxRetries);
+    m_retryDelayMs = qMax(1, networkConfig.retryDelayMs);
+    m_timeoutMs = qMax(0, networkConfig.timeoutMs);
+    m_deadlineMs = qMax(0, networkConfig.requestDeadlineMs);
+}
+
+void NetworkManager::setupCache()
+{
+    const auto &networkConfig = ConfigManager::instance().network();
+    if (!networkConfig.cacheEnabled) {
+        return;
+    }
+
+    const QString cacheDir = QStandardPaths::writableLocation(QStandardPaths::CacheLocation);
+    if (cacheDir.isEmpty()) {
+        qWarning() << "NetworkManager: No writable cache location, response cache disabled";
+        return;
+    }
+
+    m_cache = new ResponseCache(m_networkManager);
+    m_cache->setCacheDirectory(cacheDir + "/http");
+    m_cache->setMaximumCacheSize(qint64(qMax(1, networkConfig.cacheSizeMb)) * 1024 * 1024);
+    m_cache->setDefaultTtl(networkConfig.cacheTtlSeconds);
+
+    // QNetworkAccessManager接管缓存对象的所有权
+    m_networkManager->setCache(m_cache);
+
+    qDebug() << "NetworkManager: Response cache enabled at" << m_cache->cacheDirectory()
+             << "size limit:" << m_cache->maximumCacheSize() << "bytes";
+}
+
+quint64 NetworkManager::enqueueRequest(const QNetworkRequest &request, const QByteArray &method,
+                                       const QByteArray &data, RequestPriority priority,
+                                       bool useCache)
+{
+    PendingRequest pending;
+    pending.id = m_nextRequestId++;
+    pending.priority = priority;
+    pending.request = request;
+    pending.method = method;
+    pending.data = data;
+    pending.useCache = useCache;
+    pending.enqueuedAt = nowMs();
+    pending.deadlineAt = m_deadlineMs > 0 ? pending.enqueuedAt + m_deadlineMs : 0;
+
+    // 缓存新鲜的请求由QNAM直接从磁盘返回，不占用服务器的速率配额
+    if (useCache && m_cache && m_cache->isFresh(request.url())) {
+        m_metrics.freshCacheDispatches++;
+        qDebug() << "NetworkManager: Fresh cache entry, bypassing rate limit -" << request.url().toString();
+        startRequest(pending);
+        return pending.id;
+    }
+
+    m_pendingQueues[static_cast<int>(priority)].enqueue(pending);
+
+    const int depth = pendingCount();
+    m_metrics.peakQueueDepth = qMax(m_metrics.peakQueueDepth, depth);
+    emit queueDepthChanged(depth);
+
+    qDebug() << "NetworkManager: Request queued -" << request.url().toString()
+             << "priority:" << static_cast<int>(priority) << "queue depth:" << depth;
+
+    dispatchPending();
+    return pending.id;
+}
+
+qint64 NetworkManager::nowMs() const
+{
+    return m_clockOverride ? m_clockOverride() : m_clock.elapsed();
+}
+
+void NetworkManager::refillTokens()
+{
+    const qint64 now = nowMs();
+
+    if (m_rateIntervalMs <= 0) {
+        // 不限速
+        m_tokens = m_burst;
+        m_lastRefillMs = now;
+    } else if (now > m_lastRefillMs) {
+        // m_lastRefillMs可能被限流推迟到将来，此时不补充
+        m_tokens = qMin<double>(m_burst, m_tokens + static_cast<double>(now - m_lastRefillMs) / m_rateIntervalMs);
+        m_lastRefillMs = now;
+    }
+}
+
+int NetworkManager::pendingCount() const
+{
+    int count = 0;
+    for (const auto &queue : m_pendingQueues) {
+        count += queue.size();
+    }
+    return count;
+}
+
+int NetworkManager::nextQueueIndex()
+{
+    if (m_policy == SchedulingPolicy::Strict) {
+        for (int i = 0; i < REQUEST_PRIORITY_COUNT; ++i) {
+            if (!m_pendingQueues[i].isEmpty()) {
+                return i;
+            }
+        }
+        return -1;
+    }
+
+    // 加权轮转：按优先级从高到低取仍有配额的非空队列，
+    // 所有非空队列的配额都用完时开始新一轮
+    for (int round = 0; round < 2; ++round) {
+        for (int i = 0; i < REQUEST_PRIORITY_COUNT; ++i) {
+            if (!m_pendingQueues[i].isEmpty() && m_weightCredits[i] > 0) {
+                m_weightCredits[i]--;
+                return i;
+            }
+        }
+        m_weightCredits = PRIORITY_WEIGHTS;
+    }
+    return -1;
+}
+
+void NetworkManager::dispatchPending()
+{
+    if (pendingCount() == 0 || m_dispatchPaused) {
+        return;
+    }
+
+    // 服务器限流期间暂停全部发送
+    const qint64 now = nowMs();
+    if (now < m_throttledUntilMs) {
+        m_dispatchTimer->start(static_cast<int>(m_throttledUntilMs - now));
+        return;
+    }
+
+    refillTokens();
+
+    bool dispatched = false;
+    while (m_rateIntervalMs <= 0 || m_tokens >= 1.0) {
+        const int queueIndex = nextQueueIndex();
+        if (queueIndex < 0) {
+            break;
+        }
+        if (m_rateIntervalMs > 0) {
+            m_tokens -= 1.0;
+        }
+        startRequest(m_pendingQueues[queueIndex].dequeue());
+        dispatched = true;
+    }
+
+    if (dispatched) {
+        emit queueDepthChanged(pendingCount());
+    }
+
+    // 还有请求在等待，安排在下一个令牌可用时再次调度
+    if (pendingCount() > 0 && !m_dispatchTimer->isActive()) {
+        const int waitMs = qCeil((1.0 - m_tokens) * m_rateIntervalMs);
+        m_dispatchTimer->start(qMax(1, waitMs));
+    }
+}
+
+void NetworkManager::startRequest(const PendingRequest &pending)
+{
+    QNetworkReply *reply = nullptr;
+
+    QNetworkRequest request = pending.request;
+    if (m_timeoutMs > 0) {
+        request.setTransferTimeout(m_timeoutMs);
+    }
+
+    if (pending.method == "GET") {
+        reply = m_networkManager->get(request);
+    } else if (pending.method == "POST") {
+        reply = m_networkManager->post(request, pending.data);
+    } else if (pending.method == "PUT") {
+        reply = m_networkManager->put(request, pending.data);
+    } else if (pending.method == "DELETE") {
+        reply = m_networkManager->deleteResource(request);
+    }
+
+    if (!reply) {
+        return;
+    }
+
+    const qint64 waitMs = nowMs() - pending.enqueuedAt;
+    m_metrics.dispatchedCount++;
+    m_metrics.totalWaitMs += waitMs;
+    m_metrics.maxWaitMs = qMax(m_metrics.maxWaitMs, waitMs);
+    m_metrics.lastWaitMs = waitMs;
+    m_metrics.activeRequests++;
+
+    m_activeReplies.insert(reply, pending);
+    reply->setProperty("networkRequestId", pending.id);
+    connect(reply, &QNetworkReply::finished,
+            this, &NetworkManager::onReplyFinished);
+    const quint64 requestId = pending.id;
+    connect(reply, &QNetworkReply::readyRead, this, [this, reply, requestId]() {
+        emit requestDataAvailable(reply, requestId);
+    });
+
+    qDebug() << "NetworkManager:" << pending.method << "request sent -" << pending.request.url().toString()
+             << "waited" << waitMs << "ms";
+}
+
 void NetworkManager::onReplyFinished()
 {
     QNetworkReply *reply = qobject_cast<QNetworkReply*>(sender());
@@ -82,24 +409,195 @@ void NetworkManager::onReplyFinished()
         return;
     }
 
-    QString url = reply->request().url().toString();
-    
+    m_metrics.activeRequests = qMax(0, m_metrics.activeRequests - 1);
+
+    const QString url = reply->request().url().toString();
+    const quint64 requestId = reply->property("networkRequestId").toULongLong();
+    const PendingRequest pending = m_activeReplies.take(reply);
+
+    if (reply->attribute(QNetworkRequest::SourceIsFromCacheAttribute).toBool()) {
+        m_metrics.cacheHits++;
+    }
+
     if (reply->error() != QNetworkReply::NoError) {
+        const FailureKind kind = classifyFailure(reply);
+        if (kind != FailureKind::Permanent && pending.id != 0 && scheduleRetry(pending, reply, kind)) {
+            reply->deleteLater();
+            return;
+        }
+
         QString error = QString("Network request failed: %1 (HTTP %2)")
                            .arg(reply->errorString())
                            .arg(reply->attribute(QNetworkRequest::HttpStatusCodeAttribute).toInt());
+        if (pending.attempt > 0) {
+            error += QString(" after %1 retries").arg(pending.attempt);
+        }
         qCritical() << "NetworkManager error:" << error;
-        emit requestError(error, url);
+        reply->deleteLater();
+        emit requestError(error, url, requestId);
     } else {
-        emit requestFinished(reply, url);
+        emit requestFinished(reply, url, requestId);
     }
 }
 
-QNetworkRequest NetworkManager::createRequest(const QString &url, const QString &userAgent) const
+// =============================================================================
+// 重试
+// =============================================================================
+
+NetworkManager::FailureKind NetworkManager::classifyFailure(QNetworkReply::NetworkError error, int httpStatus)
+{
+    if (httpStatus == 429 || httpStatus == 503) {
+        return FailureKind::Throttled;
+    }
+    if (httpStatus == 408 || httpStatus == 500 || httpStatus == 502 || httpStatus == 504) {
+        return FailureKind::Transient;
+    }
+    if (httpStatus >= 400) {
+        return FailureKind::Permanent;
+    }
+
+    switch (error) {
+        case QNetworkReply::TimeoutError:
+        case QNetworkReply::OperationCanceledError:     // 传输超时
+        case QNetworkReply::RemoteHostClosedError:
+        case QNetworkReply::ConnectionRefusedError:
+        case QNetworkReply::TemporaryNetworkFailureError:
+        case QNetworkReply::NetworkSessionFailedError:
+        case QNetworkReply::ProxyTimeoutError:
+        case QNetworkReply::UnknownNetworkError:
+            return FailureKind::Transient;
+        default:
+            return FailureKind::Permanent;
+    }
+}
+
+NetworkManager::FailureKind NetworkManager::classifyFailure(QNetworkReply *reply) const
+{
+    return classifyFailure(reply->error(), reply->attribute(QNetworkRequest::HttpStatusCodeAttribute).toInt());
+}
+
+int NetworkManager::parseRetryAfter(const QByteArray &value, const QDateTime &now)
+{
+    const QByteArray trimmed = value.trimmed();
+    if (trimmed.isEmpty()) {
+        return -1;
+    }
+
+    // Retry-After可以是秒数，也可以是HTTP日期
+    bool ok = false;
+    const qint64 seconds = trimmed.toLongLong(&ok);
+    if (ok) {
+        return static_cast<int>(qBound<qint64>(0, seconds * 1000, MAX_BACKOFF_MS * 10));
+    }
+
+    const QDateTime date = QDateTime::fromString(QString::fromLatin1(trimmed), Qt::RFC2822Date);
+    if (date.isValid()) {
+        return static_cast<int>(qBound<qint64>(0, now.msecsTo(date), MAX_BACKOFF_MS * 10));
+    }
+
+    return -1;
+}
+
+int NetworkManager::retryAfterMs(QNetworkReply *reply) const
+{
+    return parseRetryAfter(reply->rawHeader("Retry-After"), QDateTime::currentDateTimeUtc());
+}
+
+int NetworkManager::backoffDelayMs(int baseDelayMs, int attempt)
+{
+    // 指数退避 + 抖动：在[base/2, base]之间随机，避免多个客户端同时重试
+    const qint64 base = qMin<qint64>(MAX_BACKOFF_MS, qint64(baseDelayMs) << qBound(0, attempt, 16));
+    const qint64 half = base / 2;
+    return static_cast<int>(half + QRandomGenerator::global()->bounded(half + 1));
+}
+
+int NetworkManager::backoffDelayMs(int attempt) const
+{
+    return backoffDelayMs(m_retryDelayMs, attempt);
+}
+
+bool NetworkManager::scheduleRetry(const PendingRequest &pending, QNetworkReply *reply, FailureKind kind)
+{
+    if (pending.attempt >= m_maxRetries) {
+        return false;
+    }
+
+    // POST不是幂等的，不自动重试
+    if (pending.method == "POST") {
+        return false;
+    }
+
+    int delayMs = backoffDelayMs(pending.attempt);
+    const int retryAfter = retryAfterMs(reply);
+    if (retryAfter >= 0) {
+        delayMs = retryAfter + QRandomGenerator::global()->bounded(250);
+    }
+
+    const qint64 now = nowMs();
+    if (pending.deadlineAt > 0 && now + delayMs > pending.deadlineAt) {
+        qWarning() << "NetworkManager: Retry would exceed request deadline -" << pending.request.url().toString();
+        return false;
+    }
+
+    if (kind == FailureKind::Throttled) {
+        // 服务器在限流：暂停整个调度器并清空令牌，限流结束后重新积累
+        m_metrics.throttledCount++;
+        m_throttledUntilMs = qMax(m_throttledUntilMs, now + delayMs);
+        m_tokens = 0.0;
+        m_lastRefillMs = m_throttledUntilMs;
+    }
+
+    PendingRequest retry = pending;
+    retry.attempt++;
+    m_delayedRetries.insert(retry.id, retry);
+    m_metrics.retriedCount++;
+
+    qWarning() << "NetworkManager: Retrying" << pending.request.url().toString()
+               << "in" << delayMs << "ms (attempt" << retry.attempt << "of" << m_maxRetries << ")";
+
+    emit requestRetrying(retry.id, retry.attempt, delayMs);
+
+    const quint64 requestId = retry.id;
+    QTimer::singleShot(delayMs, this, [this, requestId]() {
+        requeueRetry(requestId);
+    });
+
+    return true;
+}
+
+void NetworkManager::requeueRetry(quint64 requestId)
+{
+    auto it = m_delayedRetries.find(requestId);
+    if (it == m_delayedRetries.end()) {
+        return;
+    }
+
+    PendingRequest retry = it.value();
+    m_delayedRetries.erase(it);
+    retry.enqueuedAt = nowMs();
+
+    // 重试请求排在同优先级队列的最前面，但仍需要令牌
+    m_pendingQueues[static_cast<int>(retry.priority)].prepend(retry);
+    emit queueDepthChanged(pendingCount());
+
+    dispatchPending();
+}
+
+QNetworkRequest NetworkManager::createRequest(const QString &url, const QString &userAgent, bool useCache) const
 {
     QNetworkRequest request(url);
     request.setHeader(QNetworkRequest::UserAgentHeader, userAgent);
     request.setRawHeader("Accept", "application/json");
+
+    if (useCache) {
+        // 新鲜条目直接使用缓存，过期条目自动发起条件请求
+        request.setAttribute(QNetworkRequest::CacheLoadControlAttribute, QNetworkRequest::PreferNetwork);
+        request.setAttribute(QNetworkRequest::CacheSaveControlAttribute, true);
+    } else {
+        request.setAttribute(QNetworkRequest::CacheLoadControlAttribute, QNetworkRequest::AlwaysNetwork);
+        request.setAttribute(QNetworkRequest::CacheSaveControlAttribute, false);
+    }
+
     return request;
 }
 
@@ -107,11 +605,11 @@ QNetworkRequest NetworkManager::createAuthenticatedRequest(const QString &url, c
                                                           const QString &username, const QString &password) const
 {
     QNetworkRequest request = createRequest(url, userAgent);
-    
+
     // 添加HTTP基础认证
     QString credentials = username + ":" + password;
     QByteArray encodedCredentials = credentials.toUtf8().toBase64();
     request.setRawHeader("Authorization", "Basic " + encodedCredentials);
-    
+
     return request;
 }
@@ -4,35 +4,122 @@
 #include <QObject>
 #include <QNetworkAccessManager>
 #include <QNetworkReply>
+#include <QNetworkRequest>
 #include <QNetworkProxy>
 #include <QTimer>
 #include <QQueue>
+#include <QHash>
 #include <QPair>
+#include <QElapsedTimer>
+#include <QDateTime>
+#include <array>
+#include <functional>
+#include "api_utils.h"
+
+class ResponseCache;
 
 /**
  * @class NetworkManager
  * @brief 专用的网络请求管理器
- * 
+ *
  * 从MusicBrainzApi中分离出来的网络层，专门负责：
  * - HTTP请求的发送和接收
- * - 速率限制管理
+ * - 速率限制管理（令牌桶调度器）
  * - 请求队列管理
- * - 网络错误处理
+ * - 网络错误处理与自动重试
+ *
+ * **速率限制：**
+ * 所有请求都先进入等待队列，由令牌桶按配置的速率出队发送。
+ * 令牌以 1 个/rateIntervalMs 的速度补充，最多积累burst个，
+ * 因此短时突发不会超过burst个请求，长期吞吐量等于服务器允许的持续速率。
+ *
+ * **优先级调度：**
+ * 每个优先级（交互、预加载、批量）有独立的等待队列。拿到令牌时，
+ * Strict策略总是先发送最高优先级的请求；Weighted策略按权重轮转，
+ * 高优先级占大部分带宽，同时保证低优先级不会被完全饿死。
+ *
+ * **响应缓存：**
+ * 启用NetworkConfig::cacheEnabled时，可缓存的请求经过ResponseCache。
+ * 缓存仍在新鲜期内的请求不消耗令牌、直接发送（由缓存返回）；
+ * 过期条目由QNetworkAccessManager自动发起条件请求重新验证。
+ *
+ * **重试：**
+ * 失败分为临时错误（429/502/503/504、超时、连接中断）和永久错误（其他4xx等）。
+ * 临时错误按NetworkConfig::maxRetries自动重试，间隔为retryDelayMs起的指数退避加随机抖动；
+ * 服务器给出Retry-After时以其为准。429/503表示服务器在限流，此时整个调度器暂停到
+ * 限流结束并清空令牌，避免其他请求继续撞上限流。超过requestDeadlineMs的请求不再重试。
+ * 只有重试耗尽或永久错误才发出requestError。
+ *
+ * **取消：**
+ * cancelRequest()把请求从等待队列或重试队列中移除，已发出的请求在
+ * QNetworkReply层面中止。被取消的请求不会再发出任何信号。
  */
 class NetworkManager : public QObject
 {
     Q_OBJECT
 
 public:
+    /**
+     * @brief 优先级调度策略
+     */
+    enum class SchedulingPolicy {
+        Strict,     ///< 严格优先级：低优先级队列只在高优先级队列为空时发送
+        Weighted    ///< 加权轮转：按 6:3:1 的比例在各优先级之间分配令牌
+    };
+
+    /**
+     * @brief 失败类型
+     */
+    enum class FailureKind {
+        Transient,      ///< 临时错误，可以重试
+        Throttled,      ///< 服务器限流（429/503），重试并暂停整个调度器
+        Permanent       ///< 永久错误，不重试
+    };
+
+    /**
+     * @struct SchedulerMetrics
+     * @brief 请求调度器统计信息
+     */
+    struct SchedulerMetrics {
+        int queueDepth = 0;             ///< 当前等待发送的请求数
+        std::array<int, REQUEST_PRIORITY_COUNT> queueDepthByPriority{};  ///< 各优先级的等待请求数
+        int peakQueueDepth = 0;         ///< 历史最大队列深度
+        int activeRequests = 0;         ///< 已发送但尚未完成的请求数
+        qint64 dispatchedCount = 0;     ///< 累计发送的请求数
+        qint64 totalWaitMs = 0;         ///< 累计排队等待时间（毫秒）
+        qint64 maxWaitMs = 0;           ///< 单个请求的最长排队等待时间（毫秒）
+        qint64 lastWaitMs = 0;          ///< 最近一次发送的请求的排队等待时间（毫秒）
+        qint64 cacheHits = 0;           ///< 由缓存返回的响应数（包括304重新验证）
+        qint64 freshCacheDispatches = 0;///< 因缓存新鲜而跳过令牌桶的请求数
+        qint64 retriedCount = 0;        ///< 自动重试次数
+        qint64 throttledCount = 0;      ///< 收到服务器限流响应（429/503）的次数
+        qint64 cancelledCount = 0;      ///< 被取消的请求数
+
+        /**
+         * @brief 平均排队等待时间（毫秒）
+         */
+        double averageWaitMs() const {
+            return dispatchedCount > 0 ? static_cast<double>(totalWaitMs) / dispatchedCount : 0.0;
+        }
+    };
+
     explicit NetworkManager(QObject *parent = nullptr);
-    ~NetworkManager();    /**
+    ~NetworkManager();
+
+    /**
      * @brief 发送GET请求
      * @param url 请求URL
      * @param userAgent User-Agent字符串
-     * @return 网络请求对象
+     * @param priority 请求优先级
+     * @param useCache 是否允许使用磁盘响应缓存（查询、浏览类请求）
+     * @return 请求ID，随requestFinished/requestError信号返回
+     *
+     * 请求先进入对应优先级的调度队列，在令牌桶允许时才真正发出。
      */
-    QNetworkReply* sendRequest(const QString &url, const QString &userAgent);
-    
+    quint64 sendRequest(const QString &url, const QString &userAgent,
+                        RequestPriority priority = RequestPriority::Interactive,
+                        bool useCache = false);
+
     /**
      * @brief 发送认证请求
      * @param url 请求URL
@@ -41,11 +128,23 @@ public:
      * @param password 密码
      * @param method HTTP方法（GET, POST, PUT, DELETE）
      * @param data 请求数据
-     * @return 是否成功发送
+     * @param priority 请求优先级
+     * @return 请求ID，不支持的HTTP方法返回0
      */
-    QNetworkReply* sendAuthenticatedRequest(const QString &url, const QString &userAgent,
-                                 const QString &username, const QString &password,
-                                 const QString &method = "GET", const QByteArray &data = QByteArray());
+    quint64 sendAuthenticatedRequest(const QString &url, const QString &userAgent,
+                                     const QString &username, const QString &password,
+                                     const QString &method = "GET", const QByteArray &data = QByteArray(),
+                                     RequestPriority priority = RequestPriority::Interactive);
+
+    /**
+     * @brief 取消请求
+     * @param requestId sendRequest/sendAuthenticatedRequest返回的请求ID
+     * @return true 如果请求仍在排队、等待重试或在途，并已被取消
+     *
+     * 排队中的请求直接出队，不消耗令牌；已发出的请求被中止。
+     * 取消后该请求不会再发出requestFinished或requestError。
+     */
+    bool cancelRequest(quint64 requestId);
 
     /**
      * @brief 设置代理服务器
@@ -54,32 +153,203 @@ public:
      * @param username 代理用户名（可选）
      * @param password 代理密码（可选）
      */
-    void setProxy(const QString &host, int port, 
-                  const QString &username = QString(), 
+    void setProxy(const QString &host, int port,
+                  const QString &username = QString(),
                   const QString &password = QString());
 
+    /**
+     * @brief 配置令牌桶速率限制
+     * @param intervalMs 每补充一个令牌的间隔（毫秒），<=0 表示不限速
+     * @param burst 令牌桶容量，即允许的最大突发请求数（最小为1）
+     */
+    void setRateLimit(int intervalMs, int burst);
+
+    /**
+     * @brief 获取当前的令牌补充间隔（毫秒）
+     */
+    int rateLimitInterval() const { return m_rateIntervalMs; }
+
+    /**
+     * @brief 获取令牌桶容量
+     */
+    int rateLimitBurst() const { return m_burst; }
+
+    /**
+     * @brief 替换调度器使用的时钟
+     * @param clock 返回单调递增毫秒数的函数，传入空函数恢复内部时钟
+     *
+     * 令牌补充、排队等待和限流暂停都按这个时钟计算，测试可以借此推进时间而不必真实等待。
+     * 切换时令牌补充的起点重置为新时钟的当前时间，已积累的令牌不变；应在发送请求之前调用。
+     */
+    void setClock(std::function<qint64()> clock);
+
+    /**
+     * @brief 设置优先级调度策略
+     */
+    void setSchedulingPolicy(SchedulingPolicy policy);
+
+    /**
+     * @brief 获取当前的优先级调度策略
+     */
+    SchedulingPolicy schedulingPolicy() const { return m_policy; }
+
+    /**
+     * @brief 暂停或恢复从等待队列发送请求
+     * @param paused 是否暂停
+     *
+     * 用于下游背压：暂停期间请求照常入队、在途请求照常完成，
+     * 只是不再从队列中取出新请求（缓存新鲜的请求不受影响）。
+     */
+    void setDispatchPaused(bool paused);
+
+    /**
+     * @brief 是否已暂停发送
+     */
+    bool isDispatchPaused() const { return m_dispatchPaused; }
+
+    /**
+     * @brief 获取响应缓存（未启用时为nullptr）
+     */
+    ResponseCache *responseCache() const { return m_cache; }
+
+    /**
+     * @brief 获取调度器统计信息
+     */
+    SchedulerMetrics schedulerMetrics() const;
+
+    // =============================================================================
+    // 重试策略
+    // =============================================================================
+
+    /**
+     * @brief 对失败的请求分类
+     * @param error 网络错误
+     * @param httpStatus HTTP状态码，没有收到响应时为0
+     */
+    static FailureKind classifyFailure(QNetworkReply::NetworkError error, int httpStatus);
+
+    /**
+     * @brief 解析Retry-After响应头
+     * @param value 响应头的值（秒数或HTTP日期）
+     * @param now 当前UTC时间，用于换算HTTP日期
+     * @return 需要等待的毫秒数，最多10分钟；为空或无法解析时返回-1
+     */
+    static int parseRetryAfter(const QByteArray &value, const QDateTime &now);
+
+    /**
+     * @brief 计算带随机抖动的指数退避时间
+     * @param baseDelayMs 退避基础间隔（毫秒）
+     * @param attempt 已重试次数（从0开始）
+     * @return 在[d/2, d]之间随机的毫秒数，d = baseDelayMs·2^attempt，最多60秒
+     */
+    static int backoffDelayMs(int baseDelayMs, int attempt);
+
 signals:
     /**
      * @brief 请求完成信号
-     * @param reply 网络回复对象
+     * @param reply 网络回复对象（由接收方负责deleteLater）
      * @param url 原始请求URL
+     * @param requestId sendRequest返回的请求ID
+     */
+    void requestFinished(QNetworkReply *reply, const QString &url, quint64 requestId);
+
+    /**
+     * @brief 响应数据到达信号
+     * @param reply 网络回复对象，接收方可以读取已到达的数据（不得删除）
+     * @param requestId 请求ID
+     *
+     * 用于边下载边解析。读取过的数据不会再出现在requestFinished的回复中。
      */
-    void requestFinished(QNetworkReply *reply, const QString &url);
+    void requestDataAvailable(QNetworkReply *reply, quint64 requestId);
 
     /**
      * @brief 请求错误信号
      * @param error 错误信息
      * @param url 原始请求URL
+     * @param requestId sendRequest返回的请求ID
+     */
+    void requestError(const QString &error, const QString &url, quint64 requestId);
+
+    /**
+     * @brief 调度器队列状态变化信号
+     * @param queueDepth 当前队列深度
+     */
+    void queueDepthChanged(int queueDepth);
+
+    /**
+     * @brief 请求即将重试信号
+     * @param requestId 请求ID
+     * @param attempt 第几次重试（从1开始）
+     * @param delayMs 重试前的等待时间（毫秒）
      */
-    void requestError(const QString &error, const QString &url);
+    void requestRetrying(quint64 requestId, int attempt, int delayMs);
 
 private slots:
     void onReplyFinished();
+    void dispatchPending();
 
 private:
+    /**
+     * @struct PendingRequest
+     * @brief 等待令牌的请求
+     */
+    struct PendingRequest {
+        quint64 id = 0;                 ///< 请求ID
+        RequestPriority priority = RequestPriority::Interactive;  ///< 请求优先级
+        QNetworkRequest request;        ///< 已构建好的网络请求
+        QByteArray method;              ///< HTTP方法
+        QByteArray data;                ///< 请求体
+        bool useCache = false;          ///< 是否允许使用响应缓存
+        qint64 enqueuedAt = 0;          ///< 入队时间（相对m_clock，毫秒）
+        int attempt = 0;                ///< 已重试次数
+        qint64 deadlineAt = 0;          ///< 总时限（相对m_clock，毫秒），0表示不限
+    };
+
     QNetworkAccessManager *m_networkManager;
-    
-    QNetworkRequest createRequest(const QString &url, const QString &userAgent) const;
+    ResponseCache *m_cache = nullptr;           ///< 磁盘响应缓存（由QNAM持有）
+
+    // 令牌桶调度器状态
+    std::array<QQueue<PendingRequest>, REQUEST_PRIORITY_COUNT> m_pendingQueues;  ///< 各优先级的等待队列
+    std::array<int, REQUEST_PRIORITY_COUNT> m_weightCredits{};  ///< 加权轮转中各优先级剩余的配额
+    SchedulingPolicy m_policy = SchedulingPolicy::Weighted;    ///< 优先级调度策略
+    QTimer *m_dispatchTimer;                    ///< 下一个令牌可用时触发的定时器
+    QElapsedTimer m_clock;                      ///< 单调时钟
+    std::function<qint64()> m_clockOverride;    ///< 替换m_clock的外部时钟，为空时不使用
+    double m_tokens = 0.0;                      ///< 当前可用令牌数
+    qint64 m_lastRefillMs = 0;                  ///< 上次补充令牌的时间
+    int m_rateIntervalMs = 1000;                ///< 令牌补充间隔（毫秒）
+    int m_burst = 1;                            ///< 令牌桶容量
+    bool m_rateLimitConfigured = false;         ///< 是否已配置过速率限制（首次配置时装满令牌桶）
+    quint64 m_nextRequestId = 1;                ///< 下一个请求ID
+    SchedulerMetrics m_metrics;                 ///< 调度统计
+
+    // 重试状态
+    QHash<QNetworkReply*, PendingRequest> m_activeReplies;  ///< 已发送、等待完成的请求
+    QHash<quint64, PendingRequest> m_delayedRetries;        ///< 等待退避结束的重试请求
+    qint64 m_throttledUntilMs = 0;              ///< 服务器限流结束时间（相对m_clock）
+    bool m_dispatchPaused = false;              ///< 下游要求暂停发送
+    int m_maxRetries = 3;                       ///< 最大重试次数
+    int m_retryDelayMs = 1000;                  ///< 退避基础间隔（毫秒）
+    int m_timeoutMs = 60000;                    ///< 单次传输超时（毫秒）
+    int m_deadlineMs = 120000;                  ///< 单个请求的总时限（毫秒）
+
+    quint64 enqueueRequest(const QNetworkRequest &request, const QByteArray &method,
+                           const QByteArray &data, RequestPriority priority,
+                           bool useCache = false);
+    void setupCache();
+    void loadRetryConfig();
+    FailureKind classifyFailure(QNetworkReply *reply) const;
+    int retryAfterMs(QNetworkReply *reply) const;
+    int backoffDelayMs(int attempt) const;
+    bool scheduleRetry(const PendingRequest &pending, QNetworkReply *reply, FailureKind kind);
+    void requeueRetry(quint64 requestId);
+    qint64 nowMs() const;
+    void refillTokens();
+    int pendingCount() const;
+    int nextQueueIndex();
+    void startRequest(const PendingRequest &pending);
+
+    QNetworkRequest createRequest(const QString &url, const QString &userAgent, bool useCache = false) const;
     QNetworkRequest createAuthenticatedRequest(const QString &url, const QString &userAgent,
                                               const QString &username, const QString &password) const;
 };
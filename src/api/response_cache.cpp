@@ -0,0 +1,95 @@
+#include "response_cache.h"
+#include "api_utils.h"
+#include <QDateTime>
+#include <QDebug>
+
+ResponseCache::ResponseCache(QObject *parent)
+    : QNetworkDiskCache(parent)
+{
+    // 默认新鲜期：地区、乐器等几乎不变的实体保留更久，
+    // 发行、录音等编辑频繁的实体较短
+    const int hour = 3600;
+    m_entityTtls.insert(static_cast<int>(EntityType::Area), 7 * 24 * hour);
+    m_entityTtls.insert(static_cast<int>(EntityType::Instrument), 7 * 24 * hour);
+    m_entityTtls.insert(static_cast<int>(EntityType::Artist), 24 * hour);
+    m_entityTtls.insert(static_cast<int>(EntityType::Label), 24 * hour);
+    m_entityTtls.insert(static_cast<int>(EntityType::Place), 24 * hour);
+    m_entityTtls.insert(static_cast<int>(EntityType::Series), 24 * hour);
+    m_entityTtls.insert(static_cast<int>(EntityType::Work), 24 * hour);
+    m_entityTtls.insert(static_cast<int>(EntityType::ReleaseGroup), 12 * hour);
+    m_entityTtls.insert(static_cast<int>(EntityType::Release), 12 * hour);
+    m_entityTtls.insert(static_cast<int>(EntityType::Recording), 12 * hour);
+    m_entityTtls.insert(static_cast<int>(EntityType::Event), 6 * hour);
+}
+
+void ResponseCache::setEntityTtl(EntityType type, int seconds)
+{
+    m_entityTtls.insert(static_cast<int>(type), qMax(0, seconds));
+}
+
+void ResponseCache::setDefaultTtl(int seconds)
+{
+    m_defaultTtl = qMax(0, seconds);
+}
+
+int ResponseCache::ttlForUrl(const QUrl &url) const
+{
+    // 查询URL形如 /ws/2/<entity>/<mbid>
+    const QStringList segments = url.path().split('/', Qt::SkipEmptyParts);
+    const int count = segments.size();
+    if (count >= 2 && Validator::isValidMbid(segments.at(count - 1))) {
+        const EntityType type = EntityUtils::stringToEntityType(segments.at(count - 2));
+        auto it = m_entityTtls.constFind(static_cast<int>(type));
+        if (it != m_entityTtls.constEnd()) {
+            return it.value();
+        }
+    }
+
+    return m_defaultTtl;
+}
+
+bool ResponseCache::isFresh(const QUrl &url)
+{
+    const QNetworkCacheMetaData meta = metaData(url);
+    return meta.isValid()
+        && meta.expirationDate().isValid()
+        && meta.expirationDate() > QDateTime::currentDateTimeUtc();
+}
+
+QIODevice *ResponseCache::prepare(const QNetworkCacheMetaData &metaData)
+{
+    return QNetworkDiskCache::prepare(applyTtl(metaData));
+}
+
+void ResponseCache::updateMetaData(const QNetworkCacheMetaData &metaData)
+{
+    // 304响应会走到这里，重新开始新鲜期
+    QNetworkDiskCache::updateMetaData(applyTtl(metaData));
+}
+
+QNetworkCacheMetaData ResponseCache::applyTtl(const QNetworkCacheMetaData &metaData) const
+{
+    if (!metaData.isValid()) {
+        return metaData;
+    }
+
+    const int ttl = ttlForUrl(metaData.url());
+
+    QNetworkCacheMetaData result = metaData;
+    result.setExpirationDate(QDateTime::currentDateTimeUtc().addSecs(ttl));
+
+    // 用客户端的新鲜期替换服务器的Cache-Control，
+    // 否则no-cache等指令会让QNetworkAccessManager每次都重新验证
+    QNetworkCacheMetaData::RawHeaderList headers;
+    for (const auto &header : metaData.rawHeaders()) {
+        if (header.first.compare("Cache-Control", Qt::CaseInsensitive) != 0
+            && header.first.compare("Pragma", Qt::CaseInsensitive) != 0
+            && header.first.compare("Expires", Qt::CaseInsensitive) != 0) {
+            headers.append(header);
+        }
+    }
+    headers.append(qMakePair(QByteArray("Cache-Control"), "max-age=" + QByteArray::number(ttl)));
+    result.setRawHeaders(headers);
+
+    return result;
+}
@@ -0,0 +1,68 @@
+#ifndef RESPONSE_CACHE_H
+#define RESPONSE_CACHE_H
+
+#include <QNetworkDiskCache>
+#include <QHash>
+#include <QUrl>
+#include "../core/types.h"
+
+/**
+ * @class ResponseCache
+ * @brief 查询接口的持久化HTTP响应缓存
+ *
+ * 基于QNetworkDiskCache，为详情查询、浏览等GET请求提供磁盘缓存：
+ * - 按实体类型设置新鲜期（TTL），新鲜期内直接从磁盘返回，不消耗网络和速率配额
+ * - 过期后由QNetworkAccessManager自动携带If-None-Match / If-Modified-Since
+ *   发起条件请求，服务器返回304时只刷新元数据
+ * - 超出容量上限时优先淘汰最久未写入的条目
+ *
+ * 搜索请求不经过缓存（由NetworkManager在请求上关闭缓存属性）。
+ */
+class ResponseCache : public QNetworkDiskCache
+{
+    Q_OBJECT
+
+public:
+    explicit ResponseCache(QObject *parent = nullptr);
+
+    /**
+     * @brief 设置某个实体类型的新鲜期
+     * @param type 实体类型
+     * @param seconds 新鲜期（秒）
+     */
+    void setEntityTtl(EntityType type, int seconds);
+
+    /**
+     * @brief 设置未单独配置的请求（浏览、通用查询等）的新鲜期
+     * @param seconds 新鲜期（秒）
+     */
+    void setDefaultTtl(int seconds);
+
+    /**
+     * @brief 根据URL计算新鲜期
+     * @param url 请求URL
+     * @return 新鲜期（秒）
+     *
+     * 形如 .../ws/2/<entity>/<mbid> 的查询使用实体类型的新鲜期，
+     * 其余请求（浏览、DiscID等）使用默认新鲜期。
+     */
+    int ttlForUrl(const QUrl &url) const;
+
+    /**
+     * @brief 检查缓存中是否有仍在新鲜期内的条目
+     * @param url 请求URL
+     */
+    bool isFresh(const QUrl &url);
+
+    // QNetworkDiskCache重载：在写入和304刷新时应用客户端的新鲜期策略
+    QIODevice *prepare(const QNetworkCacheMetaData &metaData) override;
+    void updateMetaData(const QNetworkCacheMetaData &metaData) override;
+
+private:
+    QNetworkCacheMetaData applyTtl(const QNetworkCacheMetaData &metaData) const;
+
+    QHash<int, int> m_entityTtls;       ///< 实体类型 -> 新鲜期（秒）
+    int m_defaultTtl = 3600;            ///< 默认新鲜期（秒）
+};
+
+#endif // RESPONSE_CACHE_H
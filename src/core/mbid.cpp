@@ -0,0 +1,146 @@
+#include "mbid.h"
+#include <QDebug>
+#include <QtEndian>
+#include <cstring>
+
+namespace {
+
+/**
+ * @brief 把16位值复制到64位字的4个通道
+ */
+constexpr quint64 lanes(quint64 value)
+{
+    return value * 0x0001000100010001ull;
+}
+
+constexpr quint64 LANE_HIGH_BITS = lanes(0x8000);
+
+/**
+ * @brief 每个通道是否不小于n，结果在各通道最高位
+ *
+ * 调用方已保证通道值小于0x80，置位最高位后相减不会向相邻通道借位。
+ */
+constexpr quint64 lanesAtLeast(quint64 word, quint16 n)
+{
+    return ((word | LANE_HIGH_BITS) - lanes(n)) & LANE_HIGH_BITS;
+}
+
+/**
+ * @brief 同时解码4个十六进制字符
+ * @param chars 4个UTF-16字符
+ * @return 16位数值（第一个字符在最高位）；任一字符不是十六进制数字时返回-1
+ */
+int decodeHexQuad(const QChar *chars)
+{
+    quint64 word;
+    std::memcpy(&word, chars, sizeof(word));
+
+    // 非ASCII字符
+    if (word & lanes(0xFF80)) {
+        return -1;
+    }
+
+    const quint64 digit = lanesAtLeast(word, '0') & ~lanesAtLeast(word, '9' + 1);
+    const quint64 upper = lanesAtLeast(word, 'A') & ~lanesAtLeast(word, 'F' + 1);
+    const quint64 lower = lanesAtLeast(word, 'a') & ~lanesAtLeast(word, 'f' + 1);
+    const quint64 letter = upper | lower;
+    if ((digit | letter) != LANE_HIGH_BITS) {
+        return -1;
+    }
+
+    // 数字取低4位；字母的低4位是1..6，加9得到10..15
+    const quint64 nibbles = (word & lanes(0x000F)) + (letter >> 15) * 9;
+
+#if Q_BYTE_ORDER == Q_LITTLE_ENDIAN
+    return int(((nibbles & 0xF) << 12) | (((nibbles >> 16) & 0xF) << 8)
+               | (((nibbles >> 32) & 0xF) << 4) | ((nibbles >> 48) & 0xF));
+#else
+    return int((((nibbles >> 48) & 0xF) << 12) | (((nibbles >> 32) & 0xF) << 8)
+               | (((nibbles >> 16) & 0xF) << 4) | (nibbles & 0xF));
+#endif
+}
+
+// 8组4个十六进制字符在文本中的位置（跳过8、13、18、23处的连字符）
+constexpr int QUAD_OFFSETS[8] = {0, 4, 9, 14, 19, 24, 28, 32};
+constexpr int DASH_OFFSETS[4] = {8, 13, 18, 23};
+
+} // namespace
+
+Mbid Mbid::fromString(QStringView text, bool *ok) noexcept
+{
+    if (ok) {
+        *ok = false;
+    }
+    if (text.size() != STRING_LENGTH) {
+        return Mbid();
+    }
+    for (int offset : DASH_OFFSETS) {
+        if (text[offset] != u'-') {
+            return Mbid();
+        }
+    }
+
+    quint64 words[2] = {0, 0};
+    for (int i = 0; i < 8; ++i) {
+        const int quad = decodeHexQuad(text.data() + QUAD_OFFSETS[i]);
+        if (quad < 0) {
+            return Mbid();
+        }
+        words[i / 4] = (words[i / 4] << 16) | quint64(quad);
+    }
+
+    if (ok) {
+        *ok = true;
+    }
+    return Mbid(words[0], words[1]);
+}
+
+bool Mbid::isValid(QStringView text) noexcept
+{
+    bool ok = false;
+    fromString(text, &ok);
+    return ok;
+}
+
+QString Mbid::toString() const
+{
+    if (isNull()) {
+        return QString();
+    }
+
+    static constexpr char HEX_DIGITS[] = "0123456789abcdef";
+
+    QString result(STRING_LENGTH, Qt::Uninitialized);
+    QChar *out = result.data();
+    int dash = 0;
+    for (int i = 0; i < 32; ++i) {
+        if (dash < 4 && (out - result.constData()) == DASH_OFFSETS[dash]) {
+            *out++ = u'-';
+            ++dash;
+        }
+        const quint64 word = i < 16 ? m_high : m_low;
+        *out++ = QLatin1Char(HEX_DIGITS[(word >> (60 - 4 * (i % 16))) & 0xF]);
+    }
+    return result;
+}
+
+Mbid Mbid::fromRfc4122(QByteArrayView bytes) noexcept
+{
+    if (bytes.size() != 16) {
+        return Mbid();
+    }
+    return Mbid(qFromBigEndian<quint64>(bytes.data()), qFromBigEndian<quint64>(bytes.data() + 8));
+}
+
+QByteArray Mbid::toRfc4122() const
+{
+    QByteArray bytes(16, Qt::Uninitialized);
+    qToBigEndian(m_high, bytes.data());
+    qToBigEndian(m_low, bytes.data() + 8);
+    return bytes;
+}
+
+QDebug operator<<(QDebug debug, const Mbid &mbid)
+{
+    return debug << mbid.toString();
+}
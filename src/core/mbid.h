@@ -0,0 +1,123 @@
+#ifndef MBID_H
+#define MBID_H
+
+#include <QByteArray>
+#include <QByteArrayView>
+#include <QString>
+#include <QStringView>
+#include <QHashFunctions>
+#include <QMetaType>
+#include <functional>
+
+class QDebug;
+
+/**
+ * @class Mbid
+ * @brief MusicBrainz标识符（UUID）的128位值类型
+ *
+ * MBID的文本形式是36个字符（xxxxxxxx-xxxx-xxxx-xxxx-xxxxxxxxxxxx），作为QString
+ * 保存约需100字节并且每次比较、哈希都要逐字符处理。Mbid只保存16字节的原始值，
+ * 用于集合和映射的键时比较和哈希都只涉及两个64位整数。
+ *
+ * - fromString()一次解码4个字符（SWAR：把4个UTF-16字符当作一个64位字并行校验和转换），
+ *   同时完成格式验证，取代正则表达式
+ * - toString()直接写入预分配的字符串缓冲区，输出小写形式
+ * - 提供qHash()和std::hash特化，可直接用于QHash/QSet和标准容器
+ *
+ * 默认构造的Mbid为空值（isNull()），表示"没有MBID"，例如CD占位符等
+ * 不使用UUID作为标识符的实体。
+ *
+ * **使用示例：**
+ * ```cpp
+ * bool ok = false;
+ * const Mbid id = Mbid::fromString(item->getId(), &ok);
+ * if (ok) {
+ *     m_loadingItems.insert(id);
+ * }
+ * ```
+ */
+class Mbid
+{
+public:
+    static constexpr int STRING_LENGTH = 36;    ///< 文本形式的长度
+
+    constexpr Mbid() noexcept = default;
+    constexpr Mbid(quint64 high, quint64 low) noexcept : m_high(high), m_low(low) {}
+
+    /**
+     * @brief 解析文本形式的MBID
+     * @param text 36个字符的UUID文本，十六进制数字不区分大小写
+     * @param ok 可选，返回格式是否正确
+     * @return 解析结果；格式不正确时返回空值
+     */
+    static Mbid fromString(QStringView text, bool *ok = nullptr) noexcept;
+
+    /**
+     * @brief 检查文本是否为格式正确的MBID
+     */
+    static bool isValid(QStringView text) noexcept;
+
+    /**
+     * @brief 转换为文本形式（小写）
+     * @return 36个字符的UUID文本；空值返回空字符串
+     */
+    QString toString() const;
+
+    /**
+     * @brief 按RFC 4122的字节序从16字节的二进制形式构造
+     * @return 长度不是16字节时返回空值
+     */
+    static Mbid fromRfc4122(QByteArrayView bytes) noexcept;
+
+    /**
+     * @brief 转换为RFC 4122字节序的16字节二进制形式（与QUuid::toRfc4122一致）
+     */
+    QByteArray toRfc4122() const;
+
+    constexpr bool isNull() const noexcept { return (m_high | m_low) == 0; }
+    constexpr quint64 high() const noexcept { return m_high; }     ///< 前8字节（大端序数值）
+    constexpr quint64 low() const noexcept { return m_low; }       ///< 后8字节（大端序数值）
+
+    friend constexpr bool operator==(const Mbid &a, const Mbid &b) noexcept
+    {
+        return a.m_high == b.m_high && a.m_low == b.m_low;
+    }
+    friend constexpr bool operator!=(const Mbid &a, const Mbid &b) noexcept { return !(a == b); }
+
+    /**
+     * @brief 与文本形式的字典序一致
+     */
+    friend constexpr bool operator<(const Mbid &a, const Mbid &b) noexcept
+    {
+        return a.m_high != b.m_high ? a.m_high < b.m_high : a.m_low < b.m_low;
+    }
+
+private:
+    quint64 m_high = 0;
+    quint64 m_low = 0;
+};
+
+inline size_t qHash(const Mbid &mbid, size_t seed = 0) noexcept
+{
+    return qHashMulti(seed, mbid.high(), mbid.low());
+}
+
+/**
+ * @brief 调试输出（与QString形式的ID一致）
+ */
+QDebug operator<<(QDebug debug, const Mbid &mbid);
+
+namespace std {
+template <>
+struct hash<Mbid> {
+    size_t operator()(const Mbid &mbid) const noexcept
+    {
+        // UUID的各位本身近似随机，混合两半即可
+        return static_cast<size_t>(mbid.high() ^ (mbid.low() * 0x9E3779B97F4A7C15ull));
+    }
+};
+} // namespace std
+
+Q_DECLARE_METATYPE(Mbid)
+
+#endif // MBID_H
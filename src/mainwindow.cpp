@@ -226,10 +226,18 @@ void MainWindow::setupConnections()
     // SearchService 连接
     connect(m_searchService, &SearchService::searchCompleted, 
             this, &MainWindow::onSearchCompleted);
+    connect(m_searchService, &SearchService::searchPartialResults,
+            this, &MainWindow::onSearchPartialResults);
+    connect(m_searchService, &SearchService::resultsPageFetched,
+            this, &MainWindow::onResultsPageFetched);
+    connect(m_searchService, &SearchService::resultsPageFailed,
+            this, &MainWindow::onResultsPageFailed);
     connect(m_searchService, &SearchService::searchFailed,
             this, &MainWindow::onSearchFailed);
     
     // EntityDetailManager 连接
+    // 详情页由用户双击打开，使用交互优先级
+    m_detailManager->setRequestPriority(RequestPriority::Interactive);
     connect(m_detailManager, &EntityDetailManager::entityDetailsLoaded,
             this, &MainWindow::onEntityDetailsLoaded);
 }
@@ -252,33 +260,79 @@ void MainWindow::onAdvancedSearchRequested(const SearchParameters &params)
 
 void MainWindow::onSearchCompleted(const QList<QSharedPointer<ResultItem>> &results, const SearchResults &stats)
 {
-    // 创建或更新搜索结果标签页
-    SearchResultTab *resultTab = nullptr;
+    // 设置搜索结果（已通过部分结果显示的行只追加剩余部分）
+    SearchResultTab *resultTab = currentSearchResultTab();
+    resultTab->setResults(results, stats, m_searchService->getItemsPerPage());
     
+    // 更新状态栏
+    if (results.isEmpty()) {
+        statusBar()->showMessage(tr("No results found"));
+    } else {
+        statusBar()->showMessage(tr("Found %1 results").arg(stats.totalCount));
+    }
+}
+
+void MainWindow::onSearchPartialResults(const QList<QSharedPointer<ResultItem>> &results, bool firstChunk)
+{
+    currentSearchResultTab()->addPartialResults(results, firstChunk);
+}
+
+SearchResultTab* MainWindow::currentSearchResultTab()
+{
     // 检查是否已有相同搜索的标签页
-    QString tabTitle = generateTabTitle(m_currentSearchParams.query, m_currentSearchParams.type);
+    if (SearchResultTab *resultTab = findSearchResultTab()) {
+        return resultTab;
+    }
+    
+    // 如果没有找到，创建新的标签页
+    SearchResultTab *resultTab = createSearchResultTab(m_currentSearchParams.query, m_currentSearchParams.type);
+    int tabIndex = m_mainTabWidget->addTab(resultTab, generateTabTitle(m_currentSearchParams.query, m_currentSearchParams.type));
+    m_mainTabWidget->setCurrentIndex(tabIndex);
+    return resultTab;
+}
+
+SearchResultTab* MainWindow::findSearchResultTab()
+{
+    const QString tabTitle = generateTabTitle(m_currentSearchParams.query, m_currentSearchParams.type);
     for (int i = 0; i < m_mainTabWidget->count(); ++i) {
         if (m_mainTabWidget->tabText(i) == tabTitle) {
-            resultTab = qobject_cast<SearchResultTab*>(m_mainTabWidget->widget(i));
-            break;
+            if (auto *resultTab = qobject_cast<SearchResultTab*>(m_mainTabWidget->widget(i))) {
+                return resultTab;
+            }
         }
     }
-    
-    // 如果没有找到，创建新的标签页
-    if (!resultTab) {
-        resultTab = createSearchResultTab(m_currentSearchParams.query, m_currentSearchParams.type);
-        int tabIndex = m_mainTabWidget->addTab(resultTab, tabTitle);
-        m_mainTabWidget->setCurrentIndex(tabIndex);
+    return nullptr;
+}
+
+void MainWindow::onResultsPageRequested(int offset)
+{
+    // 页面只能从当前搜索加载；其他标签页的旧搜索结果不再滚动加载
+    auto *resultTab = qobject_cast<SearchResultTab*>(sender());
+    if (!resultTab || resultTab != findSearchResultTab()) {
+        if (resultTab) {
+            resultTab->setResultsPageFailed(offset);
+        }
+        return;
     }
     
-    // 设置搜索结果
-    resultTab->setResults(results, stats);
-    
-    // 更新状态栏
-    if (results.isEmpty()) {
-        statusBar()->showMessage(tr("No results found"));
-    } else {
-        statusBar()->showMessage(tr("Found %1 results").arg(stats.totalCount));
+    if (m_searchService->fetchResultsPage(offset) == 0) {
+        resultTab->setResultsPageFailed(offset);
+    }
+}
+
+void MainWindow::onResultsPageFetched(const QList<QSharedPointer<ResultItem>> &results, int totalCount, int offset)
+{
+    Q_UNUSED(totalCount)
+    if (SearchResultTab *resultTab = findSearchResultTab()) {
+        resultTab->addResultsPage(offset, results);
+    }
+}
+
+void MainWindow::onResultsPageFailed(int offset, const QString &error)
+{
+    statusBar()->showMessage(tr("Failed to load results: %1").arg(error), 3000);
+    if (SearchResultTab *resultTab = findSearchResultTab()) {
+        resultTab->setResultsPageFailed(offset);
     }
 }
 
@@ -301,6 +355,8 @@ SearchResultTab* MainWindow::createSearchResultTab(const QString &query, EntityT
             this, &MainWindow::onItemDoubleClicked);
     connect(tab, &SearchResultTab::prevPageRequested,
             this, &MainWindow::onPrevPageRequested);
+    connect(tab, &SearchResultTab::resultsPageRequested,
+            this, &MainWindow::onResultsPageRequested);
     connect(tab, &SearchResultTab::nextPageRequested,
             this, &MainWindow::onNextPageRequested);
     connect(tab, &SearchResultTab::itemDetailsUpdated,
@@ -353,7 +409,9 @@ void MainWindow::onItemDoubleClicked(const QSharedPointer<ResultItem> &item)
     m_mainTabWidget->setCurrentIndex(tabIndex);
     
     // 将ItemDetailTab添加到映射中
-    m_itemDetailTabs[item->getId()] = detailTab;
+    if (!item->getMbid().isNull()) {
+        m_itemDetailTabs.insert(item->getMbid(), detailTab);
+    }
     
     // 使用MainWindow的EntityDetailManager加载详细信息
     QList<QSharedPointer<ResultItem>> singleItem = {item};
@@ -368,11 +426,20 @@ void MainWindow::onTabCloseRequested(int index)
     if (index >= 0 && index < m_mainTabWidget->count()) {
         QWidget *widget = m_mainTabWidget->widget(index);
         
-        // 如果是ItemDetailTab，从映射中移除
+        // 如果是ItemDetailTab，从映射中移除，并取消尚未完成的详情加载
         ItemDetailTab *detailTab = qobject_cast<ItemDetailTab*>(widget);
         if (detailTab) {
-            QString itemId = detailTab->getItemId();
+            const Mbid itemId = detailTab->getItemMbid();
             m_itemDetailTabs.remove(itemId);
+            m_detailManager->cancelEntityDetails(itemId);
+        }
+        
+        // 关闭的是正在等待结果的搜索标签页时，取消搜索请求
+        // （标签页自己的详情管理器随标签页销毁，其请求会自动取消）
+        if (qobject_cast<SearchResultTab*>(widget) && m_searchService->isSearching()
+            && m_mainTabWidget->tabText(index) == generateTabTitle(m_currentSearchParams.query, m_currentSearchParams.type)) {
+            m_searchService->cancelSearch();
+            statusBar()->clearMessage();
         }
         
         m_mainTabWidget->removeTab(index);
@@ -441,7 +508,7 @@ void MainWindow::onItemDetailsUpdated(const QSharedPointer<ResultItem> &item)
     }
     
     // 查找对应的ItemDetailTab并刷新它
-    auto it = m_itemDetailTabs.find(item->getId());
+    auto it = m_itemDetailTabs.find(item->getMbid());
     if (it != m_itemDetailTabs.end()) {
         ItemDetailTab *detailTab = it.value();
         if (detailTab) {
@@ -477,7 +544,7 @@ void MainWindow::onCopyId(const QString &entityId)
     statusBar()->showMessage(tr("Copied ID to clipboard: %1").arg(entityId), 2000);
 }
 
-void MainWindow::onEntityDetailsLoaded(const QString &entityId, const QVariantMap &details)
+void MainWindow::onEntityDetailsLoaded(const Mbid &entityId, const EntityPayload &details)
 {
     // 查找对应的ItemDetailTab
     auto it = m_itemDetailTabs.find(entityId);
@@ -487,9 +554,14 @@ void MainWindow::onEntityDetailsLoaded(const QString &entityId, const QVariantMa
         // 更新ResultItem的详细数据
         QSharedPointer<ResultItem> item = detailTab->getItem();
         if (item) {
-            // 设置详细数据到ResultItem
-            for (auto detailIt = details.begin(); detailIt != details.end(); ++detailIt) {
-                item->setDetailProperty(detailIt.key(), detailIt.value());
+            // 设置详细数据到ResultItem，字段直接从共享的CBOR数据转换
+            details.applyTo(*item);
+            
+            // 条目与搜索结果列表共享，刷新列表中对应的行
+            for (int i = 0; i < m_mainTabWidget->count(); ++i) {
+                if (auto *resultTab = qobject_cast<SearchResultTab*>(m_mainTabWidget->widget(i))) {
+                    resultTab->refreshEntity(entityId);
+                }
             }
             
             // 通知ItemDetailTab刷新显示
@@ -6,7 +6,9 @@
 #include <QSharedPointer>
 #include <QSplitter>
 #include <QDockWidget>
+#include <QHash>
 #include "core/types.h"
+#include "core/mbid.h"
 #include "models/resultitem.h"
 #include "ui/advancedsearchwidget.h"
 #include "services/searchservice.h"
@@ -76,8 +78,8 @@ private:
     SearchParameters m_currentSearchParams; ///< 当前搜索参数
     
     // 详细标签页映射 - 用于跟踪ItemDetailTab和对应的ResultItem
-    // Key: entityId, Value: ItemDetailTab实例指针
-    QMap<QString, ItemDetailTab*> m_itemDetailTabs;
+    // Key: 实体MBID, Value: ItemDetailTab实例指针
+    QHash<Mbid, ItemDetailTab*> m_itemDetailTabs;
 
     // =============================================================================
     // UI 初始化方法
@@ -108,6 +110,8 @@ private:
     
     // 标签页管理
     SearchResultTab* createSearchResultTab(const QString &query, EntityType type);
+    SearchResultTab* currentSearchResultTab();   // 当前搜索对应的结果标签页，不存在时创建
+    SearchResultTab* findSearchResultTab();       // 当前搜索对应的结果标签页，不存在时返回nullptr
     ItemDetailTab* createItemDetailTab(const QSharedPointer<ResultItem> &item);
     void closeTab(int index);
     QString generateTabTitle(const QString &query, EntityType type);
@@ -116,6 +120,10 @@ private:
 private slots:
     void onAdvancedSearchRequested(const SearchParameters &params);
     void onSearchCompleted(const QList<QSharedPointer<ResultItem>> &results, const SearchResults &stats);
+    void onSearchPartialResults(const QList<QSharedPointer<ResultItem>> &results, bool firstChunk);
+    void onResultsPageRequested(int offset);
+    void onResultsPageFetched(const QList<QSharedPointer<ResultItem>> &results, int totalCount, int offset);
+    void onResultsPageFailed(int offset, const QString &error);
     void onSearchFailed(const QString &error);
     void onItemDoubleClicked(const QSharedPointer<ResultItem> &item);
     void onTabCloseRequested(int index);
@@ -129,7 +137,7 @@ private slots:
     void onCopyId(const QString &entityId);
     
     // 详细信息加载相关槽函数
-    void onEntityDetailsLoaded(const QString &entityId, const QVariantMap &details);
+    void onEntityDetailsLoaded(const Mbid &entityId, const EntityPayload &details);
     
     // 设置相关槽函数
     void on_actionAbout_triggered();
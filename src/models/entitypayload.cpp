@@ -0,0 +1,179 @@
+#include "entitypayload.h"
+#include "resultitem.h"
+#include "../api/api_utils.h"
+#include <QCborValue>
+
+EntityPayload EntityPayload::fromItem(const ResultItem &item)
+{
+    QCborMap map;
+    map.insert(VersionKey, FORMAT_VERSION);
+
+    // MBID只保存16字节的原始值（MusicBrainz的ID总是小写形式）
+    const Mbid mbid = item.getMbid();
+    if (!mbid.isNull()) {
+        map.insert(IdKey, mbid.toRfc4122());
+    } else {
+        map.insert(IdKey, item.getId());
+    }
+    map.insert(NameKey, item.getName());
+    map.insert(TypeKey, qint64(item.getType()));
+    if (!item.getDisambiguation().isEmpty()) {
+        map.insert(DisambiguationKey, item.getDisambiguation());
+    }
+    if (item.getScore() != 0) {
+        map.insert(ScoreKey, item.getScore());
+    }
+    map.insert(DetailsKey, QCborMap::fromVariantMap(item.getDetailData()));
+
+    return EntityPayload(map);
+}
+
+EntityPayload EntityPayload::fromCbor(const QByteArray &data, QString *error)
+{
+    QCborParserError parseError;
+    const QCborValue value = QCborValue::fromCbor(data, &parseError);
+    if (parseError.error != QCborError::NoError) {
+        if (error) {
+            *error = parseError.errorString();
+        }
+        return EntityPayload();
+    }
+
+    const QCborMap map = value.toMap();
+    if (!value.isMap() || map.value(VersionKey).toInteger() != FORMAT_VERSION) {
+        if (error) {
+            *error = QStringLiteral("Unsupported entity payload format");
+        }
+        return EntityPayload();
+    }
+
+    if (error) {
+        error->clear();
+    }
+    return EntityPayload(map);
+}
+
+QByteArray EntityPayload::toCbor() const
+{
+    return m_map.toCborValue().toCbor();
+}
+
+bool EntityPayload::isNull() const
+{
+    return m_map.isEmpty();
+}
+
+QString EntityPayload::id() const
+{
+    const QCborValue value = m_map.value(IdKey);
+    if (value.isByteArray()) {
+        return Mbid::fromRfc4122(value.toByteArray()).toString();
+    }
+    return value.toString();
+}
+
+Mbid EntityPayload::mbid() const
+{
+    const QCborValue value = m_map.value(IdKey);
+    return value.isByteArray() ? Mbid::fromRfc4122(value.toByteArray()) : Mbid();
+}
+
+QString EntityPayload::name() const
+{
+    return m_map.value(NameKey).toString();
+}
+
+EntityType EntityPayload::type() const
+{
+    return static_cast<EntityType>(m_map.value(TypeKey).toInteger(qint64(EntityType::Unknown)));
+}
+
+QString EntityPayload::disambiguation() const
+{
+    return m_map.value(DisambiguationKey).toString();
+}
+
+int EntityPayload::score() const
+{
+    return int(m_map.value(ScoreKey).toInteger());
+}
+
+QCborMap EntityPayload::details() const
+{
+    return m_map.value(DetailsKey).toMap();
+}
+
+bool EntityPayload::contains(const QString &key) const
+{
+    return details().contains(key);
+}
+
+QVariant EntityPayload::value(const QString &key) const
+{
+    const QCborMap fields = details();
+    auto it = fields.constFind(key);
+    return it != fields.constEnd() ? it.value().toVariant() : QVariant();
+}
+
+QStringList EntityPayload::keys() const
+{
+    const QCborMap fields = details();
+    QStringList result;
+    result.reserve(fields.size());
+    for (auto it = fields.constBegin(); it != fields.constEnd(); ++it) {
+        result.append(it.key().toString());
+    }
+    return result;
+}
+
+QVariantMap EntityPayload::toVariantMap() const
+{
+    if (isNull()) {
+        return QVariantMap();
+    }
+
+    QVariantMap result;
+    result["id"] = id();
+    result["name"] = name();
+    result["type"] = EntityUtils::entityTypeToString(type());
+    result["disambiguation"] = disambiguation();
+
+    // 详细数据中的同名字段优先（如艺术家的type）
+    const QCborMap fields = details();
+    for (auto it = fields.constBegin(); it != fields.constEnd(); ++it) {
+        result.insert(it.key().toString(), it.value().toVariant());
+    }
+    return result;
+}
+
+void EntityPayload::applyTo(ResultItem &item, const QVariantMap &overrides) const
+{
+    if (isNull()) {
+        return;
+    }
+
+    QVariantMap merged;
+    const QCborMap fields = details();
+    for (auto it = fields.constBegin(); it != fields.constEnd(); ++it) {
+        merged.insert(it.key().toString(), it.value().toVariant());
+    }
+    merged.insert(QStringLiteral("disambiguation"), disambiguation());
+    for (auto it = overrides.constBegin(); it != overrides.constEnd(); ++it) {
+        merged.insert(it.key(), it.value());
+    }
+
+    item.setDisambiguation(disambiguation());
+    item.mergeDetailData(merged);
+}
+
+QSharedPointer<ResultItem> EntityPayload::toItem() const
+{
+    if (isNull()) {
+        return nullptr;
+    }
+
+    auto item = QSharedPointer<ResultItem>::create(id(), name(), type());
+    item->setScore(score());
+    applyTo(*item);
+    return item;
+}
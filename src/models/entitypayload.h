@@ -0,0 +1,164 @@
+#ifndef ENTITYPAYLOAD_H
+#define ENTITYPAYLOAD_H
+
+#include <QByteArray>
+#include <QCborMap>
+#include <QMetaType>
+#include <QSharedPointer>
+#include <QStringList>
+#include <QVariant>
+#include <QVariantMap>
+#include "../core/types.h"
+#include "../core/mbid.h"
+
+class ResultItem;
+
+/**
+ * @class EntityPayload
+ * @brief 解析完成的实体的CBOR表示
+ *
+ * 详情响应在解析线程上编码一次，之后在处理器、API、详情管理器和界面之间
+ * 原样传递。内部是一个隐式共享的QCborMap，复制只增加引用计数（线程安全），
+ * 单个字段的访问（value()、details()）直接读取共享的CBOR数据，
+ * 不需要先转换成完整的QVariantMap。
+ *
+ * toCbor()/fromCbor()给出同一结构的二进制形式，可以直接作为磁盘缓存的格式。
+ *
+ * **编码结构（整数键，省略空值）：**
+ * ```
+ * {
+ *   0: 格式版本
+ *   1: ID（MBID为16字节二进制，其他ID为文本）
+ *   2: 名称
+ *   3: 实体类型（EntityType的整数值）
+ *   4: 消歧信息
+ *   5: 搜索评分
+ *   6: {详细数据的键: 值, ...}
+ * }
+ * ```
+ *
+ * 详细数据按QCborValue::fromVariant转换：映射和列表保持结构，
+ * QStringList解码后为QVariantList，整数解码后为qint64。
+ *
+ * **使用示例：**
+ * ```cpp
+ * const EntityPayload payload = EntityPayload::fromItem(*item);
+ * const QByteArray bytes = payload.toCbor();      // 写入缓存
+ *
+ * const EntityPayload cached = EntityPayload::fromCbor(bytes);
+ * if (!cached.isNull()) {
+ *     cached.applyTo(*existingItem);
+ * }
+ * ```
+ */
+class EntityPayload
+{
+public:
+    static constexpr int FORMAT_VERSION = 1;    ///< 当前编码格式版本
+
+    EntityPayload() = default;
+
+    /**
+     * @brief 编码一个结果项
+     * @param item 结果项，延迟字段会先被解码
+     */
+    static EntityPayload fromItem(const ResultItem &item);
+
+    /**
+     * @brief 从二进制形式解码
+     * @param data toCbor()的输出
+     * @param error 可选，返回解码失败的原因
+     * @return 解码结果；数据损坏或格式版本不符时返回空值
+     */
+    static EntityPayload fromCbor(const QByteArray &data, QString *error = nullptr);
+
+    /**
+     * @brief 编码为二进制形式
+     */
+    QByteArray toCbor() const;
+
+    /**
+     * @brief 是否为空（默认构造或解码失败）
+     */
+    bool isNull() const;
+
+    // =============================================================================
+    // 基本字段
+    // =============================================================================
+
+    QString id() const;                 ///< 实体ID的文本形式
+    Mbid mbid() const;                  ///< 实体MBID；ID不是UUID格式时为空值
+    QString name() const;               ///< 实体名称
+    EntityType type() const;            ///< 实体类型
+    QString disambiguation() const;     ///< 消歧信息
+    int score() const;                  ///< 搜索评分
+
+    // =============================================================================
+    // 详细数据
+    // =============================================================================
+
+    /**
+     * @brief 详细数据的CBOR视图（与本对象共享存储）
+     */
+    QCborMap details() const;
+
+    /**
+     * @brief 是否包含某个详细数据键
+     */
+    bool contains(const QString &key) const;
+
+    /**
+     * @brief 转换单个详细数据字段
+     * @return 字段值，不存在时返回无效的QVariant
+     */
+    QVariant value(const QString &key) const;
+
+    /**
+     * @brief 详细数据的所有键
+     */
+    QStringList keys() const;
+
+    /**
+     * @brief 转换为旧的扁平映射（id、name、type、disambiguation与详细数据同级）
+     *
+     * 供仍以QVariantMap处理详情的代码使用，会完整转换所有字段。
+     */
+    QVariantMap toVariantMap() const;
+
+    /**
+     * @brief 把消歧信息和详细数据写入已有的结果项
+     * @param item 结果项
+     * @param overrides 一并写入的其他字段（如由详细数据派生的显示字段），与详细数据同名时优先
+     *
+     * 每个字段直接从CBOR转换，全部字段一次合并到结果项中，同名字段被覆盖。
+     */
+    void applyTo(ResultItem &item, const QVariantMap &overrides = QVariantMap()) const;
+
+    /**
+     * @brief 构造新的结果项
+     * @return 结果项；空值返回空指针
+     */
+    QSharedPointer<ResultItem> toItem() const;
+
+private:
+    /**
+     * @brief 顶层映射的键
+     */
+    enum Key : qint64 {
+        VersionKey = 0,
+        IdKey = 1,
+        NameKey = 2,
+        TypeKey = 3,
+        DisambiguationKey = 4,
+        ScoreKey = 5,
+        DetailsKey = 6
+    };
+
+    explicit EntityPayload(const QCborMap &map) : m_map(map) {}
+
+    QCborMap m_map;     ///< 编码后的实体
+};
+
+Q_DECLARE_METATYPE(EntityPayload)
+
+#endif // ENTITYPAYLOAD_H
@@ -0,0 +1,315 @@
+#include "entityrecord.h"
+#include <QLatin1String>
+#include <cmath>
+#include <iterator>
+#include <type_traits>
+
+namespace {
+
+/**
+ * @brief 记录中的一个字段槽位：JSON键名和对应的成员
+ *
+ * text和number恰有一个非空。
+ */
+template <typename Record>
+struct FieldSlot {
+    QLatin1String key;
+    QString Record::*text;
+    qint64 Record::*number;
+};
+
+template <typename Record>
+struct RecordSlots;
+
+template <>
+struct RecordSlots<ArtistRecord> {
+    static constexpr FieldSlot<ArtistRecord> fields[] = {
+        {QLatin1String("type"), &ArtistRecord::type, nullptr},
+        {QLatin1String("sort-name"), &ArtistRecord::sortName, nullptr},
+        {QLatin1String("country"), &ArtistRecord::country, nullptr},
+        {QLatin1String("gender"), &ArtistRecord::gender, nullptr},
+    };
+};
+
+template <>
+struct RecordSlots<ReleaseRecord> {
+    static constexpr FieldSlot<ReleaseRecord> fields[] = {
+        {QLatin1String("date"), &ReleaseRecord::date, nullptr},
+        {QLatin1String("country"), &ReleaseRecord::country, nullptr},
+        {QLatin1String("status"), &ReleaseRecord::status, nullptr},
+        {QLatin1String("barcode"), &ReleaseRecord::barcode, nullptr},
+        {QLatin1String("packaging"), &ReleaseRecord::packaging, nullptr},
+    };
+};
+
+template <>
+struct RecordSlots<RecordingRecord> {
+    static constexpr FieldSlot<RecordingRecord> fields[] = {
+        {QLatin1String("length"), nullptr, &RecordingRecord::length},
+        {QLatin1String("first-release-date"), &RecordingRecord::firstReleaseDate, nullptr},
+    };
+};
+
+template <>
+struct RecordSlots<ReleaseGroupRecord> {
+    static constexpr FieldSlot<ReleaseGroupRecord> fields[] = {
+        {QLatin1String("primary-type"), &ReleaseGroupRecord::primaryType, nullptr},
+        {QLatin1String("first-release-date"), &ReleaseGroupRecord::firstReleaseDate, nullptr},
+    };
+};
+
+template <>
+struct RecordSlots<WorkRecord> {
+    static constexpr FieldSlot<WorkRecord> fields[] = {
+        {QLatin1String("type"), &WorkRecord::type, nullptr},
+        {QLatin1String("language"), &WorkRecord::language, nullptr},
+    };
+};
+
+template <>
+struct RecordSlots<LabelRecord> {
+    static constexpr FieldSlot<LabelRecord> fields[] = {
+        {QLatin1String("type"), &LabelRecord::type, nullptr},
+        {QLatin1String("country"), &LabelRecord::country, nullptr},
+        {QLatin1String("label-code"), nullptr, &LabelRecord::labelCode},
+    };
+};
+
+template <>
+struct RecordSlots<AreaRecord> {
+    static constexpr FieldSlot<AreaRecord> fields[] = {
+        {QLatin1String("type"), &AreaRecord::type, nullptr},
+        {QLatin1String("sort-name"), &AreaRecord::sortName, nullptr},
+    };
+};
+
+template <typename Record>
+constexpr int slotCount()
+{
+    return static_cast<int>(std::size(RecordSlots<Record>::fields));
+}
+
+/**
+ * @brief 查找键对应的槽位序号
+ *
+ * 每种记录只有几个槽位，线性比较比任何映射查找都快。
+ */
+template <typename Record>
+int findSlot(const QString &key)
+{
+    for (int i = 0; i < slotCount<Record>(); ++i) {
+        if (key == RecordSlots<Record>::fields[i].key) {
+            return i;
+        }
+    }
+    return -1;
+}
+
+/**
+ * @brief 槽位键名的QString形式
+ *
+ * 第一次使用时转换，之后遍历字段不再为键名分配字符串。
+ */
+template <typename Record>
+const QString &slotKey(int index)
+{
+    static const QList<QString> keys = [] {
+        QList<QString> result;
+        for (const auto &field : RecordSlots<Record>::fields) {
+            result.append(QString(field.key));
+        }
+        return result;
+    }();
+    return keys[index];
+}
+
+template <typename T>
+constexpr bool isRecord = !std::is_same_v<std::decay_t<T>, std::monostate>;
+
+} // namespace
+
+EntityRecord::EntityRecord(EntityType type)
+{
+    switch (type) {
+        case EntityType::Artist:
+            m_data.emplace<ArtistRecord>();
+            break;
+        case EntityType::Release:
+            m_data.emplace<ReleaseRecord>();
+            break;
+        case EntityType::Recording:
+            m_data.emplace<RecordingRecord>();
+            break;
+        case EntityType::ReleaseGroup:
+            m_data.emplace<ReleaseGroupRecord>();
+            break;
+        case EntityType::Work:
+            m_data.emplace<WorkRecord>();
+            break;
+        case EntityType::Label:
+            m_data.emplace<LabelRecord>();
+            break;
+        case EntityType::Area:
+            m_data.emplace<AreaRecord>();
+            break;
+        default:
+            break;
+    }
+}
+
+bool EntityRecord::contains(const QString &key) const
+{
+    return std::visit([&](const auto &record) {
+        using Record = std::decay_t<decltype(record)>;
+        if constexpr (isRecord<Record>) {
+            const int index = findSlot<Record>(key);
+            return index >= 0 && (m_present & (1u << index));
+        } else {
+            return false;
+        }
+    }, m_data);
+}
+
+QVariant EntityRecord::value(const QString &key) const
+{
+    return std::visit([&](const auto &record) -> QVariant {
+        using Record = std::decay_t<decltype(record)>;
+        if constexpr (isRecord<Record>) {
+            const int index = findSlot<Record>(key);
+            if (index < 0 || !(m_present & (1u << index))) {
+                return QVariant();
+            }
+            const auto &slot = RecordSlots<Record>::fields[index];
+            return slot.text ? QVariant(record.*slot.text) : QVariant(record.*slot.number);
+        } else {
+            return QVariant();
+        }
+    }, m_data);
+}
+
+bool EntityRecord::setText(const QString &key, const QString &value)
+{
+    return std::visit([&](auto &record) {
+        using Record = std::decay_t<decltype(record)>;
+        if constexpr (isRecord<Record>) {
+            const int index = findSlot<Record>(key);
+            if (index < 0 || !RecordSlots<Record>::fields[index].text) {
+                return false;
+            }
+            record.*RecordSlots<Record>::fields[index].text = value;
+            m_present |= (1u << index);
+            return true;
+        } else {
+            return false;
+        }
+    }, m_data);
+}
+
+bool EntityRecord::setNumber(const QString &key, double value)
+{
+    // 非整数的值（理论上不会出现）留给溢出映射，保证读回的值不失真
+    if (!std::isfinite(value) || std::trunc(value) != value) {
+        return false;
+    }
+
+    return std::visit([&](auto &record) {
+        using Record = std::decay_t<decltype(record)>;
+        if constexpr (isRecord<Record>) {
+            const int index = findSlot<Record>(key);
+            if (index < 0 || !RecordSlots<Record>::fields[index].number) {
+                return false;
+            }
+            record.*RecordSlots<Record>::fields[index].number = static_cast<qint64>(value);
+            m_present |= (1u << index);
+            return true;
+        } else {
+            return false;
+        }
+    }, m_data);
+}
+
+bool EntityRecord::setValue(const QString &key, const QVariant &value)
+{
+    switch (value.typeId()) {
+        case QMetaType::QString:
+            return setText(key, value.toString());
+        case QMetaType::Double:
+        case QMetaType::Int:
+        case QMetaType::LongLong:
+            return setNumber(key, value.toDouble());
+        default:
+            return false;
+    }
+}
+
+void EntityRecord::remove(const QString &key)
+{
+    std::visit([&](auto &record) {
+        using Record = std::decay_t<decltype(record)>;
+        if constexpr (isRecord<Record>) {
+            const int index = findSlot<Record>(key);
+            if (index < 0) {
+                return;
+            }
+            const auto &slot = RecordSlots<Record>::fields[index];
+            if (slot.text) {
+                (record.*slot.text).clear();
+            } else {
+                record.*slot.number = 0;
+            }
+            m_present &= ~(1u << index);
+        }
+    }, m_data);
+}
+
+void EntityRecord::clear()
+{
+    std::visit([&](auto &record) {
+        using Record = std::decay_t<decltype(record)>;
+        if constexpr (isRecord<Record>) {
+            record = Record();
+        }
+    }, m_data);
+    m_present = 0;
+}
+
+int EntityRecord::count() const
+{
+    int result = 0;
+    for (quint8 bits = m_present; bits; bits &= bits - 1) {
+        ++result;
+    }
+    return result;
+}
+
+void EntityRecord::insertInto(QVariantMap &map) const
+{
+    std::visit([&](const auto &record) {
+        using Record = std::decay_t<decltype(record)>;
+        if constexpr (isRecord<Record>) {
+            for (int i = 0; i < slotCount<Record>(); ++i) {
+                if (!(m_present & (1u << i))) {
+                    continue;
+                }
+                const auto &slot = RecordSlots<Record>::fields[i];
+                map.insert(slot.key, slot.text ? QVariant(record.*slot.text) : QVariant(record.*slot.number));
+            }
+        }
+    }, m_data);
+}
+
+void EntityRecord::forEachField(const std::function<void(const QString &key, bool hasContent)> &visit) const
+{
+    std::visit([&](const auto &record) {
+        using Record = std::decay_t<decltype(record)>;
+        if constexpr (isRecord<Record>) {
+            for (int i = 0; i < slotCount<Record>(); ++i) {
+                if (!(m_present & (1u << i))) {
+                    continue;
+                }
+                const auto &slot = RecordSlots<Record>::fields[i];
+                visit(slotKey<Record>(i), !slot.text || !(record.*slot.text).isEmpty());
+            }
+        }
+    }, m_data);
+}
@@ -0,0 +1,175 @@
+#ifndef ENTITYRECORD_H
+#define ENTITYRECORD_H
+
+#include <QString>
+#include <QVariant>
+#include <QVariantMap>
+#include <functional>
+#include <variant>
+#include "../core/types.h"
+
+// =============================================================================
+// 各实体类型的定长字段
+// =============================================================================
+// 字段名与MusicBrainz JSON中的键名一一对应（见entityrecord.cpp中的槽位表）
+
+/**
+ * @brief 艺术家的常用字段
+ */
+struct ArtistRecord {
+    QString type;               ///< type：Person、Group等
+    QString sortName;           ///< sort-name
+    QString country;            ///< country：国家代码
+    QString gender;             ///< gender
+};
+
+/**
+ * @brief 发行的常用字段
+ */
+struct ReleaseRecord {
+    QString date;               ///< date
+    QString country;            ///< country
+    QString status;             ///< status
+    QString barcode;            ///< barcode
+    QString packaging;          ///< packaging
+};
+
+/**
+ * @brief 录音的常用字段
+ */
+struct RecordingRecord {
+    qint64 length = 0;          ///< length：时长（毫秒）
+    QString firstReleaseDate;   ///< first-release-date
+};
+
+/**
+ * @brief 发行组的常用字段
+ */
+struct ReleaseGroupRecord {
+    QString primaryType;        ///< primary-type
+    QString firstReleaseDate;   ///< first-release-date
+};
+
+/**
+ * @brief 作品的常用字段
+ */
+struct WorkRecord {
+    QString type;               ///< type
+    QString language;           ///< language
+};
+
+/**
+ * @brief 厂牌的常用字段
+ */
+struct LabelRecord {
+    QString type;               ///< type
+    QString country;            ///< country
+    qint64 labelCode = 0;       ///< label-code
+};
+
+/**
+ * @brief 地区的常用字段
+ */
+struct AreaRecord {
+    QString type;               ///< type
+    QString sortName;           ///< sort-name
+};
+
+/**
+ * @class EntityRecord
+ * @brief 按实体类型选择的定长字段记录
+ *
+ * 表格列、排序和预览最常访问的标量字段按实体类型存放在定长结构中，
+ * 访问时不需要查找字符串键的有序映射，也不需要为每个字段分配映射节点和QVariant。
+ * 每个字段是否已设置由位掩码记录，因此空字符串和未设置可以区分。
+ *
+ * 只有类型匹配的值（文本槽位接受字符串、数值槽位接受整数）才会放入记录；
+ * 其他值由调用方（ResultItem）放入溢出映射。
+ */
+class EntityRecord
+{
+public:
+    /**
+     * @brief 构造函数
+     * @param type 实体类型，决定使用哪一种记录
+     */
+    explicit EntityRecord(EntityType type = EntityType::Unknown);
+
+    /**
+     * @brief 是否包含已设置的字段
+     * @param key JSON键名
+     */
+    bool contains(const QString &key) const;
+
+    /**
+     * @brief 获取字段值
+     * @param key JSON键名
+     * @return 字段值；键不属于该记录或未设置时返回无效的QVariant
+     */
+    QVariant value(const QString &key) const;
+
+    /**
+     * @brief 设置文本字段
+     * @return 键是该记录的文本槽位时返回true
+     */
+    bool setText(const QString &key, const QString &value);
+
+    /**
+     * @brief 设置数值字段
+     * @return 键是该记录的数值槽位且值为整数时返回true
+     */
+    bool setNumber(const QString &key, double value);
+
+    /**
+     * @brief 按值的类型设置字段
+     * @return 值已放入记录时返回true；返回false时调用方应把值放入溢出映射
+     */
+    bool setValue(const QString &key, const QVariant &value);
+
+    /**
+     * @brief 清除字段
+     */
+    void remove(const QString &key);
+
+    /**
+     * @brief 清除所有字段
+     */
+    void clear();
+
+    /**
+     * @brief 已设置字段的数量
+     */
+    int count() const;
+
+    /**
+     * @brief 把所有已设置的字段写入映射
+     */
+    void insertInto(QVariantMap &map) const;
+    
+    /**
+     * @brief 遍历已设置的字段，不构造QVariant
+     * @param visit 回调：键名和值是否有内容（数值总是有内容，文本非空时有内容）
+     */
+    void forEachField(const std::function<void(const QString &key, bool hasContent)> &visit) const;
+
+    // =============================================================================
+    // 类型化访问（实体类型不匹配时返回空指针）
+    // =============================================================================
+
+    const ArtistRecord *artist() const { return std::get_if<ArtistRecord>(&m_data); }
+    const ReleaseRecord *release() const { return std::get_if<ReleaseRecord>(&m_data); }
+    const RecordingRecord *recording() const { return std::get_if<RecordingRecord>(&m_data); }
+    const ReleaseGroupRecord *releaseGroup() const { return std::get_if<ReleaseGroupRecord>(&m_data); }
+    const WorkRecord *work() const { return std::get_if<WorkRecord>(&m_data); }
+    const LabelRecord *label() const { return std::get_if<LabelRecord>(&m_data); }
+    const AreaRecord *area() const { return std::get_if<AreaRecord>(&m_data); }
+
+private:
+    using Data = std::variant<std::monostate, ArtistRecord, ReleaseRecord, RecordingRecord,
+                              ReleaseGroupRecord, WorkRecord, LabelRecord, AreaRecord>;
+
+    Data m_data;                ///< 当前实体类型的记录
+    quint8 m_present = 0;       ///< 已设置字段的位掩码（按槽位表顺序）
+};
+
+#endif // ENTITYRECORD_H
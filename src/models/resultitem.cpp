@@ -1,10 +1,11 @@
 #include "resultitem.h"
+#include "../utils/string_pool.h"
 #include <QStyle>
 #include <QApplication>
 #include <QRandomGenerator>
 
 ResultItem::ResultItem(const QString &id, const QString &name, EntityType type)
-    : m_id(id), m_name(name), m_type(type), m_score(0)
+    : m_id(id), m_mbid(Mbid::fromString(id)), m_name(name), m_type(type), m_score(0), m_record(type)
 {
 }
 
@@ -17,6 +18,11 @@ QString ResultItem::getId() const
     return m_id;
 }
 
+Mbid ResultItem::getMbid() const
+{
+    return m_mbid;
+}
+
 QString ResultItem::getName() const
 {
     return m_name;
@@ -100,7 +106,8 @@ QMap<QString, QVariant> ResultItem::getDetails() const
     details["Type"] = getTypeString();
     
     // 合并详细数据
-    for (auto it = m_detailData.constBegin(); it != m_detailData.constEnd(); ++it) {
+    const QVariantMap detailData = getDetailData();
+    for (auto it = detailData.constBegin(); it != detailData.constEnd(); ++it) {
         QString key = it.key();
         QVariant value = it.value();
         
@@ -178,22 +185,187 @@ bool ResultItem::hasChildren() const
 
 void ResultItem::setDetailData(const QVariantMap &detailData)
 {
-    m_detailData = detailData;
+    // 整体替换详细数据，延迟字段不再需要
+    m_lazyDecoder = nullptr;
+    m_lazySource = QJsonObject();
+    ++m_revision;
+    m_record.clear();
+    m_detailData.clear();
+    for (auto it = detailData.constBegin(); it != detailData.constEnd(); ++it) {
+        storeDetailProperty(it.key(), it.value());
+    }
+}
+
+void ResultItem::mergeDetailData(const QVariantMap &detailData)
+{
+    ++m_revision;
+    for (auto it = detailData.constBegin(); it != detailData.constEnd(); ++it) {
+        storeDetailProperty(it.key(), it.value());
+    }
 }
 
 QVariantMap ResultItem::getDetailData() const
 {
-    return m_detailData;
+    ensureDecoded();
+    return getLoadedDetailData();
+}
+
+QVariantMap ResultItem::getLoadedDetailData() const
+{
+    QVariantMap detailData = m_detailData;
+    m_record.insertInto(detailData);
+    return detailData;
+}
+
+void ResultItem::forEachLoadedField(const std::function<void(const QString &key)> &visit) const
+{
+    m_record.forEachField([&visit](const QString &key, bool hasContent) {
+        if (hasContent) {
+            visit(key);
+        }
+    });
+    
+    for (auto it = m_detailData.constBegin(); it != m_detailData.constEnd(); ++it) {
+        const QVariant &value = it.value();
+        bool hasContent = false;
+        switch (value.typeId()) {
+            case QMetaType::UnknownType:
+            case QMetaType::Nullptr:
+            case QMetaType::QVariantList:
+            case QMetaType::QStringList:
+            case QMetaType::QVariantMap:
+            case QMetaType::QVariantHash:
+                break;
+            case QMetaType::QString:
+                hasContent = !value.toString().isEmpty();
+                break;
+            default:
+                hasContent = !value.isNull();
+                break;
+        }
+        if (hasContent) {
+            visit(it.key());
+        }
+    }
 }
 
 void ResultItem::setDetailProperty(const QString &key, const QVariant &value)
 {
-    m_detailData[key] = value;
+    ++m_revision;
+    storeDetailProperty(key, value);
+}
+
+void ResultItem::storeDetailProperty(const QString &key, const QVariant &value)
+{
+    if (m_record.setValue(key, value)) {
+        // 同一个键可能先以其他类型的值存入过溢出映射
+        if (!m_detailData.isEmpty()) {
+            m_detailData.remove(key);
+        }
+        return;
+    }
+    
+    m_record.remove(key);
+    // 所有实体共用同一组键名，驻留后每个键只保留一份字符串
+    m_detailData.insert(StringPool::instance().intern(key), value);
 }
 
 QVariant ResultItem::getDetailProperty(const QString &key) const
 {
-    return m_detailData.value(key);
+    const QVariant value = m_record.value(key);
+    if (value.isValid()) {
+        return value;
+    }
+    
+    auto it = m_detailData.constFind(key);
+    if (it != m_detailData.constEnd()) {
+        return it.value();
+    }
+    
+    // 只有延迟字段中确实存在该键时才解码，避免不存在的列触发解码
+    if (m_lazyDecoder && m_lazyDecoder->providesField(m_lazySource, m_type, key)) {
+        ensureDecoded();
+        return m_detailData.value(key);
+    }
+    return QVariant();
+}
+
+bool ResultItem::hasDetailProperty(const QString &key) const
+{
+    if (m_record.contains(key) || m_detailData.contains(key)) {
+        return true;
+    }
+    return m_lazyDecoder && m_lazyDecoder->providesField(m_lazySource, m_type, key);
+}
+
+void ResultItem::setLazySource(const QJsonObject &source, const LazyFieldDecoder *decoder)
+{
+    m_lazySource = source;
+    m_lazyDecoder = decoder;
+}
+
+bool ResultItem::hasLazyFields() const
+{
+    return m_lazyDecoder != nullptr;
+}
+
+void ResultItem::ensureDecoded() const
+{
+    if (!m_lazyDecoder) {
+        return;
+    }
+    
+    const LazyFieldDecoder *decoder = m_lazyDecoder;
+    const QJsonObject source = m_lazySource;
+    m_lazyDecoder = nullptr;
+    m_lazySource = QJsonObject();
+    
+    // 解析后被修改或新增的字段优先，解码结果只补充缺少的键
+    const QVariantMap fields = decoder->decode(source, m_type);
+    for (auto it = fields.constBegin(); it != fields.constEnd(); ++it) {
+        if (!m_record.contains(it.key()) && !m_detailData.contains(it.key())) {
+            m_detailData.insert(it.key(), it.value());
+        }
+    }
+}
+
+bool ResultItem::setRecordText(const QString &key, const QString &value)
+{
+    if (!m_record.setText(key, value)) {
+        return false;
+    }
+    ++m_revision;
+    if (!m_detailData.isEmpty()) {
+        m_detailData.remove(key);
+    }
+    return true;
+}
+
+bool ResultItem::setRecordNumber(const QString &key, double value)
+{
+    if (!m_record.setNumber(key, value)) {
+        return false;
+    }
+    ++m_revision;
+    if (!m_detailData.isEmpty()) {
+        m_detailData.remove(key);
+    }
+    return true;
+}
+
+const EntityRecord &ResultItem::record() const
+{
+    return m_record;
+}
+
+quint32 ResultItem::revision() const
+{
+    return m_revision;
+}
+
+QSharedPointer<ResultItem> ResultItem::clone() const
+{
+    return QSharedPointer<ResultItem>::create(*this);
 }
 
 
@@ -201,6 +373,7 @@ QVariant ResultItem::getDetailProperty(const QString &key) const
 void ResultItem::setDisambiguation(const QString &disambiguation)
 {
     m_disambiguation = disambiguation;
+    ++m_revision;
 }
 
 QString ResultItem::getDisambiguation() const
@@ -211,6 +384,7 @@ QString ResultItem::getDisambiguation() const
 void ResultItem::setScore(int score)
 {
     m_score = score;
+    ++m_revision;
 }
 
 int ResultItem::getScore() const
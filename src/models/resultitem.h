@@ -5,7 +5,41 @@
 #include <QVariant>
 #include <QIcon>
 #include <QMap>
+#include <QJsonObject>
+#include <QSharedPointer>
 #include "../core/types.h"
+#include "../core/mbid.h"
+#include "entityrecord.h"
+
+/**
+ * @class LazyFieldDecoder
+ * @brief 延迟字段解码器接口
+ *
+ * 列表结果中的复合字段（别名、关系、媒体、标签等）在解析时不转换，
+ * 由ResultItem保留实体的源JSON对象，首次访问时再通过解码器一次性转换。
+ * 解码器由解析器提供，实现必须是无状态的。
+ */
+class LazyFieldDecoder
+{
+public:
+    virtual ~LazyFieldDecoder() = default;
+    
+    /**
+     * @brief 源对象解码后是否会包含某个键
+     * @param source 实体的源JSON对象
+     * @param type 实体类型
+     * @param key 详细数据的键名
+     */
+    virtual bool providesField(const QJsonObject &source, EntityType type, const QString &key) const = 0;
+    
+    /**
+     * @brief 解码源对象中所有延迟的字段
+     * @param source 实体的源JSON对象
+     * @param type 实体类型
+     * @return 与完整解析结果相同的详细数据
+     */
+    virtual QVariantMap decode(const QJsonObject &source, EntityType type) const = 0;
+};
 
 /**
  * @class ResultItem
@@ -27,9 +61,18 @@
  * ResultItem (基类)
  * ├── 基础属性 (id, name, type, disambiguation, score)
  * ├── 详细数据 (任意键值对，来自API的完整信息)
+ * │   ├── 定长记录 (按实体类型的常用标量字段，见EntityRecord)
+ * │   └── 溢出映射 (其他字段和嵌套数据)
  * └── 虚拟接口 (显示名称、详情获取、子项检查)
  * ```
  * 
+ * 详细数据的键值接口对两部分透明：常用字段（如艺术家的country、录音的length）
+ * 按键名自动存入定长记录，表格和排序也可以通过record()直接按成员访问。
+ * 
+ * 列表结果还可以处于延迟模式（见setLazySource）：复合字段保留为源JSON对象，
+ * 在getDetailProperty、getDetailData等接口首次需要时才解码，未打开的行不付出转换成本。
+ * 延迟解码会修改条目，因此与其他接口一样只应在一个线程上访问。
+ * 
  * **使用示例：**
  * ```cpp
  * // 创建结果项
@@ -94,6 +137,12 @@ public:
      */
     QString getId() const;
     
+    /**
+     * @brief 获取实体ID的128位形式
+     * @return 实体MBID；ID不是UUID格式（如CD占位符）时返回空值
+     */
+    Mbid getMbid() const;
+    
     /**
      * @brief 获取实体名称
      * @return 实体的显示名称
@@ -198,6 +247,15 @@ public:
      */
     void setDetailData(const QVariantMap &detailData);
     
+    /**
+     * @brief 合并详细数据
+     * @param detailData 要写入的键值对映射
+     * 
+     * 同名字段被覆盖，其他字段保持不变。所有字段一次写入，修改计数只递增一次。
+     * 通常用于把加载完成的详情整体写入已有的条目。
+     */
+    void mergeDetailData(const QVariantMap &detailData);
+    
     /**
      * @brief 获取完整的详细数据
      * @return 所有详细数据的键值对映射
@@ -219,6 +277,83 @@ public:
      * @return 属性值，如果不存在则返回无效的QVariant
      */
     QVariant getDetailProperty(const QString &key) const;
+    
+    /**
+     * @brief 检查是否存在某个详细属性
+     * @param key 属性键名
+     * @return 属性存在时返回true（即使值为空）
+     */
+    bool hasDetailProperty(const QString &key) const;
+    
+    /**
+     * @brief 获取已解码的详细数据
+     * @return 已解码字段的键值对映射，不触发延迟字段的解码
+     * 
+     * 延迟字段都是对象或对象列表，只需要标量字段的场合（如动态列检测）使用此接口。
+     */
+    QVariantMap getLoadedDetailData() const;
+    
+    /**
+     * @brief 遍历已解码且有内容的字段
+     * @param visit 回调，参数为键名
+     * 
+     * 只检查值的类型和是否为空，不复制详细数据也不转换值。空字符串、空值以及
+     * 列表和映射（复合字段）不算作有内容。供表格的列检测使用，不触发延迟字段的解码。
+     */
+    void forEachLoadedField(const std::function<void(const QString &key)> &visit) const;
+    
+    /**
+     * @brief 设置延迟解码的来源
+     * @param source 实体的源JSON对象（与响应文档共享存储）
+     * @param decoder 解码器，必须在条目的整个生命周期内有效
+     * 
+     * 已经存在的字段在解码后保持不变，解码结果只补充缺少的字段。
+     */
+    void setLazySource(const QJsonObject &source, const LazyFieldDecoder *decoder);
+    
+    /**
+     * @brief 是否还有尚未解码的字段
+     */
+    bool hasLazyFields() const;
+    
+    /**
+     * @brief 直接设置定长记录中的文本字段
+     * @param key 属性键名
+     * @param value 属性值
+     * @return 该键不是当前实体类型的文本字段时返回false，调用方应改用setDetailProperty
+     * 
+     * 供解析器使用，避免为常用字段构造QVariant。
+     */
+    bool setRecordText(const QString &key, const QString &value);
+    
+    /**
+     * @brief 直接设置定长记录中的数值字段
+     * @return 该键不是当前实体类型的数值字段时返回false
+     */
+    bool setRecordNumber(const QString &key, double value);
+    
+    /**
+     * @brief 获取定长字段记录
+     * @return 按实体类型存放常用字段的记录
+     */
+    const EntityRecord &record() const;
+    
+    /**
+     * @brief 获取修改计数
+     * @return 每次修改消歧信息、评分或详细数据后递增的计数
+     * 
+     * 供缓存了格式化结果的视图模型判断条目是否在缓存之后被修改过。
+     */
+    quint32 revision() const;
+    
+    /**
+     * @brief 复制条目
+     * @return 与本条目数据相同、不共享任何可变状态的新条目
+     * 
+     * 尚未解码的延迟字段原样复制（源JSON对象是隐式共享的只读数据），
+     * 副本首次访问时各自解码。同一解析结果交给多个调用方时，每个调用方得到自己的副本。
+     */
+    QSharedPointer<ResultItem> clone() const;
 
 protected:
     // =============================================================================
@@ -226,11 +361,28 @@ protected:
     // =============================================================================
     
     QString m_id;                   ///< 实体唯一标识符（MBID）
+    Mbid m_mbid;                    ///< 实体MBID的128位形式，用于集合和映射的键
     QString m_name;                 ///< 实体名称
     EntityType m_type;              ///< 实体类型
     QString m_disambiguation;       ///< 消歧信息
     int m_score;                    ///< 搜索匹配评分
-    QVariantMap m_detailData;       ///< 详细数据存储
+    EntityRecord m_record;          ///< 常用字段的定长记录
+    mutable QVariantMap m_detailData;   ///< 其他详细数据（溢出映射），延迟解码时补充
+    quint32 m_revision = 0;         ///< 修改计数
+    
+private:
+    /**
+     * @brief 解码所有延迟字段（如果有）
+     */
+    void ensureDecoded() const;
+    
+    /**
+     * @brief 写入单个详细属性（存入定长记录或溢出映射），不修改修改计数
+     */
+    void storeDetailProperty(const QString &key, const QVariant &value);
+    
+    mutable QJsonObject m_lazySource;                       ///< 延迟字段的源对象
+    mutable const LazyFieldDecoder *m_lazyDecoder = nullptr;    ///< 延迟字段解码器，解码后置空
 };
 
 #endif // RESULTITEM_H
@@ -4,18 +4,304 @@
 #include <QLocale>
 #include <QDate>
 #include <QCoreApplication>
+#include <QCollator>
+#include <QSemaphore>
+#include <QThread>
+#include <QThreadPool>
+#include <QTimer>
 #include <algorithm>
+#include <iterator>
+#include <numeric>
+#include <utility>
+
+// =============================================================================
+// 列访问器
+// =============================================================================
+
+namespace {
+
+QVariant readName(const ResultItem &item, const QString &)
+{
+    return item.getName();
+}
+
+QVariant readId(const ResultItem &item, const QString &)
+{
+    return item.getId();
+}
+
+QVariant readTypeString(const ResultItem &item, const QString &)
+{
+    return item.getTypeString();
+}
+
+QVariant readDetail(const ResultItem &item, const QString &key)
+{
+    return item.getDetailProperty(key);
+}
+
+QVariant formatCount(const QVariant &value)
+{
+    return value.toInt();
+}
+
+QVariant formatLength(const QVariant &value)
+{
+    const qint64 ms = value.toLongLong();
+    if (ms <= 0) {
+        return value;
+    }
+    qint64 seconds = ms / 1000;
+    const qint64 minutes = seconds / 60;
+    seconds %= 60;
+    return QString("%1:%2").arg(minutes).arg(seconds, 2, 10, QChar('0'));
+}
+
+QVariant formatRating(const QVariant &value)
+{
+    const double rating = value.toDouble();
+    if (rating <= 0) {
+        return value;
+    }
+    return QString::number(rating, 'f', 1);
+}
+
+QVariant formatList(const QVariant &value)
+{
+    if (value.typeId() == QMetaType::QString) {
+        return value;
+    }
+    // 列表中的对象（如带计数的标签）没有文本形式，跳过
+    QStringList parts;
+    const QVariantList list = value.toList();
+    for (const QVariant &element : list) {
+        const QString text = element.toString();
+        if (!text.isEmpty()) {
+            parts << text;
+        }
+    }
+    return parts.isEmpty() ? value : QVariant(parts.join(", "));
+}
+
+/**
+ * @brief 需要特殊读取或格式化的列
+ */
+struct AccessorRule {
+    QLatin1String key;
+    ColumnAccessor::Reader read;
+    ColumnAccessor::Formatter format;
+};
+
+const AccessorRule accessorRules[] = {
+    {QLatin1String("name"), readName, nullptr},
+    {QLatin1String("id"), readId, nullptr},
+    {QLatin1String("type"), readTypeString, nullptr},
+    {QLatin1String("length"), readDetail, formatLength},
+    {QLatin1String("rating"), readDetail, formatRating},
+    {QLatin1String("tags"), readDetail, formatList},
+    {QLatin1String("aliases"), readDetail, formatList},
+    {QLatin1String("isrcs"), readDetail, formatList},
+};
+
+constexpr int PARALLEL_SORT_MIN_ROWS = 16384;    ///< 少于该行数时单线程排序
+
+/**
+ * @brief 把[0, count)分段，行数较多时按线程数分成多段
+ * @return 各段的边界（段数+1个）
+ */
+QVector<int> chunkBounds(int count)
+{
+    const int threads = QThread::idealThreadCount();
+    const int chunks = (count < PARALLEL_SORT_MIN_ROWS || threads < 2)
+        ? 1 : qMin(threads, count / (PARALLEL_SORT_MIN_ROWS / 2));
+    QVector<int> bounds(chunks + 1);
+    for (int i = 0; i <= chunks; ++i) {
+        bounds[i] = int(qint64(count) * i / chunks);
+    }
+    return bounds;
+}
+
+/**
+ * @brief 并行处理各段，当前线程处理第一段，返回时所有段都已完成
+ * @param func 参数为段号和段的范围[begin, end)
+ */
+template <typename Func>
+void forEachChunk(const QVector<int> &bounds, const Func &func)
+{
+    const int chunks = bounds.size() - 1;
+    QSemaphore done;
+    for (int i = 1; i < chunks; ++i) {
+        const int begin = bounds[i];
+        const int end = bounds[i + 1];
+        QThreadPool::globalInstance()->start([i, begin, end, &func, &done]() {
+            func(i, begin, end);
+            done.release();
+        });
+    }
+    func(0, bounds[0], bounds[1]);
+    done.acquire(chunks - 1);
+}
+
+/**
+ * @brief 对行号稳定排序，行数较多时分段并行
+ */
+template <typename Less>
+void parallelStableSort(QVector<int> &rows, const Less &less)
+{
+    // 分段并行排序，再逐层两两归并（归并是稳定的）
+    const QVector<int> bounds = chunkBounds(rows.size());
+    const int chunks = bounds.size() - 1;
+    int *data = rows.data();
+    forEachChunk(bounds, [data, &less](int, int begin, int end) {
+        std::stable_sort(data + begin, data + end, less);
+    });
+    
+    for (int width = 1; width < chunks; width *= 2) {
+        for (int i = 0; i + width < chunks; i += 2 * width) {
+            const int end = qMin(i + 2 * width, chunks);
+            std::inplace_merge(data + bounds[i], data + bounds[i + width], data + bounds[end], less);
+        }
+    }
+}
+
+} // namespace
+
+ColumnAccessor ColumnAccessor::resolve(const QString &key)
+{
+    ColumnAccessor accessor;
+    accessor.key = key;
+    accessor.read = readDetail;
+    
+    for (const AccessorRule &rule : accessorRules) {
+        if (key == rule.key) {
+            accessor.read = rule.read;
+            accessor.format = rule.format;
+            return accessor;
+        }
+    }
+    
+    if (key.endsWith(QLatin1String("_count"))) {
+        accessor.format = formatCount;
+    }
+    return accessor;
+}
+
+QVariant ColumnAccessor::display(const ResultItem &item) const
+{
+    const QVariant value = read(item, key);
+    if (format && value.isValid()) {
+        return format(value);
+    }
+    return value;
+}
+
+// =============================================================================
+// ColumnSchema
+// =============================================================================
+
+void ColumnSchema::clear()
+{
+    m_counts.clear();
+    m_order.clear();
+    m_itemFields.clear();
+}
+
+bool ColumnSchema::addItem(const ResultItem &item)
+{
+    // 条目被修改时先撤销上一次的统计
+    removeItem(item);
+    
+    QStringList fields;
+    fields << QStringLiteral("name");
+    if (!item.getId().isEmpty()) {
+        fields << QStringLiteral("id");
+    }
+    // 延迟字段都是对象或对象列表，不会成为列，无需解码
+    item.forEachLoadedField([&fields](const QString &key) {
+        fields << key;
+    });
+    
+    bool added = false;
+    for (const QString &field : fields) {
+        int &count = m_counts[field];
+        if (count++ == 0 && !m_order.contains(field)) {
+            m_order << field;
+            added = true;
+        }
+    }
+    m_itemFields.insert(&item, fields);
+    return added;
+}
+
+void ColumnSchema::removeItem(const ResultItem &item)
+{
+    auto it = m_itemFields.find(&item);
+    if (it == m_itemFields.end()) {
+        return;
+    }
+    for (const QString &field : it.value()) {
+        auto count = m_counts.find(field);
+        if (count != m_counts.end() && --count.value() <= 0) {
+            m_counts.erase(count);
+        }
+    }
+    m_itemFields.erase(it);
+}
+
+QStringList ColumnSchema::fields() const
+{
+    QStringList result;
+    result.reserve(m_order.size());
+    for (const QString &field : m_order) {
+        if (m_counts.value(field) > 0) {
+            result << field;
+        }
+    }
+    return result;
+}
+
+// =============================================================================
+// ResultTableModel
+// =============================================================================
 
 ResultTableModel::ResultTableModel(QObject *parent)
-    : QAbstractTableModel(parent), m_type(EntityType::Unknown) {
+    : QAbstractTableModel(parent), m_type(EntityType::Unknown), m_updateTimer(new QTimer(this)),
+      m_pageTimer(new QTimer(this)) {
+    m_updateTimer->setSingleShot(true);
+    m_updateTimer->setInterval(UPDATE_COALESCE_MS);
+    connect(m_updateTimer, &QTimer::timeout, this, &ResultTableModel::flushPendingUpdates);
+    
+    m_pageTimer->setSingleShot(true);
+    m_pageTimer->setInterval(0);
+    connect(m_pageTimer, &QTimer::timeout, this, &ResultTableModel::emitPageRequests);
 }
 
 void ResultTableModel::setItems(const QList<QSharedPointer<ResultItem>> &items, EntityType type) {
+    // 流式结果的完整列表以已显示的部分开头，只插入新增的行，保留选择和滚动位置
+    if (type == m_type && !m_items.isEmpty() && items.size() >= m_items.size()
+        && std::equal(m_items.cbegin(), m_items.cend(), items.cbegin())) {
+        appendItems(items.mid(m_items.size()));
+        return;
+    }
+    
     beginResetModel();
     m_items = items;
     m_type = type;
     
+    // 新的结果集，分页状态由调用方重新设置
+    m_totalCount = 0;
+    m_pageSize = 0;
+    m_pages.clear();
+    m_wantedPages.clear();
+    m_focusRow = 0;
+    
     // 动态检测列
+    m_schema.clear();
+    for (const auto &item : m_items) {
+        if (item) {
+            m_schema.addItem(*item);
+        }
+    }
     updateColumnsFromData();
     
     endResetModel();
@@ -23,6 +309,110 @@ void ResultTableModel::setItems(const QList<QSharedPointer<ResultItem>> &items,
 
 
 
+void ResultTableModel::appendItems(const QList<QSharedPointer<ResultItem>> &items) {
+    if (items.isEmpty()) {
+        return;
+    }
+    
+    const int first = m_items.size();
+    beginInsertRows(QModelIndex(), first, first + items.size() - 1);
+    m_items.append(items);
+    m_rowCache.resize(m_items.size());
+    endInsertRows();
+    
+    bool newFields = false;
+    for (const auto &item : items) {
+        if (item) {
+            newFields |= m_schema.addItem(*item);
+        }
+    }
+    if (newFields && m_autoColumns) {
+        insertDetectedColumns();
+    }
+}
+
+void ResultTableModel::refreshEntity(const Mbid &mbid) {
+    if (mbid.isNull()) {
+        return;
+    }
+    
+    // 同一时间窗口内到达的多个详情合并为一次刷新
+    m_pendingEntities.insert(mbid);
+    if (!m_updateTimer->isActive()) {
+        m_updateTimer->start();
+    }
+}
+
+void ResultTableModel::flushPendingUpdates() {
+    m_updateTimer->stop();
+    if (m_pendingEntities.isEmpty()) {
+        return;
+    }
+    const QSet<Mbid> pending = std::exchange(m_pendingEntities, QSet<Mbid>());
+    
+    bool newFields = false;
+    for (int row = 0; row < m_items.size(); ++row) {
+        const auto &item = m_items[row];
+        if (!item || !pending.contains(item->getMbid())) {
+            continue;
+        }
+        newFields |= m_schema.addItem(*item);
+        
+        // 缓存是在修改之后计算的，视图显示的已是新值
+        RowCache &cache = m_rowCache[row];
+        if (m_accessors.isEmpty() || (!cache.values.isEmpty() && cache.revision == item->revision())) {
+            continue;
+        }
+        
+        // 重新计算整行，只通知值发生变化的单元格
+        const QVector<QVariant> previous = std::exchange(cache.values, QVector<QVariant>());
+        displayValue(row, 0);
+        int firstChanged = -1;
+        int lastChanged = -1;
+        for (int column = 0; column < m_accessors.size(); ++column) {
+            if (previous.isEmpty() || previous[column] != cache.values[column]) {
+                if (firstChanged < 0) {
+                    firstChanged = column;
+                }
+                lastChanged = column;
+            }
+        }
+        if (firstChanged >= 0) {
+            emit dataChanged(index(row, firstChanged), index(row, lastChanged), {Qt::DisplayRole});
+        }
+    }
+    
+    // 详情可能带来新的字段
+    if (newFields && m_autoColumns) {
+        insertDetectedColumns();
+    }
+}
+
+void ResultTableModel::insertDetectedColumns() {
+    const QStringList visible = getVisibleColumns();
+    QList<ColumnInfo> added;
+    for (const ColumnInfo &column : detectColumnsFromData()) {
+        if (!visible.contains(column.key)) {
+            added << column;
+        }
+    }
+    if (added.isEmpty()) {
+        return;
+    }
+    
+    const int first = m_visibleColumns.size();
+    beginInsertColumns(QModelIndex(), first, first + added.size() - 1);
+    for (const ColumnInfo &column : added) {
+        m_visibleColumns << column;
+        m_accessors.append(ColumnAccessor::resolve(column.key));
+    }
+    // 已缓存的行缺少新列的值，下次绘制时整行重新计算
+    for (RowCache &cache : m_rowCache) {
+        cache.values.clear();
+    }
+    endInsertColumns();
+}
+
 int ResultTableModel::rowCount(const QModelIndex &parent) const {
     Q_UNUSED(parent)
     return m_items.count();
@@ -38,11 +428,12 @@ QVariant ResultTableModel::data(const QModelIndex &index, int role) const {
         return QVariant();
     }
     
-    const auto &item = m_items[index.row()];
-    const QString &fieldKey = m_visibleColumns[index.column()].key;
-    
+    m_focusRow = index.row();
     if (role == Qt::DisplayRole) {
-        return getFieldValue(item, fieldKey);
+        if (!m_items[index.row()] && m_pageSize > 0) {
+            return placeholder(index.row(), index.column());
+        }
+        return displayValue(index.row(), index.column());
     } else if (role == Qt::ToolTipRole) {
         return m_visibleColumns[index.column()].description;
     }
@@ -50,6 +441,216 @@ QVariant ResultTableModel::data(const QModelIndex &index, int role) const {
     return QVariant();
 }
 
+// =============================================================================
+// 按需分页加载
+// =============================================================================
+
+void ResultTableModel::setPaging(int totalCount, int pageSize) {
+    m_totalCount = pageSize > 0 ? qMax(totalCount, int(m_items.size())) : 0;
+    m_pageSize = qMax(0, pageSize);
+    m_pages.clear();
+    m_wantedPages.clear();
+    
+    // 已有的行视为已加载的页面
+    if (m_pageSize > 0) {
+        for (int page = 0; page * m_pageSize < m_items.size(); ++page) {
+            m_pages.insert(page, PageState::Loaded);
+        }
+        
+        // 解析器丢弃的无效实体会使页面不满：补齐空行，使行号与结果偏移量保持一致
+        const int padded = qMin(int(m_pages.size()) * m_pageSize, m_totalCount);
+        if (padded > m_items.size()) {
+            beginInsertRows(QModelIndex(), m_items.size(), padded - 1);
+            m_items.resize(padded);
+            m_rowCache.resize(padded);
+            endInsertRows();
+        }
+    }
+}
+
+bool ResultTableModel::isPaged() const {
+    return m_pageSize > 0;
+}
+
+bool ResultTableModel::canFetchMore(const QModelIndex &parent) const {
+    if (parent.isValid()) {
+        return false;
+    }
+    return m_pageSize > 0 && m_items.size() < m_totalCount;
+}
+
+void ResultTableModel::fetchMore(const QModelIndex &parent) {
+    if (!canFetchMore(parent)) {
+        return;
+    }
+    
+    // 先插入下一页的占位行，页面到达后原地替换
+    const int first = m_items.size();
+    const int page = first / m_pageSize;
+    const int end = qMin((page + 1) * m_pageSize, m_totalCount);
+    beginInsertRows(QModelIndex(), first, end - 1);
+    m_items.resize(end);
+    m_rowCache.resize(end);
+    endInsertRows();
+    
+    m_pages.remove(page);
+    requestPage(page);
+}
+
+void ResultTableModel::setPage(int offset, const QList<QSharedPointer<ResultItem>> &items) {
+    if (m_pageSize <= 0 || offset < 0 || offset % m_pageSize != 0) {
+        return;
+    }
+    const int page = offset / m_pageSize;
+    if (items.isEmpty()) {
+        m_pages.insert(page, PageState::Failed);
+        return;
+    }
+    
+    // 页面只替换已有的占位行；结果总数在此期间减少时多出的行保持占位
+    const int end = qMin(offset + int(items.size()), int(m_items.size()));
+    if (end <= offset) {
+        m_pages.remove(page);
+        return;
+    }
+    bool newFields = false;
+    for (int row = offset; row < end; ++row) {
+        if (m_items[row]) {
+            m_schema.removeItem(*m_items[row]);
+        }
+        m_items[row] = items[row - offset];
+        m_rowCache[row] = RowCache();
+        if (m_items[row]) {
+            newFields |= m_schema.addItem(*m_items[row]);
+        }
+    }
+    m_pages.insert(page, PageState::Loaded);
+    if (!m_visibleColumns.isEmpty()) {
+        emit dataChanged(index(offset, 0), index(end - 1, m_visibleColumns.size() - 1));
+    }
+    
+    if (newFields && m_autoColumns) {
+        insertDetectedColumns();
+    }
+    evictPages();
+}
+
+void ResultTableModel::setPageFailed(int offset) {
+    if (m_pageSize <= 0 || offset < 0) {
+        return;
+    }
+    const int page = offset / m_pageSize;
+    m_pages.insert(page, PageState::Failed);
+    
+    const int first = page * m_pageSize;
+    const int last = qMin(first + m_pageSize, int(m_items.size())) - 1;
+    if (last >= first && !m_visibleColumns.isEmpty()) {
+        emit dataChanged(index(first, 0), index(last, 0));
+    }
+}
+
+void ResultTableModel::requestPage(int page) const {
+    if (m_pages.contains(page)) {
+        return;
+    }
+    // data()在绘制过程中调用，请求推迟到事件循环中发出
+    m_pages.insert(page, PageState::Pending);
+    m_wantedPages.insert(page);
+    if (!m_pageTimer->isActive()) {
+        m_pageTimer->start();
+    }
+}
+
+void ResultTableModel::emitPageRequests() {
+    QList<int> pages = std::exchange(m_wantedPages, QSet<int>()).values();
+    std::sort(pages.begin(), pages.end());
+    for (int page : pages) {
+        // 等待期间已经到达或被释放的页面不再请求
+        const auto state = m_pages.constFind(page);
+        if (state != m_pages.cend() && state.value() == PageState::Pending) {
+            emit pageRequested(page * m_pageSize);
+        }
+    }
+}
+
+void ResultTableModel::evictPages() {
+    QList<int> loaded;
+    for (auto it = m_pages.cbegin(); it != m_pages.cend(); ++it) {
+        if (it.value() == PageState::Loaded) {
+            loaded << it.key();
+        }
+    }
+    if (loaded.size() <= MAX_RESIDENT_PAGES) {
+        return;
+    }
+    
+    // 释放离最近绘制的行最远的页面，滚动回来时重新请求
+    const int focusPage = m_focusRow / m_pageSize;
+    std::sort(loaded.begin(), loaded.end(), [focusPage](int a, int b) {
+        return qAbs(a - focusPage) > qAbs(b - focusPage);
+    });
+    for (int i = 0; i < loaded.size() - MAX_RESIDENT_PAGES; ++i) {
+        const int page = loaded[i];
+        const int first = page * m_pageSize;
+        const int end = qMin(first + m_pageSize, int(m_items.size()));
+        for (int row = first; row < end; ++row) {
+            if (m_items[row]) {
+                m_schema.removeItem(*m_items[row]);
+            }
+            m_items[row].reset();
+            m_rowCache[row] = RowCache();
+        }
+        m_pages.remove(page);
+        if (end > first && !m_visibleColumns.isEmpty()) {
+            emit dataChanged(index(first, 0), index(end - 1, m_visibleColumns.size() - 1));
+        }
+    }
+}
+
+QVariant ResultTableModel::placeholder(int row, int column) const {
+    const int page = row / m_pageSize;
+    const auto state = m_pages.constFind(page);
+    if (state == m_pages.cend()) {
+        requestPage(page);
+    } else if (state.value() == PageState::Failed) {
+        return column == 0 ? QCoreApplication::translate("ResultTableModel", "Failed to load") : QVariant();
+    } else if (state.value() == PageState::Loaded) {
+        // 已加载页面中的空行对应被丢弃的实体
+        return QVariant();
+    }
+    return column == 0 ? QCoreApplication::translate("ResultTableModel", "Loading...") : QVariant();
+}
+
+const QVariant &ResultTableModel::displayValue(int row, int column) const {
+    static const QVariant empty;
+    const auto &item = m_items[row];
+    if (!item) {
+        return empty;
+    }
+    
+    // 一行的单元格通常一起绘制，缓存失效时整行重新计算
+    RowCache &cache = m_rowCache[row];
+    if (cache.values.isEmpty() || cache.revision != item->revision()) {
+        cache.revision = item->revision();
+        cache.values.resize(m_accessors.size());
+        for (int i = 0; i < m_accessors.size(); ++i) {
+            cache.values[i] = m_accessors[i].display(*item);
+        }
+    }
+    return cache.values[column];
+}
+
+void ResultTableModel::resolveColumns() {
+    m_accessors.clear();
+    m_accessors.reserve(m_visibleColumns.size());
+    for (const ColumnInfo &column : m_visibleColumns) {
+        m_accessors.append(ColumnAccessor::resolve(column.key));
+    }
+    
+    m_rowCache.clear();
+    m_rowCache.resize(m_items.size());
+}
+
 QVariant ResultTableModel::headerData(int section, Qt::Orientation orientation, int role) const {
     if (orientation == Qt::Horizontal && role == Qt::DisplayRole) {
         if (section < m_visibleColumns.count()) {
@@ -192,6 +793,8 @@ void ResultTableModel::setVisibleColumns(const QStringList &columnKeys) {
     if (m_visibleColumns.isEmpty()) {
         m_visibleColumns = getDefaultColumns(m_type);
     }
+    m_autoColumns = false;
+    resolveColumns();
     endResetModel();
 }
 
@@ -254,95 +857,9 @@ QList<ColumnInfo> ResultTableModel::getDefaultColumns(EntityType type) const {
     return defaultColumns;
 }
 
-QVariant ResultTableModel::getFieldValue(const QSharedPointer<ResultItem> &item, const QString &fieldKey) const {
-    if (!item) {
-        return QVariant();
-    }
-      // 首先尝试从基本属性获取
-    if (fieldKey == "name") {
-        return item->getName();
-    } else if (fieldKey == "id") {
-        return item->getId();
-    } else if (fieldKey == "score") {
-        // score 不是 ResultItem 的直接属性，尝试从详细数据获取
-        return item->getDetailProperty("score");
-    } else if (fieldKey == "type") {
-        return item->getTypeString();
-    } else if (fieldKey == "disambiguation") {
-        return item->getDetailProperty("disambiguation");
-    } else if (fieldKey == "sort_name") {
-        return item->getDetailProperty("sort_name");
-    } else if (fieldKey == "country") {
-        return item->getDetailProperty("country");
-    } else if (fieldKey == "life_span") {
-        return item->getDetailProperty("life_span");
-    } else if (fieldKey == "title") {
-        return item->getDetailProperty("title");
-    } else if (fieldKey == "artist") {
-        return item->getDetailProperty("artist");
-    } else if (fieldKey == "date") {
-        return item->getDetailProperty("date");
-    } else if (fieldKey == "status") {
-        return item->getDetailProperty("status");
-    }
-    
-    // 然后尝试从详细信息获取
-    QVariant detailValue = item->getDetailProperty(fieldKey);
-    if (detailValue.isValid()) {
-        return detailValue;
-    }
-    
-    // 最后尝试从详细数据获取并格式化
-    const QVariantMap details = item->getDetailData();
-    if (details.contains(fieldKey)) {
-        QVariant value = details[fieldKey];
-        
-        // 格式化特殊字段
-        if (fieldKey.endsWith("_count")) {
-            return value.toInt();
-        } else if (fieldKey == "length") {
-            int ms = value.toInt();
-            if (ms > 0) {
-                int seconds = ms / 1000;
-                int minutes = seconds / 60;
-                seconds %= 60;
-                return QString("%1:%2").arg(minutes).arg(seconds, 2, 10, QChar('0'));
-            }
-        } else if (fieldKey == "rating") {
-            double rating = value.toDouble();
-            if (rating > 0) {
-                return QString::number(rating, 'f', 1);
-            }
-        } else if (fieldKey == "tags" || fieldKey == "aliases" || fieldKey == "isrcs") {
-            QStringList list = value.toStringList();
-            return list.join(", ");
-        }
-        
-        return value;
-    }    
-    return QVariant();
-}
-
 QList<ColumnInfo> ResultTableModel::detectColumnsFromData() const {
     QList<ColumnInfo> detectedColumns;
-    QSet<QString> allFields;
-    
-    // 收集所有项目中出现的字段
-    for (const auto &item : m_items) {
-        if (!item) continue;
-        
-        // 从基本数据收集字段
-        allFields.insert("name");
-        if (!item->getId().isEmpty()) allFields.insert("id");
-        
-        // 从详细数据收集字段
-        QVariantMap details = item->getDetailData();
-        for (auto it = details.begin(); it != details.end(); ++it) {
-            if (!it.value().isNull() && !it.value().toString().isEmpty()) {
-                allFields.insert(it.key());
-            }
-        }
-    }
+    const QStringList fields = m_schema.fields();
     
     // 将字段转换为列信息，优先使用已知的列定义
     QList<ColumnInfo> knownColumns = getAvailableColumns(m_type);
@@ -350,14 +867,14 @@ QList<ColumnInfo> ResultTableModel::detectColumnsFromData() const {
     
     // 首先添加已知的列
     for (const auto &knownColumn : knownColumns) {
-        if (allFields.contains(knownColumn.key)) {
+        if (m_schema.count(knownColumn.key) > 0) {
             detectedColumns << knownColumn;
             usedFields.insert(knownColumn.key);
         }
     }
     
     // 然后添加未知的字段作为新列
-    for (const QString &field : allFields) {
+    for (const QString &field : fields) {
         if (!usedFields.contains(field)) {
             QString displayName = field;
             displayName = displayName.replace('_', ' ');
@@ -387,6 +904,8 @@ void ResultTableModel::updateColumnsFromData() {
         // 如果没有检测到任何列，使用默认列
         m_visibleColumns = getDefaultColumns(m_type);
     }
+    m_autoColumns = true;
+    resolveColumns();
 }
 
 void ResultTableModel::sort(int column, Qt::SortOrder order) {
@@ -394,50 +913,139 @@ void ResultTableModel::sort(int column, Qt::SortOrder order) {
         return;
     }
     
-    const QString &fieldKey = m_visibleColumns[column].key;
-    
-    emit layoutAboutToBeChanged();
-    
-    // 创建一个包含原始索引的排序对列表
-    QList<QPair<QSharedPointer<ResultItem>, int>> sortPairs;
-    for (int i = 0; i < m_items.size(); ++i) {
-        sortPairs.append(qMakePair(m_items[i], i));
-    }
-    
-    // 执行排序
-    std::sort(sortPairs.begin(), sortPairs.end(), [this, &fieldKey, order](const QPair<QSharedPointer<ResultItem>, int> &a, const QPair<QSharedPointer<ResultItem>, int> &b) {
-        QVariant valueA = getFieldValue(a.first, fieldKey);
-        QVariant valueB = getFieldValue(b.first, fieldKey);
+    // 分页加载时行号即结果偏移量，只有全部结果都已加载时才能排序
+    if (m_pageSize > 0) {
+        if (m_items.size() < m_totalCount) {
+            return;
+        }
+        for (int page = 0; page * m_pageSize < m_items.size(); ++page) {
+            if (m_pages.value(page, PageState::Pending) != PageState::Loaded) {
+                return;
+            }
+        }
         
-        // 处理空值
-        if (!valueA.isValid() && !valueB.isValid()) {
-            return false;
+        // 已加载页面中的空行（被丢弃的实体）不参与排序
+        for (int row = m_items.size() - 1; row >= 0; --row) {
+            if (m_items[row]) {
+                continue;
+            }
+            int first = row;
+            while (first > 0 && !m_items[first - 1]) {
+                --first;
+            }
+            beginRemoveRows(QModelIndex(), first, row);
+            m_items.remove(first, row - first + 1);
+            m_rowCache.remove(first, row - first + 1);
+            endRemoveRows();
+            row = first;
+        }
+        setPaging(0, 0);
+        if (m_items.isEmpty()) {
+            return;
         }
-        if (!valueA.isValid()) {
-            return order == Qt::AscendingOrder ? true : false;
+    }
+    
+    const int count = m_items.size();
+    const SortKeys keys = extractSortKeys(m_accessors[column]);
+    
+    // 空值最小：升序时排在最前，降序时排在最后；相等的行保持原有顺序
+    auto less = [&keys](int a, int b) {
+        if (keys.nulls[a] != keys.nulls[b]) {
+            return keys.nulls[a] != 0;
         }
-        if (!valueB.isValid()) {
-            return order == Qt::AscendingOrder ? false : true;
+        if (keys.nulls[a]) {
+            return false;
         }
-          // 比较值
-        bool result = false;
-        if (valueA.typeId() == QMetaType::QString && valueB.typeId() == QMetaType::QString) {
-            result = valueA.toString().compare(valueB.toString(), Qt::CaseInsensitive) < 0;
-        } else if (valueA.canConvert<double>() && valueB.canConvert<double>()) {
-            result = valueA.toDouble() < valueB.toDouble();
-        } else {
-            result = valueA.toString().compare(valueB.toString(), Qt::CaseInsensitive) < 0;
+        if (keys.numeric) {
+            return keys.numbers[a] < keys.numbers[b];
         }
-        
-        return order == Qt::AscendingOrder ? result : !result;
-    });
+        return keys.texts[a].compare(keys.texts[b]) < 0;
+    };
     
-    // 更新项目列表
-    for (int i = 0; i < sortPairs.size(); ++i) {
-        m_items[i] = sortPairs[i].first;
+    QVector<int> permutation(count);
+    std::iota(permutation.begin(), permutation.end(), 0);
+    if (order == Qt::AscendingOrder) {
+        parallelStableSort(permutation, less);
+    } else {
+        parallelStableSort(permutation, [&less](int a, int b) { return less(b, a); });
     }
     
-    emit layoutChanged();
+    emit layoutAboutToBeChanged(QList<QPersistentModelIndex>(), QAbstractItemModel::VerticalSortHint);
+    
+    // 更新项目列表，显示缓存随行一起移动
+    QList<QSharedPointer<ResultItem>> sortedItems;
+    QVector<RowCache> sortedCache;
+    QVector<int> newRows(count);
+    sortedItems.reserve(count);
+    sortedCache.reserve(count);
+    for (int row = 0; row < count; ++row) {
+        const int source = permutation[row];
+        sortedItems.append(m_items[source]);
+        sortedCache.append(std::move(m_rowCache[source]));
+        newRows[source] = row;
+    }
+    m_items = sortedItems;
+    m_rowCache = sortedCache;
+    
+    // 视图中的选择和当前项跟随条目移动
+    const QModelIndexList oldIndexes = persistentIndexList();
+    QModelIndexList newIndexes;
+    newIndexes.reserve(oldIndexes.size());
+    for (const QModelIndex &oldIndex : oldIndexes) {
+        newIndexes.append(index(newRows[oldIndex.row()], oldIndex.column()));
+    }
+    changePersistentIndexList(oldIndexes, newIndexes);
+    
+    emit layoutChanged(QList<QPersistentModelIndex>(), QAbstractItemModel::VerticalSortHint);
+}
+
+ResultTableModel::SortKeys ResultTableModel::extractSortKeys(const ColumnAccessor &accessor) const {
+    const int count = m_items.size();
+    
+    // 每个条目只读取一次原始值
+    QVector<QVariant> values;
+    values.reserve(count);
+    SortKeys keys;
+    keys.nulls.resize(count);
+    for (int row = 0; row < count; ++row) {
+        const auto &item = m_items[row];
+        values.append(item ? accessor.value(*item) : QVariant());
+        const QVariant &value = values.last();
+        keys.nulls[row] = !value.isValid() || value.isNull();
+        if (!keys.nulls[row] && (value.typeId() == QMetaType::QString || !value.canConvert<double>())) {
+            keys.numeric = false;
+        }
+    }
+    
+    // 整列都是数值时按数值比较，否则按当前语言环境的排序规则比较文本（忽略大小写）。
+    // 转换（尤其是生成排序键）与排序使用相同的分段并行进行；条目只在本线程上读取
+    const QVector<int> bounds = chunkBounds(count);
+    if (keys.numeric) {
+        keys.numbers.resize(count);
+        forEachChunk(bounds, [&keys, &values](int, int begin, int end) {
+            for (int row = begin; row < end; ++row) {
+                keys.numbers[row] = keys.nulls[row] ? 0.0 : values[row].toDouble();
+            }
+        });
+    } else {
+        // QCollator不能跨线程共享，每段使用自己的实例；
+        // QCollatorSortKey没有默认构造函数，各段分别生成后再按顺序拼接
+        std::vector<std::vector<QCollatorSortKey>> parts(bounds.size() - 1);
+        forEachChunk(bounds, [&keys, &values, &parts](int chunk, int begin, int end) {
+            QCollator collator;
+            collator.setCaseSensitivity(Qt::CaseInsensitive);
+            std::vector<QCollatorSortKey> &part = parts[chunk];
+            part.reserve(end - begin);
+            for (int row = begin; row < end; ++row) {
+                part.push_back(collator.sortKey(keys.nulls[row] ? QString() : values[row].toString()));
+            }
+        });
+        keys.texts.reserve(count);
+        for (auto &part : parts) {
+            std::move(part.begin(), part.end(), std::back_inserter(keys.texts));
+        }
+    }
+    return keys;
 }
 
 QString ResultTableModel::generateFriendlyColumnName(const QString &key) const {
@@ -2,11 +2,19 @@
 #define RESULTTABLEMODEL_H
 
 #include <QAbstractTableModel>
+#include <QCollatorSortKey>
+#include <QHash>
+#include <QMap>
+#include <QSet>
 #include <QVector>
 #include <QSharedPointer>
 #include <QStringList>
+#include <vector>
 #include "resultitem.h"
 #include "../core/types.h"
+#include "../core/mbid.h"
+
+class QTimer;
 
 struct ColumnInfo {
     QString key;        // 数据字段名
@@ -14,17 +22,80 @@ struct ColumnInfo {
     QString description; // 字段描述
 };
 
+/**
+ * @brief 预先解析的列访问器
+ *
+ * 设置列时按键名选择读取函数和格式化函数，data()只调用函数指针，
+ * 不再逐个比较键名。
+ */
+struct ColumnAccessor {
+    using Reader = QVariant (*)(const ResultItem &item, const QString &key);
+    using Formatter = QVariant (*)(const QVariant &value);
+    
+    QString key;                    // 数据字段名（传给读取函数）
+    Reader read = nullptr;          // 读取原始值
+    Formatter format = nullptr;     // 格式化显示值，为空时直接显示原始值
+    
+    /**
+     * @brief 按键名解析访问器
+     */
+    static ColumnAccessor resolve(const QString &key);
+    
+    QVariant value(const ResultItem &item) const { return read(item, key); }
+    QVariant display(const ResultItem &item) const;
+};
+
+/**
+ * @brief 结果集的字段统计
+ *
+ * 记录每个字段在多少个条目中有内容，条目到达、被修改或被移除时增量更新，
+ * 列检测只读取统计结果，不再扫描所有条目。字段按第一次出现的顺序排列。
+ */
+class ColumnSchema {
+public:
+    void clear();
+    
+    // 统计或重新统计一个条目，返回是否出现了新字段
+    bool addItem(const ResultItem &item);
+    
+    // 移除一个条目的统计
+    void removeItem(const ResultItem &item);
+    
+    int count(const QString &key) const { return m_counts.value(key); }  // 有该字段的条目数
+    QStringList fields() const;     // 至少一个条目有内容的字段
+    
+private:
+    QHash<QString, int> m_counts;                       // 字段 → 条目数
+    QStringList m_order;                                // 字段第一次出现的顺序
+    QHash<const ResultItem *, QStringList> m_itemFields;   // 条目 → 已统计的字段
+};
+
 class ResultTableModel : public QAbstractTableModel {
     Q_OBJECT
 public:
     ResultTableModel(QObject *parent = nullptr);
+    
+    // 设置全部条目；新列表只是在当前列表后追加时按追加处理，不重置模型
     void setItems(const QList<QSharedPointer<ResultItem>> &items, EntityType type);
     
+    // 增量更新
+    void appendItems(const QList<QSharedPointer<ResultItem>> &items);   // 在末尾插入行
+    void refreshEntity(const Mbid &mbid);   // 条目被修改（如详情到达），稍后合并发出dataChanged
+    void flushPendingUpdates();             // 立即发出尚未发出的更新
+    
     int rowCount(const QModelIndex &parent = QModelIndex()) const override;
     int columnCount(const QModelIndex &parent = QModelIndex()) const override;
     QVariant data(const QModelIndex &index, int role = Qt::DisplayRole) const override;
     QVariant headerData(int section, Qt::Orientation orientation, int role) const override;
     
+    // 按需分页加载：行数随滚动增长，尚未到达或已被释放的页面显示为占位行
+    void setPaging(int totalCount, int pageSize);   // 启用分页，pageSize为0时关闭
+    bool isPaged() const;
+    void setPage(int offset, const QList<QSharedPointer<ResultItem>> &items);  // 页面到达
+    void setPageFailed(int offset);                 // 页面加载失败
+    bool canFetchMore(const QModelIndex &parent) const override;
+    void fetchMore(const QModelIndex &parent) override;
+    
     // 排序支持
     void sort(int column, Qt::SortOrder order = Qt::AscendingOrder) override;
     
@@ -46,13 +117,62 @@ public:
     QString generateColumnDescription(const QString &key, EntityType type) const;
     
     
+signals:
+    void pageRequested(int offset);         // 分页模式下需要加载从offset开始的一页
+    
 private:
     QList<QSharedPointer<ResultItem>> m_items;
     EntityType m_type;
     QList<ColumnInfo> m_visibleColumns;  // 当前显示的列
+    QVector<ColumnAccessor> m_accessors; // 与m_visibleColumns一一对应的访问器
+    bool m_autoColumns = true;           // 列由数据检测得到（用户未手动选择），新字段出现时自动加列
+    
+    static constexpr int UPDATE_COALESCE_MS = 50;  // 合并条目更新的时间窗口
+    QSet<Mbid> m_pendingEntities;        // 等待发出dataChanged的实体
+    QTimer *m_updateTimer;               // 合并更新的定时器
+    
+    // 分页状态（m_pageSize为0时不分页）
+    enum class PageState { Pending, Loaded, Failed };
+    static constexpr int MAX_RESIDENT_PAGES = 40;  // 最多保留的已加载页面，超出时释放离可见区域最远的页面
+    int m_totalCount = 0;                // 结果总数
+    int m_pageSize = 0;                  // 每页条目数
+    mutable QMap<int, PageState> m_pages;    // 页号 → 状态；不在映射中的页面尚未加载或已释放
+    mutable QSet<int> m_wantedPages;     // 等待发出pageRequested的页面
+    mutable int m_focusRow = 0;          // 最近绘制的行，用于选择释放的页面
+    QTimer *m_pageTimer;                 // 在绘制之外发出页面请求
+    
+    void requestPage(int page) const;
+    void emitPageRequests();
+    void evictPages();
+    QVariant placeholder(int row, int column) const;
+    
+    // 一行的格式化显示值，条目的修改计数变化后重新计算
+    struct RowCache {
+        quint32 revision = 0;
+        QVector<QVariant> values;   // 为空表示尚未计算
+    };
+    mutable QVector<RowCache> m_rowCache;  // 与m_items一一对应
+    
+    // 列或条目变化后重新解析访问器并清空显示缓存
+    void resolveColumns();
+    
+    // 字段统计随条目增量更新
+    ColumnSchema m_schema;
+    
+    // 把统计中出现的新字段作为列插入到末尾
+    void insertDetectedColumns();
+    
+    // 获取单元格的显示值（使用行缓存）
+    const QVariant &displayValue(int row, int column) const;
     
-    // 根据字段键获取数据值
-    QVariant getFieldValue(const QSharedPointer<ResultItem> &item, const QString &fieldKey) const;
+    // 排序键：每行只提取一次，比较时不再访问条目
+    struct SortKeys {
+        QVector<quint8> nulls;                  // 值为空的行
+        bool numeric = true;                    // 整列都是数值
+        QVector<double> numbers;                // numeric为true时使用
+        std::vector<QCollatorSortKey> texts;    // numeric为false时使用
+    };
+    SortKeys extractSortKeys(const ColumnAccessor &accessor) const;
 };
 
 #endif // RESULTTABLEMODEL_H
@@ -1,7 +1,46 @@
 #include "entitydetailmanager.h"
 #include "../api/musicbrainzapi.h"
 #include "../core/error_types.h"
+#include <QCborArray>
+#include <QCborMap>
 #include <QDebug>
+#include <algorithm>
+
+namespace {
+
+/**
+ * @brief 从CBOR列表中收集名称
+ * @param value 对象列表（取title，没有时取name）、字符串列表或逗号分隔的字符串
+ * @return 非空的名称列表
+ */
+QStringList collectNames(const QCborValue &value)
+{
+    QStringList names;
+    if (value.isArray()) {
+        const QCborArray array = value.toArray();
+        names.reserve(array.size());
+        for (const QCborValue &element : array) {
+            QString name;
+            if (element.isMap()) {
+                const QCborMap map = element.toMap();
+                name = map.value(QLatin1String("title")).toString();
+                if (name.isEmpty()) {
+                    name = map.value(QLatin1String("name")).toString();
+                }
+            } else {
+                name = element.toString();
+            }
+            if (!name.isEmpty()) {
+                names.append(name);
+            }
+        }
+    } else if (value.isString() && !value.toString().isEmpty()) {
+        names = value.toString().split(", ");
+    }
+    return names;
+}
+
+} // namespace
 
 EntityDetailManager::EntityDetailManager(QObject *parent)
     : QObject(parent)
@@ -27,7 +66,12 @@ void EntityDetailManager::loadEntityDetails(QSharedPointer<ResultItem> item) {
         return;
     }
     
-    const QString entityId = item->getId();
+    // 详情只能按MBID查询，用16字节的值作为去重和跟踪的键
+    const Mbid entityId = item->getMbid();
+    if (entityId.isNull()) {
+        qWarning() << "Attempted to load details for entity without MBID:" << item->getId();
+        return;
+    }
       // 缓存已禁用 - 始终从服务器获取最新数据
     // if (hasDetailedInfo(entityId)) {
     //     // 实体详情已缓存，直接返回
@@ -50,8 +94,13 @@ void EntityDetailManager::loadEntityDetails(QSharedPointer<ResultItem> item) {
         qDebug() << "Added entity to batch queue:" << entityId;
     }
     
-    // 启动或重启批量处理定时器
-    m_batchTimer->start(m_batchDelay);
+    // 启动或重启批量处理定时器；本地存储中已有的实体不需要等待合并，
+    // 下一轮事件循环就处理（同一轮中加入的其他实体仍在同一批次）
+    if (m_api->hasStoredDetails(item->getId(), item->getType())) {
+        m_batchTimer->start(0);
+    } else if (!m_batchTimer->isActive() || m_batchTimer->interval() != 0) {
+        m_batchTimer->start(m_batchDelay);
+    }
 }
 
 void EntityDetailManager::loadEntitiesDetails(const QList<QSharedPointer<ResultItem>> &items) {
@@ -64,11 +113,67 @@ void EntityDetailManager::loadEntitiesDetails(const QList<QSharedPointer<ResultI
 
 
 
+void EntityDetailManager::cancelEntityDetails(const Mbid &entityId) {
+    // 已发出的请求
+    for (auto it = m_activeRequests.begin(); it != m_activeRequests.end(); ++it) {
+        if (it.value() == entityId) {
+            m_api->cancelRequest(it.key());
+            m_activeRequests.erase(it);
+            // 计入已完成，让批次可以正常结束
+            m_batchLoadedCount++;
+            m_stats.totalRequested = qMax(0, m_stats.totalRequested - 1);
+            break;
+        }
+    }
+    
+    // 批次中尚未发出的请求
+    const int index = m_currentBatch.indexOf(entityId);
+    if (index >= m_nextBatchIndex) {
+        m_currentBatch.removeAt(index);
+        m_stats.totalRequested = qMax(0, m_stats.totalRequested - 1);
+    }
+    
+    // 尚未发出或还在等待批处理定时器的请求，从队列中移除
+    if (index < 0 || index >= m_nextBatchIndex) {
+        m_batchQueue.erase(std::remove_if(m_batchQueue.begin(), m_batchQueue.end(),
+                                          [&entityId](const EntityRequest &request) {
+                                              return request.item->getMbid() == entityId;
+                                          }),
+                           m_batchQueue.end());
+    }
+    
+    m_loadingItems.remove(entityId);
+    qDebug() << "Cancelled details loading for entity:" << entityId;
+    
+    fillRequestWindow();
+}
+
+void EntityDetailManager::cancelAll() {
+    m_batchTimer->stop();
+    m_api->cancelAllRequests();
+    
+    if (!m_activeRequests.isEmpty() || !m_batchQueue.isEmpty()) {
+        qDebug() << "Cancelled" << m_activeRequests.size() << "active and"
+                 << m_batchQueue.size() << "queued detail requests";
+    }
+    
+    m_activeRequests.clear();
+    m_loadingItems.clear();
+    m_batchQueue.clear();
+    m_currentBatch.clear();
+    m_batchLoadedCount = 0;
+    m_nextBatchIndex = 0;
+}
+
 void EntityDetailManager::setBatchDelay(int milliseconds) {
     m_batchDelay = qMax(100, milliseconds); // 最小100ms
     qDebug() << "Batch delay set to:" << m_batchDelay << "ms";
 }
 
+void EntityDetailManager::setRequestPriority(RequestPriority priority) {
+    m_priority = priority;
+}
+
 void EntityDetailManager::processBatchQueue() {
     if (m_batchQueue.isEmpty()) {
         return;
@@ -80,111 +185,133 @@ void EntityDetailManager::processBatchQueue() {
     startBatchLoading();
 }
 
+void EntityDetailManager::setMaxConcurrentRequests(int count) {
+    m_maxConcurrent = qMax(1, count);
+    fillRequestWindow();
+}
+
 void EntityDetailManager::startBatchLoading() {
     if (m_batchQueue.isEmpty()) {
         return;
     }
     
-    // 准备当前批次
-    m_currentBatch.clear();
-    m_batchLoadedCount = 0;
-    m_stats.startTime = QDateTime::currentDateTime();
-      // 收集需要加载的实体ID
+    // 没有进行中的批次时开始新批次，否则把新实体追加到当前批次
+    const bool batchRunning = !m_currentBatch.isEmpty();
+    if (!batchRunning) {
+        m_batchLoadedCount = 0;
+        m_nextBatchIndex = 0;
+        m_stats.startTime = QDateTime::currentDateTime();
+        m_stats.totalRequested = 0;
+        m_stats.totalLoaded = 0;
+        m_stats.totalFailed = 0;
+    }
+    
+    // 收集需要加载的实体ID
+    int added = 0;
     for (const auto &request : m_batchQueue) {
-        const QString entityId = request.item->getId();
+        const Mbid entityId = request.item->getMbid();
         // 缓存已禁用，直接加载所有实体
-        if (!m_loadingItems.contains(entityId)) {
+        if (!m_loadingItems.contains(entityId) && !m_currentBatch.contains(entityId)) {
             m_currentBatch.append(entityId);
             m_loadingItems.insert(entityId);
+            added++;
         }
     }
     
-    m_stats.totalRequested = m_currentBatch.size();
+    m_stats.totalRequested += added;
     
     if (m_currentBatch.isEmpty()) {
         qDebug() << "No entities need loading in current batch";
-        emit batchLoadingCompleted(QStringList());
+        emit batchLoadingCompleted(QList<Mbid>());
         m_batchQueue.clear();
         return;
     }
     
-    qDebug() << "Starting batch loading for" << m_currentBatch.size() << "entities";
+    qDebug() << (batchRunning ? "Extending batch with" : "Starting batch loading for") << added << "entities,"
+             << "window size:" << m_maxConcurrent;
     
-    // 开始加载第一个实体
-    processNextInBatch();
+    fillRequestWindow();
 }
 
-void EntityDetailManager::processNextInBatch() {
-    if (m_batchLoadedCount >= m_currentBatch.size()) {
+EntityDetailManager::EntityRequest *EntityDetailManager::findRequest(const Mbid &entityId) {
+    for (auto &req : m_batchQueue) {
+        if (req.item->getMbid() == entityId) {
+            return &req;
+        }
+    }
+    return nullptr;
+}
+
+void EntityDetailManager::fillRequestWindow() {
+    while (m_activeRequests.size() < m_maxConcurrent && m_nextBatchIndex < m_currentBatch.size()) {
+        const Mbid entityId = m_currentBatch[m_nextBatchIndex++];
+        
+        EntityRequest *request = findRequest(entityId);
+        if (!request) {
+            qWarning() << "Could not find request for entity:" << entityId;
+            m_loadingItems.remove(entityId);
+            m_stats.totalFailed++;
+            m_batchLoadedCount++;
+            continue;
+        }
+        
+        // 发送API请求
+        qDebug() << "Loading details for entity:" << entityId 
+                 << "(type:" << static_cast<int>(request->item->getType()) << ")";
+        
+        const RequestId requestId = m_api->getDetails(request->item->getId(), request->item->getType(), m_priority);
+        if (requestId == 0) {
+            // 参数无效，API已同步发出errorOccurred(…, 0)，这里直接记为失败
+            m_loadingItems.remove(entityId);
+            m_stats.totalFailed++;
+            m_batchLoadedCount++;
+            emit detailsLoadingFailed(entityId, ErrorInfo(ErrorCode::ApiServerError, m_api->getLastErrorMessage()));
+            continue;
+        }
+        
+        m_activeRequests.insert(requestId, entityId);
+    }
+    
+    if (!m_currentBatch.isEmpty() && m_batchLoadedCount >= m_currentBatch.size()) {
         // 批量加载完成
         qDebug() << "Batch loading completed:" << m_stats.totalLoaded 
                  << "/" << m_stats.totalRequested << "entities loaded";
         
-        emit batchLoadingCompleted(m_currentBatch);
-        emit batchLoadingProgress(m_stats.totalLoaded, m_stats.totalRequested);
+        const QList<Mbid> completedBatch = m_currentBatch;
         
-        // 清理
-        m_batchQueue.clear();
+        // 清理（保留批次完成前新加入、尚未处理的请求）
+        m_batchQueue.erase(std::remove_if(m_batchQueue.begin(), m_batchQueue.end(),
+                                          [&completedBatch](const EntityRequest &request) {
+                                              return completedBatch.contains(request.item->getMbid());
+                                          }),
+                           m_batchQueue.end());
         m_currentBatch.clear();
-        return;
-    }
-    
-    // 找到下一个需要加载的实体
-    const QString entityId = m_currentBatch[m_batchLoadedCount];
-    
-    // 在队列中找到对应的请求
-    EntityRequest *request = nullptr;
-    for (auto &req : m_batchQueue) {
-        if (req.item->getId() == entityId) {
-            request = &req;
-            break;
-        }
-    }
-    
-    if (!request) {
-        qWarning() << "Could not find request for entity:" << entityId;
-        m_batchLoadedCount++;
-        processNextInBatch();
-        return;
+        m_batchLoadedCount = 0;
+        m_nextBatchIndex = 0;
+        
+        emit batchLoadingProgress(m_stats.totalLoaded, m_stats.totalRequested);
+        emit batchLoadingCompleted(completedBatch);
     }
-    
-    // 发送API请求
-    qDebug() << "Loading details for entity:" << entityId 
-             << "(type:" << static_cast<int>(request->item->getType()) << ")";
-    
-    m_api->getDetails(entityId, request->item->getType());
 }
 
-void EntityDetailManager::onApiDetailsReady(const QVariantMap &details, EntityType type) {
+void EntityDetailManager::onApiDetailsReady(const EntityPayload &details, EntityType type, RequestId requestId) {
     Q_UNUSED(type) // 参数在当前实现中暂未使用
     
-    // 从详细信息中提取实体ID
-    QString entityId = details.value("id").toString();
-    
-    if (entityId.isEmpty()) {
-        qWarning() << "Received details without entity ID";
+    // 按请求ID找到对应的实体
+    const Mbid entityId = m_activeRequests.take(requestId);
+    if (entityId.isNull()) {
         return;
     }
     
     qDebug() << "Received details for entity:" << entityId 
              << "keys:" << details.keys().join(", ");
     
-    // 打印详细信息内容以便调试
-    for (auto it = details.constBegin(); it != details.constEnd(); ++it) {
-        qDebug() << "Detail key:" << it.key() << "=" << it.value().toString();
-    }
-      // 缓存已禁用，不再保存到缓存
-    // addToCache(entityId, details);
-    
     // 移除加载状态
     m_loadingItems.remove(entityId);
     
     // 增强实体信息
-    for (const auto &request : m_batchQueue) {
-        if (request.item->getId() == entityId) {
-            enrichEntityInfo(request.item, details);
-            break;
-        }
+    if (EntityRequest *request = findRequest(entityId)) {
+        enrichEntityInfo(request->item, details);
     }
     
     // 发送信号
@@ -197,34 +324,32 @@ void EntityDetailManager::onApiDetailsReady(const QVariantMap &details, EntityTy
     // 发送进度信号
     emit batchLoadingProgress(m_stats.totalLoaded, m_stats.totalRequested);
     
-    // 处理下一个实体
-    QTimer::singleShot(100, this, &EntityDetailManager::processNextInBatch); // 100ms间隔避免API限流
+    // 窗口腾出位置，继续发送
+    fillRequestWindow();
 }
 
-void EntityDetailManager::onApiErrorOccurred(const QString &error) {
-    qCritical() << "API error occurred:" << error;
+void EntityDetailManager::onApiErrorOccurred(const QString &error, RequestId requestId) {
+    // 请求ID为0的错误在fillRequestWindow中已同步处理
+    const Mbid failedEntityId = m_activeRequests.take(requestId);
+    if (failedEntityId.isNull()) {
+        return;
+    }
+    
+    qCritical() << "API error occurred for entity" << failedEntityId << ":" << error;
     
     // 更新统计
     m_stats.totalFailed++;
     m_batchLoadedCount++;
+    m_loadingItems.remove(failedEntityId);
     
-    // 创建错误信息
-    ErrorInfo errorInfo(ErrorCode::ApiServerError, error);
+    emit detailsLoadingFailed(failedEntityId, ErrorInfo(ErrorCode::ApiServerError, error));
     
-    // 如果是批量加载中的错误，继续处理下一个
-    if (m_batchLoadedCount < m_currentBatch.size()) {
-        const QString failedEntityId = m_currentBatch[m_batchLoadedCount - 1];
-        m_loadingItems.remove(failedEntityId);
-        emit detailsLoadingFailed(failedEntityId, errorInfo);
-        
-        // 继续处理下一个实体
-        QTimer::singleShot(200, this, &EntityDetailManager::processNextInBatch); // 稍长间隔以避免连续错误
-    }
+    fillRequestWindow();
 }
 
-bool EntityDetailManager::isEntityInQueue(const QString &entityId) const {
+bool EntityDetailManager::isEntityInQueue(const Mbid &entityId) const {
     for (const auto &request : m_batchQueue) {
-        if (request.item->getId() == entityId) {
+        if (request.item->getMbid() == entityId) {
             return true;
         }
     }
@@ -233,246 +358,108 @@ bool EntityDetailManager::isEntityInQueue(const QString &entityId) const {
 
 
 
-void EntityDetailManager::enrichEntityInfo(QSharedPointer<ResultItem> item, const QVariantMap &details) {
+void EntityDetailManager::enrichEntityInfo(QSharedPointer<ResultItem> item, const EntityPayload &details) {
     if (!item) {
         return;
     }
     
+    // 派生的显示字段直接从共享的CBOR数据读取，最后与原始详细数据一起一次写入条目
+    const QCborMap fields = details.details();
+    auto field = [&fields](const char *key) {
+        return fields.value(QLatin1String(key));
+    };
+    QVariantMap derived;
+    
     // 根据实体类型增强信息
     switch (item->getType()) {
         case EntityType::Artist: {
             // 添加艺术家特定信息
-            if (details.contains("life-span")) {
-                QVariantMap lifeSpan = details["life-span"].toMap();
-                QString begin = lifeSpan["begin"].toString();
-                QString end = lifeSpan["end"].toString();
-                if (!begin.isEmpty()) {
-                    item->setDetailProperty("birth_date", begin);
-                }
-                if (!end.isEmpty()) {
-                    item->setDetailProperty("death_date", end);
-                }
+            const QCborMap lifeSpan = field("life-span").toMap();
+            const QString begin = lifeSpan.value(QLatin1String("begin")).toString();
+            const QString end = lifeSpan.value(QLatin1String("end")).toString();
+            if (!begin.isEmpty()) {
+                derived.insert(QStringLiteral("birth_date"), begin);
             }
-            
-            if (details.contains("area")) {
-                QVariantMap area = details["area"].toMap();
-                item->setDetailProperty("origin", area["name"].toString());
-                if (area.contains("iso-3166-1-codes")) {
-                    QVariantList codes = area["iso-3166-1-codes"].toList();
-                    if (!codes.isEmpty()) {
-                        item->setDetailProperty("country", codes.first().toString());
-                    }
-                }
+            if (!end.isEmpty()) {
+                derived.insert(QStringLiteral("death_date"), end);
             }
             
-            if (details.contains("type")) {
-                item->setDetailProperty("artist_type", details["type"].toString());
+            if (fields.contains(QLatin1String("area"))) {
+                const QCborMap area = field("area").toMap();
+                derived.insert(QStringLiteral("origin"), area.value(QLatin1String("name")).toString());
+                const QCborArray codes = area.value(QLatin1String("iso-3166-1-codes")).toArray();
+                if (!codes.isEmpty()) {
+                    derived.insert(QStringLiteral("country"), codes.first().toString());
+                }
             }
             
-            if (details.contains("gender")) {
-                item->setDetailProperty("gender", details["gender"].toString());
+            if (fields.contains(QLatin1String("type"))) {
+                derived.insert(QStringLiteral("artist_type"), field("type").toString());
             }
             
-            // 处理发行数量
-            if (details.contains("releaseCount")) {
-                item->setDetailProperty("release_count", details["releaseCount"].toInt());
+            // 处理发行和录音数量
+            if (fields.contains(QLatin1String("releaseCount"))) {
+                derived.insert(QStringLiteral("release_count"), int(field("releaseCount").toInteger()));
             }
-              // 处理录音数量和录音列表
-            if (details.contains("recordingCount")) {
-                item->setDetailProperty("recording_count", details["recordingCount"].toInt());
+            if (fields.contains(QLatin1String("recordingCount"))) {
+                derived.insert(QStringLiteral("recording_count"), int(field("recordingCount").toInteger()));
             }
             
-            // 处理录音列表
-            if (details.contains("recordings")) {
-                QVariant recordingsData = details["recordings"];
-                QStringList recordingNames;
-                
-                if (recordingsData.canConvert<QVariantList>()) {
-                    // 如果是对象列表
-                    QVariantList recordingsList = recordingsData.toList();
-                    for (const auto &recording : recordingsList) {
-                        if (recording.canConvert<QVariantMap>()) {
-                            QVariantMap recordingMap = recording.toMap();
-                            QString title = recordingMap.value("title", recordingMap.value("name")).toString();
-                            if (!title.isEmpty()) {
-                                recordingNames.append(title);
-                            }
-                        } else {
-                            // 简单字符串
-                            recordingNames.append(recording.toString());
-                        }
-                    }
-                } else if (recordingsData.canConvert<QStringList>()) {
-                    // 如果直接是字符串列表
-                    recordingNames = recordingsData.toStringList();
-                } else {
-                    // 如果是逗号分隔的字符串
-                    QString recordingsStr = recordingsData.toString();
-                    if (!recordingsStr.isEmpty()) {
-                        recordingNames = recordingsStr.split(", ");
-                    }
-                }
-                
-                if (!recordingNames.isEmpty()) {
-                    item->setDetailProperty("recordings", recordingNames);
-                    item->setDetailProperty("recording_names", recordingNames.join(", "));
-                }
+            // 录音、作品和发行列表只保留名称
+            const QStringList recordingNames = collectNames(field("recordings"));
+            if (!recordingNames.isEmpty()) {
+                derived.insert(QStringLiteral("recordings"), recordingNames);
+                derived.insert(QStringLiteral("recording_names"), recordingNames.join(", "));
             }
-            
-            // 处理作品列表
-            if (details.contains("works")) {
-                QVariant worksData = details["works"];
-                QStringList workNames;
-                
-                if (worksData.canConvert<QVariantList>()) {
-                    // 如果是对象列表
-                    QVariantList worksList = worksData.toList();
-                    for (const auto &work : worksList) {
-                        if (work.canConvert<QVariantMap>()) {
-                            QVariantMap workMap = work.toMap();
-                            QString title = workMap.value("title", workMap.value("name")).toString();
-                            if (!title.isEmpty()) {
-                                workNames.append(title);
-                            }
-                        } else {
-                            // 简单字符串
-                            workNames.append(work.toString());
-                        }
-                    }
-                } else if (worksData.canConvert<QStringList>()) {
-                    // 如果直接是字符串列表
-                    workNames = worksData.toStringList();
-                } else {
-                    // 如果是逗号分隔的字符串
-                    QString worksStr = worksData.toString();
-                    if (!worksStr.isEmpty()) {
-                        workNames = worksStr.split(", ");
-                    }
-                }
-                
-                if (!workNames.isEmpty()) {
-                    item->setDetailProperty("works", workNames);
-                    item->setDetailProperty("work_names", workNames.join(", "));
-                }
+            const QStringList workNames = collectNames(field("works"));
+            if (!workNames.isEmpty()) {
+                derived.insert(QStringLiteral("works"), workNames);
+                derived.insert(QStringLiteral("work_names"), workNames.join(", "));
             }
-            
-            // 处理发行列表
-            if (details.contains("releases")) {
-                QVariant releasesData = details["releases"];
-                QStringList releaseNames;
-                
-                if (releasesData.canConvert<QVariantList>()) {
-                    // 如果是对象列表
-                    QVariantList releasesList = releasesData.toList();
-                    for (const auto &release : releasesList) {
-                        if (release.canConvert<QVariantMap>()) {
-                            QVariantMap releaseMap = release.toMap();
-                            QString title = releaseMap.value("title", releaseMap.value("name")).toString();
-                            if (!title.isEmpty()) {
-                                releaseNames.append(title);
-                            }
-                        } else {
-                            // 简单字符串
-                            releaseNames.append(release.toString());
-                        }
-                    }
-                } else if (releasesData.canConvert<QStringList>()) {
-                    // 如果直接是字符串列表
-                    releaseNames = releasesData.toStringList();
-                } else {
-                    // 如果是逗号分隔的字符串
-                    QString releasesStr = releasesData.toString();
-                    if (!releasesStr.isEmpty()) {
-                        releaseNames = releasesStr.split(", ");
-                    }
-                }
-                
-                if (!releaseNames.isEmpty()) {
-                    item->setDetailProperty("releases", releaseNames);
-                    item->setDetailProperty("release_names", releaseNames.join(", "));
-                }
+            const QStringList releaseNames = collectNames(field("releases"));
+            if (!releaseNames.isEmpty()) {
+                derived.insert(QStringLiteral("releases"), releaseNames);
+                derived.insert(QStringLiteral("release_names"), releaseNames.join(", "));
             }
             
             // 处理别名
-            if (details.contains("aliases")) {
-                QVariantList aliases = details["aliases"].toList();
-                QStringList aliasNames;
-                for (const auto &alias : aliases) {
-                    QVariantMap aliasMap = alias.toMap();
-                    QString name = aliasMap["name"].toString();
-                    if (!name.isEmpty()) {
-                        aliasNames.append(name);
-                    }
-                }
-                if (!aliasNames.isEmpty()) {
-                    item->setDetailProperty("aliases", aliasNames);
-                }
+            const QStringList aliasNames = collectNames(field("aliases"));
+            if (!aliasNames.isEmpty()) {
+                derived.insert(QStringLiteral("aliases"), aliasNames);
             }
-            
             break;
         }
         
-        case EntityType::Release: {            // 添加发行特定信息
-            if (details.contains("date")) {
-                item->setDetailProperty("release_date", details["date"].toString());
+        case EntityType::Release: {
+            // 添加发行特定信息
+            if (fields.contains(QLatin1String("date"))) {
+                derived.insert(QStringLiteral("release_date"), field("date").toString());
             }
-            
-            if (details.contains("country")) {
-                item->setDetailProperty("country", details["country"].toString());
-            }
-            
-            if (details.contains("status")) {
-                item->setDetailProperty("status", details["status"].toString());
-            }
-            
-            if (details.contains("track-count")) {
-                item->setDetailProperty("track_count", details["track-count"].toInt());
+            if (fields.contains(QLatin1String("track-count"))) {
+                derived.insert(QStringLiteral("track_count"), int(field("track-count").toInteger()));
             }
             break;
         }
         
         case EntityType::Recording: {
             // 添加录音特定信息
-            if (details.contains("length")) {
-                item->setDetailProperty("duration", details["length"].toInt());
-            }
-            
-            if (details.contains("disambiguation")) {
-                item->setDetailProperty("disambiguation", details["disambiguation"].toString());
+            if (fields.contains(QLatin1String("length"))) {
+                derived.insert(QStringLiteral("duration"), int(field("length").toInteger()));
             }
             break;
         }
-          default:
+        default:
             break;
     }
     
     // 通用属性
-    if (details.contains("disambiguation")) {
-        item->setDetailProperty("disambiguation", details["disambiguation"].toString());
+    if (fields.contains(QLatin1String("tags"))) {
+        derived.insert(QStringLiteral("tags"), collectNames(field("tags")));
     }
     
-    if (details.contains("tags")) {
-        QVariantList tags = details["tags"].toList();
-        QStringList tagNames;
-        for (const auto &tag : tags) {
-            QVariantMap tagMap = tag.toMap();
-            tagNames.append(tagMap["name"].toString());
-        }
-        item->setDetailProperty("tags", tagNames);
-    }
-    
-    // 保存所有原始详细数据，确保不丢失任何信息
-    QVariantMap currentDetailData = item->getDetailData();
-    for (auto it = details.constBegin(); it != details.constEnd(); ++it) {
-        QString key = it.key();
-        QVariant value = it.value();
-        
-        // 如果键还没有被处理过，就直接保存
-        if (!currentDetailData.contains(key)) {
-            item->setDetailProperty(key, value);
-        }
-    }
+    // 原始详细数据和派生字段一次写入，派生字段优先
+    details.applyTo(*item, derived);
     
     qDebug() << "Enriched entity info for:" << item->getId() 
-             << "total detail fields:" << item->getDetailData().size();
+             << "detail fields:" << fields.size() << "derived fields:" << derived.size();
 }
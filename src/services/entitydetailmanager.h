@@ -6,10 +6,14 @@
 #include <QVariantMap>
 #include <QTimer>
 #include <QSet>
+#include <QHash>
 #include <QDateTime>
 #include "../core/types.h"
 #include "../core/error_types.h"
 #include "../models/resultitem.h"
+#include "../models/entitypayload.h"
+#include "../api/api_utils.h"
+#include "../core/mbid.h"
 
 class MusicBrainzApi;
 
@@ -23,7 +27,8 @@ class MusicBrainzApi;
  * **核心特性：**
  * - **批量加载优化**: 自动将多个请求合并处理，减少API调用次数
  * - **智能延迟**: 可配置的批量处理延迟，平衡响应性和效率
- * - **实时数据**: 当前版本禁用缓存，确保数据始终是最新的
+ * - **本地存储优先**: 新鲜期内的详情直接从本地实体存储返回（见EntityStore），
+ *   过期后才重新请求服务器
  * - **进度跟踪**: 提供详细的加载进度和统计信息
  * - **错误恢复**: 内置重试机制和错误处理
  * 
@@ -43,11 +48,12 @@ class MusicBrainzApi;
  * 
  * **性能说明：**
  * - 默认批处理延迟: 500ms
- * - 支持并发请求处理
- * - 内存使用优化（缓存已禁用）
+ * - 同时保持最多N个详情请求在途（默认6个），实际发送速率由全局令牌桶限制
+ * - 响应按请求ID对应到实体，不依赖请求顺序
+ * - 本地存储中已有的实体不等待批处理延迟，命中时没有网络往返
  * 
- * @note 缓存功能在当前版本中已禁用，以确保数据实时性。
- *       相关接口保留以维持API兼容性。
+ * @note 管理器自身不在内存中缓存详情，跨会话的复用由本地实体存储完成，
+ *       新鲜期由NetworkConfig::entityStoreMaxAgeSeconds配置。
  * 
  * @author MusicBrainzQt Team
  * @see MusicBrainzApi, ResultItem
@@ -92,6 +98,22 @@ public:
      */
     void loadEntitiesDetails(const QList<QSharedPointer<ResultItem>> &items);
     
+    /**
+     * @brief 取消单个实体的详情加载
+     * @param entityId 实体MBID
+     * 
+     * 实体还在批量队列中时直接移除；请求已发出时取消对应的API请求。
+     * 被取消的实体不会发出entityDetailsLoaded或detailsLoadingFailed，
+     * 也不计入批次的成功或失败数。
+     */
+    void cancelEntityDetails(const Mbid &entityId);
+    
+    /**
+     * @brief 取消所有未完成的详情加载
+     * 
+     * 清空批量队列并取消所有在途请求，不发出batchLoadingCompleted。
+     */
+    void cancelAll();
     
     
     // =============================================================================
@@ -112,35 +134,53 @@ public:
      * - 高效批处理: 1000-2000ms
      */
     void setBatchDelay(int milliseconds);
+    
+    /**
+     * @brief 设置详情请求的优先级
+     * @param priority 请求优先级
+     * 
+     * 默认使用Prefetch，保证用户的搜索等交互请求不会排在后台加载之后。
+     * 由用户直接打开详情页触发的加载应设置为Interactive。
+     */
+    void setRequestPriority(RequestPriority priority);
+    
+    /**
+     * @brief 设置同时在途的最大详情请求数
+     * @param count 请求窗口大小（最小为1）
+     * 
+     * 窗口只决定同时排队/在途的请求数量，实际发送速率仍由
+     * 全局速率限制决定，因此可以放心设置得比速率略大。
+     */
+    void setMaxConcurrentRequests(int count);
 
 signals:
     /**
      * @brief 单个实体详细信息加载完成信号
-     * @param entityId 实体ID
+     * @param entityId 实体MBID
      * @param details 详细信息数据
      * 
      * 当单个实体的详细信息成功从API加载后发出。
-     * details包含从MusicBrainz API获取的完整实体信息。
+     * details包含从MusicBrainz API获取的完整实体信息，与解析结果共享存储。
      */
-    void entityDetailsLoaded(const QString &entityId, const QVariantMap &details);
+    void entityDetailsLoaded(const Mbid &entityId, const EntityPayload &details);
     
     /**
      * @brief 批量加载完成信号
-     * @param loadedEntityIds 成功加载的实体ID列表
+     * @param loadedEntityIds 本批次的实体MBID列表
      * 
      * 当一个批次的所有实体都完成加载时发出。
      * 不包含加载失败的实体ID。
      */
-    void batchLoadingCompleted(const QStringList &loadedEntityIds);
+    void batchLoadingCompleted(const QList<Mbid> &loadedEntityIds);
     
     /**
      * @brief 加载失败信号
-     * @param entityId 失败的实体ID
+     * @param entityId 失败的实体MBID
      * @param error 错误信息
      * 
      * 当实体详细信息加载失败时发出，包含具体的错误信息。
      */
-    void detailsLoadingFailed(const QString &entityId, const ErrorInfo &error);
+    void detailsLoadingFailed(const Mbid &entityId, const ErrorInfo &error);
     
     /**
      * @brief 批量加载进度信号
@@ -156,14 +196,16 @@ private slots:
      * @brief 处理API返回的详细信息
      * @param details 详细信息数据
      * @param type 实体类型
+     * @param requestId 请求ID
      */
-    void onApiDetailsReady(const QVariantMap &details, EntityType type);
+    void onApiDetailsReady(const EntityPayload &details, EntityType type, RequestId requestId);
     
     /**
      * @brief 处理API错误
      * @param error 错误信息
+     * @param requestId 出错请求的ID
      */
-    void onApiErrorOccurred(const QString &error);
+    void onApiErrorOccurred(const QString &error, RequestId requestId);
     
     /**
      * @brief 处理批量队列
@@ -193,16 +235,20 @@ private:
     
     // 缓存相关（已禁用但保留结构）
     
-    QSet<QString> m_loadingItems;                       ///< 正在加载的实体ID集合
+    QSet<Mbid> m_loadingItems;                          ///< 正在加载的实体MBID集合
     
     // 批量加载队列管理
     QList<EntityRequest> m_batchQueue;                  ///< 批量加载队列
     QTimer *m_batchTimer;                               ///< 批量处理定时器
     int m_batchDelay = 500;                             ///< 批量处理延迟时间（毫秒）
+    RequestPriority m_priority = RequestPriority::Prefetch;  ///< 详情请求优先级
+    int m_maxConcurrent = 6;                            ///< 同时在途的最大请求数
     
     // 批量加载状态跟踪
-    QStringList m_currentBatch;                         ///< 当前批次的实体ID列表
-    int m_batchLoadedCount = 0;                         ///< 当前批次已加载数量
+    QList<Mbid> m_currentBatch;                         ///< 当前批次的实体MBID列表
+    int m_batchLoadedCount = 0;                         ///< 当前批次已完成数量（成功或失败）
+    int m_nextBatchIndex = 0;                           ///< 当前批次中下一个要发送的实体
+    QHash<RequestId, Mbid> m_activeRequests;            ///< 在途请求ID -> 实体MBID
     
     /**
      * @struct LoadingStats
@@ -229,18 +275,26 @@ private:
     void startBatchLoading();
     
     /**
-     * @brief 处理批次中的下一个实体
+     * @brief 填充请求窗口
      * 
-     * 顺序处理批次队列中的实体，发送API请求。
+     * 在在途请求数低于上限时继续发送批次中的后续实体；
+     * 批次全部完成时发出batchLoadingCompleted。
+     */
+    void fillRequestWindow();
+    
+    /**
+     * @brief 查找批量队列中的实体请求
+     * @param entityId 实体MBID
+     * @return 请求指针，不存在时为nullptr
      */
-    void processNextInBatch();
+    EntityRequest *findRequest(const Mbid &entityId);
     
     /**
      * @brief 检查实体是否在队列中
-     * @param entityId 实体ID
+     * @param entityId 实体MBID
      * @return true 如果实体已在处理队列中
      */
-    bool isEntityInQueue(const QString &entityId) const;
+    bool isEntityInQueue(const Mbid &entityId) const;
     
     
     
@@ -251,7 +305,7 @@ private:
      * 
      * 将API返回的详细信息整合到ResultItem对象中。
      */
-    void enrichEntityInfo(QSharedPointer<ResultItem> item, const QVariantMap &details);
+    void enrichEntityInfo(QSharedPointer<ResultItem> item, const EntityPayload &details);
 };
 
 #endif // ENTITYDETAILMANAGER_H
@@ -7,6 +7,7 @@
 SearchService::SearchService(QObject *parent)
     : QObject(parent)
     , m_api(new MusicBrainzApi(this))
+    , m_pageApi(new MusicBrainzApi(this))
     , m_currentPage(0)
     , m_totalPages(0)
     , m_itemsPerPage(25)
@@ -16,6 +17,12 @@ SearchService::SearchService(QObject *parent)
             this, &SearchService::handleApiResults);
     connect(m_api, &MusicBrainzApi::errorOccurred,
             this, &SearchService::handleApiError);
+    connect(m_api, &MusicBrainzApi::partialResultsReady,
+            this, &SearchService::handleApiPartialResults);
+    connect(m_pageApi, &MusicBrainzApi::searchResultsReady,
+            this, &SearchService::handlePageResults);
+    connect(m_pageApi, &MusicBrainzApi::errorOccurred,
+            this, &SearchService::handlePageError);
 }
 
 void SearchService::search(const SearchParameters &params)
@@ -25,6 +32,7 @@ void SearchService::search(const SearchParameters &params)
         return;
     }
 
+    cancelPageRequests();
     m_currentParams = params;
     m_currentParams.offset = 0;
     m_currentPage = 0;
@@ -97,6 +105,36 @@ int SearchService::getTotalResults() const
     return m_currentResults.totalCount;
 }
 
+RequestId SearchService::fetchResultsPage(int offset)
+{
+    if (m_cachedQueryString.isEmpty() || offset < 0) {
+        return 0;
+    }
+
+    auto it = m_pageRequests.constFind(offset);
+    if (it != m_pageRequests.constEnd()) {
+        return it.value();
+    }
+
+    const RequestId ticket = m_pageApi->search(m_cachedQueryString, m_currentParams.type, m_itemsPerPage, offset);
+    if (ticket != 0) {
+        m_pageRequests.insert(offset, ticket);
+    }
+    return ticket;
+}
+
+void SearchService::cancelSearch()
+{
+    cancelPageRequests();
+    if (m_currentRequest == 0) {
+        return;
+    }
+
+    qDebug() << "SearchService: Cancelling search request" << m_currentRequest;
+    m_api->cancelRequest(m_currentRequest);
+    m_currentRequest = 0;
+}
+
 SearchParameters SearchService::getCurrentSearchParams() const
 {
     return m_currentParams;
@@ -106,6 +144,7 @@ SearchParameters SearchService::getCurrentSearchParams() const
 
 void SearchService::handleApiResults(const QList<QSharedPointer<ResultItem>> &results, int totalCount, int offset)
 {
+    m_currentRequest = 0;
     m_currentResults = SearchResults(totalCount, offset, results.size());
     m_currentParams.offset = offset;
     updatePageInfo();
@@ -119,10 +158,49 @@ void SearchService::handleApiResults(const QList<QSharedPointer<ResultItem>> &re
 
 void SearchService::handleApiError(const QString &error)
 {
+    m_currentRequest = 0;
     qDebug() << "SearchService: API error:" << error;
     emit searchFailed(error);
 }
 
+void SearchService::handleApiPartialResults(const QList<QSharedPointer<ResultItem>> &results, RequestId requestId)
+{
+    if (requestId != m_currentRequest || results.isEmpty()) {
+        return;
+    }
+
+    const bool firstChunk = !m_receivedPartial;
+    m_receivedPartial = true;
+    emit searchPartialResults(results, firstChunk);
+}
+
+void SearchService::handlePageResults(const QList<QSharedPointer<ResultItem>> &results, int totalCount, int offset)
+{
+    m_pageRequests.remove(offset);
+    emit resultsPageFetched(results, totalCount, offset);
+}
+
+void SearchService::handlePageError(const QString &error, RequestId requestId)
+{
+    for (auto it = m_pageRequests.begin(); it != m_pageRequests.end(); ++it) {
+        if (it.value() == requestId) {
+            const int offset = it.key();
+            m_pageRequests.erase(it);
+            emit resultsPageFailed(offset, error);
+            return;
+        }
+    }
+}
+
+void SearchService::cancelPageRequests()
+{
+    if (m_pageRequests.isEmpty()) {
+        return;
+    }
+    m_pageApi->cancelAllRequests();
+    m_pageRequests.clear();
+}
+
 void SearchService::updatePageInfo()
 {
     if (m_currentResults.totalCount > 0 && m_itemsPerPage > 0) {
@@ -141,8 +219,12 @@ void SearchService::requestOffset(int offset)
         return;
     }
 
+    // 新的页面请求取代尚未返回的旧请求
+    cancelSearch();
+
     m_currentParams.offset = offset;
-    m_api->search(m_cachedQueryString, m_currentParams.type, m_itemsPerPage, offset);
+    m_receivedPartial = false;
+    m_currentRequest = m_api->search(m_cachedQueryString, m_currentParams.type, m_itemsPerPage, offset);
 }
 
 QString SearchService::buildQueryString(const SearchParameters &params) const
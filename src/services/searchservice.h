@@ -1,10 +1,12 @@
 #ifndef SEARCHSERVICE_H
 #define SEARCHSERVICE_H
 
+#include <QHash>
 #include <QObject>
 #include <QSharedPointer>
 #include <QString>
 #include "../core/types.h"
+#include "../api/api_utils.h"
 
 class ResultItem;
 class MusicBrainzApi;
@@ -84,6 +86,36 @@ public:
      * 需要先调用search()建立搜索上下文。
      */
     void searchPrevPage();
+
+    /**
+     * @brief 取消正在进行的搜索请求
+     * 
+     * 结果不再需要时（例如结果标签页已关闭）调用，取消后不会发出
+     * searchCompleted或searchFailed。发起新的搜索或翻页时，
+     * 尚未返回的上一个请求也会被自动取消。
+     */
+    void cancelSearch();
+
+    /**
+     * @brief 按偏移量加载当前搜索的一页结果（用于滚动加载）
+     * @param offset 结果集偏移量
+     * @return 请求ID；没有进行中的搜索或请求无法发出时返回0
+     * 
+     * 与翻页不同，页面请求不会取代当前请求，多个页面可以同时加载。
+     * 结果通过resultsPageFetched/resultsPageFailed返回；同一偏移量的页面
+     * 正在加载时不会重复请求。发起新的搜索时所有页面请求都会被取消。
+     */
+    RequestId fetchResultsPage(int offset);
+    
+    /**
+     * @brief 获取每页条目数
+     */
+    int getItemsPerPage() const { return m_itemsPerPage; }
+
+    /**
+     * @brief 检查是否有搜索请求在进行中
+     */
+    bool isSearching() const { return m_currentRequest != 0; }
     
     // =============================================================================
     // 状态查询接口
@@ -144,6 +176,16 @@ signals:
      */
     void searchCompleted(const QList<QSharedPointer<ResultItem>> &results, const SearchResults &stats);
     
+    /**
+     * @brief 部分结果信号
+     * @param results 新到达的结果（只包含本次新增的部分）
+     * @param firstChunk 是否为本次请求的第一批结果（接收方应替换旧页面）
+     * 
+     * 响应边下载边解析时，完整结果到达前可能多次发出。随后的searchCompleted
+     * 仍包含全部结果，且以这些结果开头，接收方可以只追加新增的部分。
+     */
+    void searchPartialResults(const QList<QSharedPointer<ResultItem>> &results, bool firstChunk);
+    
     /**
      * @brief 搜索失败信号
      * @param error 错误描述信息
@@ -160,6 +202,21 @@ signals:
      * 分页状态发生变化时发出。
      */
     void pageChanged(int currentPage, int totalPages);
+    
+    /**
+     * @brief 滚动加载的页面到达信号
+     * @param results 该页的结果
+     * @param totalCount 总结果数
+     * @param offset 该页的偏移量
+     */
+    void resultsPageFetched(const QList<QSharedPointer<ResultItem>> &results, int totalCount, int offset);
+    
+    /**
+     * @brief 滚动加载的页面失败信号
+     * @param offset 该页的偏移量
+     * @param error 错误描述信息
+     */
+    void resultsPageFailed(int offset, const QString &error);
 
 private slots:
     /**
@@ -175,6 +232,23 @@ private slots:
      * @param error 错误信息
      */
     void handleApiError(const QString &error);
+    
+    /**
+     * @brief 处理流式解析的部分结果
+     * @param results 新解析出的结果
+     * @param requestId 请求ID，不是当前请求时忽略
+     */
+    void handleApiPartialResults(const QList<QSharedPointer<ResultItem>> &results, RequestId requestId);
+    
+    /**
+     * @brief 处理滚动加载的页面结果
+     */
+    void handlePageResults(const QList<QSharedPointer<ResultItem>> &results, int totalCount, int offset);
+    
+    /**
+     * @brief 处理滚动加载的页面错误
+     */
+    void handlePageError(const QString &error, RequestId requestId);
 
 private:
     /**
@@ -190,6 +264,11 @@ private:
      */
     void updatePageInfo();
     
+    /**
+     * @brief 取消所有滚动加载的页面请求
+     */
+    void cancelPageRequests();
+    
     /**
      * @brief 构建查询字符串
      * @param params 搜索参数
@@ -204,12 +283,16 @@ private:
     // =============================================================================
     
     MusicBrainzApi *m_api;              ///< MusicBrainz API接口
+    MusicBrainzApi *m_pageApi;          ///< 滚动加载页面使用的API接口（结果与当前请求分开）
     SearchParameters m_currentParams;       ///< 当前搜索参数
     SearchResults m_currentResults;         ///< 当前搜索结果统计
     int m_currentPage;                      ///< 当前页码（从0开始，仅内部使用）
     int m_totalPages;                       ///< 总页数
     int m_itemsPerPage;                     ///< 每页项目数量
     QString m_cachedQueryString;            ///< 缓存的查询字符串
+    RequestId m_currentRequest = 0;         ///< 正在进行的搜索请求ID
+    bool m_receivedPartial = false;         ///< 当前请求是否已发出过部分结果
+    QHash<int, RequestId> m_pageRequests;   ///< 正在加载的页面：偏移量 → 请求ID
 };
 
 #endif // SEARCHSERVICE_H
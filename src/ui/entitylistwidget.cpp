@@ -40,6 +40,8 @@ void EntityListWidget::setupUI()
     // 创建模型
     m_model = new ResultTableModel(this);
     ui->tableView->setModel(m_model);    // 配置表格视图
+    connect(m_model, &ResultTableModel::pageRequested,
+            this, &EntityListWidget::pageRequested);
     ui->tableView->horizontalHeader()->setStretchLastSection(true);
     ui->tableView->horizontalHeader()->setSectionsMovable(true);  // 允许拖动列
     ui->tableView->horizontalHeader()->setDragDropMode(QAbstractItemView::InternalMove);
@@ -125,6 +127,31 @@ void EntityListWidget::setItems(const QList<QSharedPointer<ResultItem>> &items)
                    << "items of type" << static_cast<int>(type);
 }
 
+void EntityListWidget::appendItems(const QList<QSharedPointer<ResultItem>> &items)
+{
+    m_model->appendItems(items);
+}
+
+void EntityListWidget::refreshEntity(const Mbid &mbid)
+{
+    m_model->refreshEntity(mbid);
+}
+
+void EntityListWidget::setPaging(int totalCount, int pageSize)
+{
+    m_model->setPaging(totalCount, pageSize);
+}
+
+void EntityListWidget::setPage(int offset, const QList<QSharedPointer<ResultItem>> &items)
+{
+    m_model->setPage(offset, items);
+}
+
+void EntityListWidget::setPageFailed(int offset)
+{
+    m_model->setPageFailed(offset);
+}
+
 
 
 QSharedPointer<ResultItem> EntityListWidget::getCurrentItem() const
@@ -5,6 +5,7 @@
 #include <QSharedPointer>
 #include <QMenu>
 #include "../core/types.h"
+#include "../core/mbid.h"
 
 QT_BEGIN_NAMESPACE
 class QTableView;
@@ -70,7 +71,44 @@ public:
      */
     void setItems(const QList<QSharedPointer<ResultItem>> &items);
     
+    /**
+     * @brief 在列表末尾追加实体
+     * @param items 新到达的实体项目
+     * 
+     * 只插入新行，已有行的选择和滚动位置保持不变。
+     */
+    void appendItems(const QList<QSharedPointer<ResultItem>> &items);
     
+    /**
+     * @brief 刷新被修改的实体（如详情加载完成后）
+     * @param mbid 实体MBID
+     * 
+     * 短时间内的多次刷新合并处理，只重绘值发生变化的单元格。
+     */
+    void refreshEntity(const Mbid &mbid);
+    
+    /**
+     * @brief 启用滚动加载
+     * @param totalCount 结果总数
+     * @param pageSize 每页条目数，为0时关闭
+     * 
+     * 当前显示的条目作为开头的页面；滚动到末尾时发出pageRequested请求下一页，
+     * 尚未到达的页面显示为占位行。离可见区域较远的页面会被释放，滚动回来时重新请求。
+     */
+    void setPaging(int totalCount, int pageSize);
+    
+    /**
+     * @brief 设置滚动加载的页面
+     * @param offset 页面偏移量
+     * @param items 该页的实体
+     */
+    void setPage(int offset, const QList<QSharedPointer<ResultItem>> &items);
+    
+    /**
+     * @brief 标记页面加载失败
+     * @param offset 页面偏移量
+     */
+    void setPageFailed(int offset);
     
     // =============================================================================
     // 选择管理方法
@@ -146,6 +184,7 @@ signals:
     void copyId(const QString &itemId);
     void prevPageRequested();
     void nextPageRequested();
+    void pageRequested(int offset);     ///< 滚动加载需要从offset开始的一页
 
 private slots:
     void onTableDoubleClicked(const QModelIndex &index);
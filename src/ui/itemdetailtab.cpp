@@ -65,6 +65,11 @@ QString ItemDetailTab::getItemId() const
     return m_item ? m_item->getId() : QString();
 }
 
+Mbid ItemDetailTab::getItemMbid() const
+{
+    return m_item ? m_item->getMbid() : Mbid();
+}
+
 QString ItemDetailTab::getItemName() const
 {
     return m_item ? m_item->getName() : QString();
@@ -4,6 +4,7 @@
 #include <QWidget>
 #include <QSharedPointer>
 #include "../core/types.h"
+#include "../core/mbid.h"
 
 QT_BEGIN_NAMESPACE
 class QTabWidget;
@@ -76,6 +77,12 @@ public:
      */
     QString getItemId() const;
     
+    /**
+     * @brief 获取实体MBID
+     * @return 实体ID的128位形式，ID不是UUID格式时为空值
+     */
+    Mbid getItemMbid() const;
+    
     /**
      * @brief 获取实体名称
      * @return 实体的显示名称
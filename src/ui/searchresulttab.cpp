@@ -76,21 +76,59 @@ void SearchResultTab::setupUI()
             this, &SearchResultTab::openInBrowser);
     connect(m_entityListWidget, &EntityListWidget::copyId,
             this, &SearchResultTab::copyId);
+    connect(m_entityListWidget, &EntityListWidget::pageRequested,
+            this, &SearchResultTab::resultsPageRequested);
 }
 
-void SearchResultTab::setResults(const QList<QSharedPointer<ResultItem>> &results, const SearchResults &stats)
+void SearchResultTab::setResults(const QList<QSharedPointer<ResultItem>> &results, const SearchResults &stats, int pageSize)
 {
     m_currentStats = stats;
     
     // 设置数据到EntityListWidget
     m_entityListWidget->setItems(results);
     
+    // 从第一页开始的结果改为滚动加载，其余页面在滚动时按需请求。
+    // 页面大小取请求的数量而不是返回的数量：解析器丢弃无效实体时返回的结果会少于请求的数量
+    if (stats.offset == 0 && stats.count > 0 && pageSize > 0 && stats.totalCount > pageSize) {
+        m_entityListWidget->setPaging(stats.totalCount, pageSize);
+        ui->prevPageButton->setVisible(false);
+        ui->nextPageButton->setVisible(false);
+        ui->pageInfoLabel->setText(tr("%1 results").arg(stats.totalCount));
+        return;
+    }
+    
     // 更新分页控件
+    ui->prevPageButton->setVisible(true);
+    ui->nextPageButton->setVisible(true);
     updatePaginationControls(stats);
     
     // 不再自动批量加载详细信息，只有在用户双击项目时才加载
 }
 
+void SearchResultTab::addPartialResults(const QList<QSharedPointer<ResultItem>> &results, bool replace)
+{
+    if (replace) {
+        m_entityListWidget->setItems(results);
+    } else {
+        m_entityListWidget->appendItems(results);
+    }
+}
+
+void SearchResultTab::refreshEntity(const Mbid &entityId)
+{
+    m_entityListWidget->refreshEntity(entityId);
+}
+
+void SearchResultTab::addResultsPage(int offset, const QList<QSharedPointer<ResultItem>> &results)
+{
+    m_entityListWidget->setPage(offset, results);
+}
+
+void SearchResultTab::setResultsPageFailed(int offset)
+{
+    m_entityListWidget->setPageFailed(offset);
+}
+
 
 
 
@@ -126,16 +164,17 @@ void SearchResultTab::updatePaginationControls(const SearchResults &stats)
  * 根据搜索结果统计信息更新分页按钮的启用状态和页面信息标签。
  * 计算当前页码、总页数，并显示结果范围信息。
  */
-void SearchResultTab::onEntityDetailsLoaded(const QString &entityId, const QVariantMap &details)
+void SearchResultTab::onEntityDetailsLoaded(const Mbid &entityId, const EntityPayload &details)
 {
-    Q_UNUSED(entityId)
     Q_UNUSED(details)
+    // 详情已写入列表中的条目，只刷新该实体所在的行
+    refreshEntity(entityId);
       // 通知详细信息已更新
     // 这个信号会被MainWindow接收，用于刷新相应的ItemDetailTab
     emit itemDetailsUpdated(nullptr); // 需要根据实际情况修改
 }
 
-void SearchResultTab::onDetailLoadingFailed(const QString &entityId, const ErrorInfo &error)
+void SearchResultTab::onDetailLoadingFailed(const Mbid &entityId, const ErrorInfo &error)
 {
     qDebug() << "SearchResultTab: Failed to load details for entity" << entityId 
                    << "Error:" << error.message;
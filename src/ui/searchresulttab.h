@@ -13,6 +13,8 @@
 #include <QSharedPointer>
 #include "../core/types.h"
 #include "../core/error_types.h"
+#include "../core/mbid.h"
+#include "../models/entitypayload.h"
 
 QT_BEGIN_NAMESPACE
 class Ui_SearchResultTab;
@@ -51,7 +53,7 @@ class EntityListWidget;
  *         this, &MainWindow::onItemDoubleClicked);
  * 
  * // 设置搜索结果
- * tab->setResults(results, stats);
+ * tab->setResults(results, stats, params.limit);
  * ```
  * 
  * **数据流程：**
@@ -94,11 +96,40 @@ public:
      * @brief 设置搜索结果数据
      * @param results 搜索结果项列表
      * @param stats 搜索统计信息
+     * @param pageSize 每页请求的结果数（SearchParameters::limit），滚动加载按此计算页面偏移量
      * 
      * 更新标签页显示的搜索结果，同时更新分页控件状态。
      * 此方法会触发详细信息的自动加载过程。
      */
-    void setResults(const QList<QSharedPointer<ResultItem>> &results, const SearchResults &stats);
+    void setResults(const QList<QSharedPointer<ResultItem>> &results, const SearchResults &stats, int pageSize);
+    
+    /**
+     * @brief 显示流式到达的部分结果
+     * @param results 新到达的结果
+     * @param replace 是否替换当前显示的结果（新请求的第一批结果）
+     * 
+     * 完整结果随后通过setResults()设置，已显示的行不会被重置。
+     */
+    void addPartialResults(const QList<QSharedPointer<ResultItem>> &results, bool replace);
+    
+    /**
+     * @brief 刷新结果列表中被修改的实体
+     * @param entityId 实体MBID
+     */
+    void refreshEntity(const Mbid &entityId);
+    
+    /**
+     * @brief 设置滚动加载到达的页面
+     * @param offset 页面偏移量
+     * @param results 该页的结果
+     */
+    void addResultsPage(int offset, const QList<QSharedPointer<ResultItem>> &results);
+    
+    /**
+     * @brief 标记滚动加载的页面失败
+     * @param offset 页面偏移量
+     */
+    void setResultsPageFailed(int offset);
     
     // =============================================================================
     // 状态查询接口
@@ -152,6 +183,15 @@ signals:
      */
     void nextPageRequested();
     
+    /**
+     * @brief 滚动加载页面请求信号
+     * @param offset 需要加载的页面偏移量
+     * 
+     * 结果从第一页开始时，列表滚动到末尾或滚动到已释放的页面时发出，
+     * 由父组件向SearchService请求该页并通过addResultsPage()送回。
+     */
+    void resultsPageRequested(int offset);
+    
     /**
      * @brief 项目详情更新信号
      * @param item 详情已更新的结果项
@@ -185,17 +225,17 @@ signals:
 private slots:
     /**
      * @brief 处理实体详情加载完成
-     * @param entityId 实体ID
+     * @param entityId 实体MBID
      * @param details 详细信息数据
      */
-    void onEntityDetailsLoaded(const QString &entityId, const QVariantMap &details);
+    void onEntityDetailsLoaded(const Mbid &entityId, const EntityPayload &details);
     
     /**
      * @brief 处理详情加载失败
-     * @param entityId 实体ID
+     * @param entityId 实体MBID
      * @param error 错误信息
      */
-    void onDetailLoadingFailed(const QString &entityId, const ErrorInfo &error);
+    void onDetailLoadingFailed(const Mbid &entityId, const ErrorInfo &error);
     
     /**
      * @brief 处理项目选择变化
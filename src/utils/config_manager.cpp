@@ -71,14 +71,26 @@ void ConfigManager::NetworkConfig::save(QSettings &settings) const {
     settings.setValue("timeoutMs", timeoutMs);
     settings.setValue("maxRetries", maxRetries);
     settings.setValue("retryDelayMs", retryDelayMs);
+    settings.setValue("requestDeadlineMs", requestDeadlineMs);
     settings.setValue("userAgent", userAgent);
+    settings.setValue("cacheEnabled", cacheEnabled);
+    settings.setValue("cacheSizeMb", cacheSizeMb);
+    settings.setValue("cacheTtlSeconds", cacheTtlSeconds);
+    settings.setValue("entityStoreEnabled", entityStoreEnabled);
+    settings.setValue("entityStoreMaxAgeSeconds", entityStoreMaxAgeSeconds);
 }
 
 void ConfigManager::NetworkConfig::load(const QSettings &settings) {
     timeoutMs = settings.value("timeoutMs", 60000).toInt();
     maxRetries = settings.value("maxRetries", 3).toInt();
     retryDelayMs = settings.value("retryDelayMs", 1000).toInt();
+    requestDeadlineMs = settings.value("requestDeadlineMs", 120000).toInt();
     userAgent = settings.value("userAgent", "MusicBrainzQt/1.0 ( https://github.com/MoeclubL/MusicBrainzQt )").toString();
+    cacheEnabled = settings.value("cacheEnabled", true).toBool();
+    cacheSizeMb = settings.value("cacheSizeMb", 100).toInt();
+    cacheTtlSeconds = settings.value("cacheTtlSeconds", 3600).toInt();
+    entityStoreEnabled = settings.value("entityStoreEnabled", true).toBool();
+    entityStoreMaxAgeSeconds = settings.value("entityStoreMaxAgeSeconds", 7 * 24 * 3600).toInt();
 }
 
 // ApiConfig 实现
@@ -86,12 +98,20 @@ void ConfigManager::ApiConfig::save(QSettings &settings) const {
     settings.setValue("baseUrl", baseUrl);
     settings.setValue("defaultLimit", defaultLimit);
     settings.setValue("rateLimit", rateLimit);
+    settings.setValue("rateBurst", rateBurst);
+    settings.setValue("strictPriority", strictPriority);
+    settings.setValue("parseThreads", parseThreads);
+    settings.setValue("parseQueueLimitMb", parseQueueLimitMb);
 }
 
 void ConfigManager::ApiConfig::load(const QSettings &settings) {
     baseUrl = settings.value("baseUrl", "https://musicbrainz.org/ws/2").toString();
     defaultLimit = settings.value("defaultLimit", 25).toInt();
     rateLimit = settings.value("rateLimit", 1000).toInt();
+    rateBurst = settings.value("rateBurst", 1).toInt();
+    strictPriority = settings.value("strictPriority", false).toBool();
+    parseThreads = settings.value("parseThreads", 0).toInt();
+    parseQueueLimitMb = settings.value("parseQueueLimitMb", 32).toInt();
 }
 
 // UiConfig 实现
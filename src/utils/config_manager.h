@@ -78,7 +78,13 @@ public:
         int timeoutMs = 60000;          ///< 请求超时时间（毫秒）
         int maxRetries = 3;             ///< 最大重试次数
         int retryDelayMs = 1000;        ///< 重试延迟时间（毫秒）
+        int requestDeadlineMs = 120000; ///< 单个请求（含重试）的总时限（毫秒）
         QString userAgent = "MusicBrainzQt/1.0 ( https://github.com/MoeclubL/MusicBrainzQt )";  ///< HTTP用户代理字符串
+        bool cacheEnabled = true;       ///< 是否启用磁盘响应缓存
+        int cacheSizeMb = 100;          ///< 磁盘响应缓存容量（MB）
+        int cacheTtlSeconds = 3600;     ///< 浏览等非实体查询请求的缓存新鲜期（秒）
+        bool entityStoreEnabled = true; ///< 是否启用本地实体存储（已加载的详情跨会话复用）
+        int entityStoreMaxAgeSeconds = 7 * 24 * 3600;   ///< 本地实体存储的新鲜期（秒），负数表示不过期
         
         /**
          * @brief 保存网络配置到QSettings
@@ -103,6 +109,10 @@ public:
         QString baseUrl = "https://musicbrainz.org/ws/2";   ///< API基础URL
         int defaultLimit = 25;                              ///< 默认查询结果数量限制
         int rateLimit = 1000;                               ///< 请求速率限制（毫秒间隔）
+        int rateBurst = 1;                                  ///< 令牌桶容量（允许的最大突发请求数）
+        bool strictPriority = false;                        ///< 严格优先级调度（否则按权重轮转）
+        int parseThreads = 0;                               ///< 响应解析线程数，0表示自动
+        int parseQueueLimitMb = 32;                         ///< 等待解析的响应体总量上限（MB）
         
         /**
          * @brief 保存API配置到QSettings
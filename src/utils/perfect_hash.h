@@ -0,0 +1,138 @@
+#ifndef PERFECT_HASH_H
+#define PERFECT_HASH_H
+
+#include <QLatin1String>
+#include <QStringView>
+#include <array>
+#include <cstddef>
+#include <string_view>
+
+/**
+ * @class PerfectHashTable
+ * @brief 编译时构造的固定名称集合完美哈希表
+ *
+ * 在编译期为一组ASCII名称（实体名、JSON键名等）搜索一个使所有名称落在不同槽位的
+ * 哈希种子，运行时查找只需计算一次哈希并比较一次字符串，不分配内存、不依赖名称顺序。
+ *
+ * 表必须以constexpr方式构造，并用static_assert检查isValid()，
+ * 找不到无冲突种子时（名称重复或槽位过少）在编译期报错。
+ *
+ * **使用示例：**
+ * ```cpp
+ * constexpr std::array<std::string_view, 3> NAMES = {{"artist", "release", "work"}};
+ * constexpr PerfectHashTable<3> TABLE(NAMES);
+ * static_assert(TABLE.isValid(), "entity names must hash without collisions");
+ * const int index = TABLE.indexOf(QStringView(key));   // -1表示不在集合中
+ * ```
+ *
+ * @tparam N 名称数量
+ * @tparam Slots 槽位数量（2的幂，至少为N）
+ */
+template <std::size_t N, std::size_t Slots = 64>
+class PerfectHashTable
+{
+    static_assert(Slots >= N && (Slots & (Slots - 1)) == 0, "Slots must be a power of two not smaller than N");
+    static_assert(N < 128, "Indices are stored as signed bytes");
+
+public:
+    constexpr explicit PerfectHashTable(const std::array<std::string_view, N> &names)
+        : m_names(names)
+    {
+        for (quint32 seed = 1; seed < MAX_SEED; ++seed) {
+            if (tryBuild(seed)) {
+                m_seed = seed;
+                return;
+            }
+        }
+    }
+
+    /**
+     * @brief 是否找到了无冲突的种子
+     */
+    constexpr bool isValid() const noexcept { return m_seed != 0; }
+
+    /**
+     * @brief 查找名称（编译期可用）
+     * @return 名称在构造数组中的序号，不存在时返回-1
+     */
+    constexpr int indexOf(std::string_view name) const noexcept
+    {
+        quint32 hash = m_seed;
+        for (char c : name) {
+            hash = mix(hash, quint32(static_cast<unsigned char>(c)));
+        }
+        const int index = m_slots[slotOf(hash)];
+        return index >= 0 && m_names[std::size_t(index)] == name ? index : -1;
+    }
+
+    /**
+     * @brief 查找名称
+     * @return 名称在构造数组中的序号，不存在时返回-1
+     */
+    int indexOf(QStringView name) const noexcept
+    {
+        quint32 hash = m_seed;
+        for (QChar c : name) {
+            // 集合中只有ASCII名称，非ASCII字符一定不匹配
+            if (c.unicode() > 0x7f) {
+                return -1;
+            }
+            hash = mix(hash, c.unicode());
+        }
+        const int index = m_slots[slotOf(hash)];
+        if (index < 0) {
+            return -1;
+        }
+        const std::string_view candidate = m_names[std::size_t(index)];
+        return name.compare(QLatin1String(candidate.data(), qsizetype(candidate.size()))) == 0 ? index : -1;
+    }
+
+    /**
+     * @brief 按序号获取名称
+     */
+    constexpr std::string_view nameAt(std::size_t index) const noexcept { return m_names[index]; }
+
+private:
+    static constexpr quint32 MAX_SEED = 4096;   ///< 种子搜索上限
+
+    /**
+     * @brief FNV-1a的一步
+     */
+    static constexpr quint32 mix(quint32 hash, quint32 c) noexcept
+    {
+        return (hash ^ c) * 16777619u;
+    }
+
+    /**
+     * @brief 哈希值 → 槽位（乘法只向高位扩散，先把高位折叠下来）
+     */
+    static constexpr std::size_t slotOf(quint32 hash) noexcept
+    {
+        return (hash ^ (hash >> 16)) & (Slots - 1);
+    }
+
+    constexpr bool tryBuild(quint32 seed)
+    {
+        for (auto &slot : m_slots) {
+            slot = -1;
+        }
+        for (std::size_t i = 0; i < N; ++i) {
+            quint32 hash = seed;
+            for (char c : m_names[i]) {
+                hash = mix(hash, quint32(static_cast<unsigned char>(c)));
+            }
+            auto &slot = m_slots[slotOf(hash)];
+            if (slot >= 0) {
+                return false;
+            }
+            slot = static_cast<qint8>(i);
+        }
+        return true;
+    }
+
+    std::array<std::string_view, N> m_names;    ///< 名称集合
+    std::array<qint8, Slots> m_slots = {};      ///< 槽位 → 名称序号（-1表示空）
+    quint32 m_seed = 0;                         ///< 无冲突的哈希种子（0表示未找到）
+};
+
+#endif // PERFECT_HASH_H
@@ -0,0 +1,89 @@
+#include "string_pool.h"
+#include <QMutexLocker>
+#include <QDebug>
+
+StringPool& StringPool::instance()
+{
+    static StringPool instance;
+    return instance;
+}
+
+QString StringPool::intern(const QString &str)
+{
+    if (str.isEmpty() || str.size() > MAX_INTERN_LENGTH) {
+        return str;
+    }
+
+    QMutexLocker locker(&m_mutex);
+    if (!m_enabled) {
+        return str;
+    }
+
+    m_stats.lookups++;
+    const auto it = m_strings.constFind(str);
+    if (it != m_strings.constEnd()) {
+        m_stats.hits++;
+        m_stats.sharedBytes += str.size() * qint64(sizeof(QChar));
+        return *it;
+    }
+
+    // 池增长到阈值时先回收不再使用的字符串，阈值随存活数量翻倍
+    if (m_strings.size() >= m_squeezeThreshold) {
+        squeezeLocked();
+    }
+
+    m_strings.insert(str);
+    return str;
+}
+
+void StringPool::squeeze()
+{
+    QMutexLocker locker(&m_mutex);
+    squeezeLocked();
+}
+
+void StringPool::squeezeLocked()
+{
+    const int before = m_strings.size();
+
+    // isDetached()表示引用计数为1，即只有池自己持有
+    for (auto it = m_strings.begin(); it != m_strings.end();) {
+        if (it->isDetached()) {
+            it = m_strings.erase(it);
+        } else {
+            ++it;
+        }
+    }
+
+    m_squeezeThreshold = qMax(MIN_SQUEEZE_ENTRIES, int(m_strings.size()) * 2);
+    qDebug() << "StringPool::squeeze - Released" << before - m_strings.size()
+             << "strings," << m_strings.size() << "in use";
+}
+
+void StringPool::clear()
+{
+    QMutexLocker locker(&m_mutex);
+    m_strings.clear();
+    m_squeezeThreshold = MIN_SQUEEZE_ENTRIES;
+    m_stats = Stats();
+}
+
+StringPool::Stats StringPool::stats() const
+{
+    QMutexLocker locker(&m_mutex);
+    Stats result = m_stats;
+    result.entries = int(m_strings.size());
+    return result;
+}
+
+void StringPool::setEnabled(bool enabled)
+{
+    QMutexLocker locker(&m_mutex);
+    m_enabled = enabled;
+}
+
+bool StringPool::isEnabled() const
+{
+    QMutexLocker locker(&m_mutex);
+    return m_enabled;
+}
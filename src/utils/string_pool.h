@@ -0,0 +1,108 @@
+#ifndef STRING_POOL_H
+#define STRING_POOL_H
+
+#include <QString>
+#include <QSet>
+#include <QMutex>
+
+/**
+ * @class StringPool
+ * @brief 字符串驻留池
+ *
+ * 解析出的实体中有大量重复的字符串：每个实体都有相同的键名（"sort-name"、
+ * "life-span"、"type"……），值也高度重复（国家代码、标签名、关系类型、
+ * 署名中的艺术家名）。驻留池为相同内容只保留一份字符串，其他副本通过
+ * QString的隐式共享引用同一块缓冲区，新解析的字符串在驻留后立即释放。
+ *
+ * **使用范围：**
+ * - MusicBrainzParser：JSON键名和取值范围很小的字段值（类型、状态、国家、语言、标签名等）；
+ *   ID、名称、标题不驻留
+ * - ResultItem：详细数据的键名
+ *
+ * 驻留池是线程安全的，可以在解析线程池中直接使用。
+ * 只被驻留池自己引用的字符串会在池增长时自动回收，因此池的大小
+ * 与仍在使用的不同字符串数量成正比，不会随会话时长无限增长。
+ *
+ * **使用示例：**
+ * ```cpp
+ * QString key = StringPool::instance().intern(it.key());
+ * ```
+ */
+class StringPool
+{
+public:
+    /**
+     * @struct Stats
+     * @brief 驻留统计
+     */
+    struct Stats {
+        int entries = 0;            ///< 当前池中的字符串数量
+        qint64 lookups = 0;         ///< 驻留请求次数
+        qint64 hits = 0;            ///< 命中已有字符串的次数
+        qint64 sharedBytes = 0;     ///< 命中时省下的字符串缓冲区字节数（累计）
+    };
+
+    /**
+     * @brief 获取驻留池的单例实例
+     */
+    static StringPool& instance();
+
+    /**
+     * @brief 驻留字符串
+     * @param str 任意字符串
+     * @return 与str内容相同、与池中已有副本共享缓冲区的字符串；
+     *         驻留被禁用或字符串过长时原样返回
+     */
+    QString intern(const QString &str);
+
+    /**
+     * @brief 回收只被驻留池引用的字符串
+     */
+    void squeeze();
+
+    /**
+     * @brief 清空驻留池和统计
+     */
+    void clear();
+
+    /**
+     * @brief 获取驻留统计
+     */
+    Stats stats() const;
+
+    /**
+     * @brief 启用或禁用驻留（用于对比内存占用）
+     */
+    void setEnabled(bool enabled);
+    bool isEnabled() const;
+
+    /**
+     * @brief 参与驻留的最大字符数
+     *
+     * 更长的文本（注释、简介等）几乎不会重复，驻留只会增加查找开销。
+     */
+    static constexpr int MAX_INTERN_LENGTH = 64;
+
+private:
+    StringPool() = default;
+    ~StringPool() = default;
+
+    // 禁用拷贝和赋值操作符
+    StringPool(const StringPool&) = delete;
+    StringPool& operator=(const StringPool&) = delete;
+
+    /**
+     * @brief 回收不再使用的字符串（调用方已持有锁）
+     */
+    void squeezeLocked();
+
+    static constexpr int MIN_SQUEEZE_ENTRIES = 4096;    ///< 池小于该大小时不回收
+
+    mutable QMutex m_mutex;         ///< 保护以下所有成员
+    QSet<QString> m_strings;        ///< 已驻留的字符串
+    int m_squeezeThreshold = MIN_SQUEEZE_ENTRIES;   ///< 下次回收的池大小
+    Stats m_stats;                  ///< 统计数据
+    bool m_enabled = true;          ///< 是否启用驻留
+};
+
+#endif // STRING_POOL_H
@@ -0,0 +1,61 @@
+#ifndef TEST_PAGES_H
+#define TEST_PAGES_H
+
+#include <QByteArray>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QString>
+
+/**
+ * @brief 各测试目标共用的响应数据
+ */
+namespace TestPages {
+
+inline QByteArray makeArtistPage(int count)
+{
+    // 构造与MusicBrainz搜索接口结构相同的一页艺术家结果
+    QJsonArray artists;
+    for (int i = 0; i < count; ++i) {
+        QJsonObject area;
+        area["id"] = QString("489ce91b-6658-3307-9877-%1").arg(i, 12, 10, QChar('0'));
+        area["type"] = "Country";
+        area["name"] = "United Kingdom";
+
+        QJsonObject lifeSpan;
+        lifeSpan["begin"] = "1960";
+        lifeSpan["ended"] = false;
+
+        QJsonArray tags;
+        for (int t = 0; t < 5; ++t) {
+            QJsonObject tag;
+            tag["count"] = t + 1;
+            tag["name"] = QString("tag %1").arg(t);
+            tags.append(tag);
+        }
+
+        QJsonObject artist;
+        artist["id"] = QString("b10bbbfc-cf9e-42e0-be17-%1").arg(i, 12, 10, QChar('0'));
+        artist["type"] = "Group";
+        artist["score"] = 100 - i % 100;
+        artist["name"] = QString("Artist %1").arg(i);
+        artist["sort-name"] = QString("Artist %1").arg(i);
+        artist["country"] = "GB";
+        artist["disambiguation"] = "test fixture";
+        artist["area"] = area;
+        artist["life-span"] = lifeSpan;
+        artist["tags"] = tags;
+        artists.append(artist);
+    }
+
+    QJsonObject root;
+    root["created"] = "2024-01-01T00:00:00.000Z";
+    root["count"] = 2500;
+    root["offset"] = 100;
+    root["artists"] = artists;
+    return QJsonDocument(root).toJson(QJsonDocument::Compact);
+}
+
+} // namespace TestPages
+
+#endif // TEST_PAGES_H
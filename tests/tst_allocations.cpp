@@ -0,0 +1,99 @@
+#include <QtTest>
+#include "../src/api/musicbrainzparser.h"
+#include "../src/api/musicbrainz_response_handler.h"
+#include "../src/models/resultitem.h"
+#include "../src/core/types.h"
+#include "test_pages.h"
+#include <atomic>
+
+// 该目标只在glibc上构建（见tests/CMakeLists.txt）：替换malloc只影响这个可执行文件，
+// 其他测试照常使用系统分配器
+#if defined(__SANITIZE_ADDRESS__)
+#define TST_ALLOCATIONS_DISABLED
+#endif
+
+#ifndef TST_ALLOCATIONS_DISABLED
+namespace {
+std::atomic<bool> s_countAllocations{false};
+std::atomic<qint64> s_allocationCount{0};
+
+inline void countAllocation()
+{
+    if (s_countAllocations.load(std::memory_order_relaxed)) {
+        s_allocationCount.fetch_add(1, std::memory_order_relaxed);
+    }
+}
+} // namespace
+
+// glibc允许可执行文件替换malloc；这里只计数，实际分配仍交给glibc
+extern "C" {
+void *__libc_malloc(size_t size);
+void *__libc_calloc(size_t count, size_t size);
+void *__libc_realloc(void *ptr, size_t size);
+
+void *malloc(size_t size) __THROW
+{
+    countAllocation();
+    return __libc_malloc(size);
+}
+
+void *calloc(size_t count, size_t size) __THROW
+{
+    countAllocation();
+    return __libc_calloc(count, size);
+}
+
+void *realloc(void *ptr, size_t size) __THROW
+{
+    countAllocation();
+    return __libc_realloc(ptr, size);
+}
+}
+#endif
+
+class TestAllocations : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void initTestCase();
+    void benchmarkSearchPageAllocations();
+
+private:
+    MusicBrainzParser *m_parser = nullptr;
+    MusicBrainzResponseHandler *m_handler = nullptr;
+    QByteArray m_page;
+    QVariantMap m_context;
+};
+
+void TestAllocations::initTestCase()
+{
+    m_parser = new MusicBrainzParser(this);
+    m_handler = new MusicBrainzResponseHandler(m_parser, this);
+    m_page = TestPages::makeArtistPage(100);
+    m_context["entityType"] = static_cast<int>(EntityType::Artist);
+}
+
+void TestAllocations::benchmarkSearchPageAllocations()
+{
+#ifndef TST_ALLOCATIONS_DISABLED
+    // 先解析一次，让驻留池和各处的静态数据就绪
+    m_handler->handleResponse(RequestType::Search, m_page, m_context);
+
+    s_allocationCount = 0;
+    s_countAllocations = true;
+    const ParsedResponse response = m_handler->handleResponse(RequestType::Search, m_page, m_context);
+    s_countAllocations = false;
+
+    QCOMPARE(response.items.size(), 100);
+    qInfo().noquote() << QString("Search page: %1 heap allocations for %2 entities (%3 per entity)")
+                         .arg(s_allocationCount.load()).arg(response.items.size())
+                         .arg(double(s_allocationCount.load()) / response.items.size(), 0, 'f', 1);
+    QTest::setBenchmarkResult(qreal(s_allocationCount.load()), QTest::Events);
+#else
+    QSKIP("Allocation counting does not work under AddressSanitizer");
+#endif
+}
+
+QTEST_GUILESS_MAIN(TestAllocations)
+#include "tst_allocations.moc"
@@ -1,9 +1,36 @@
 #include <QtTest>
 #include <QSignalSpy>
 #include <QEventLoop>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QScopeGuard>
+#include <QSet>
+#include <QTemporaryDir>
+#include <QThread>
+#include <QThreadPool>
 #include "../src/api/musicbrainzapi.h"
+#include "../src/api/musicbrainz_api_hub.h"
+#include "../src/api/musicbrainz_response_handler.h"
+#include "../src/api/musicbrainzparser.h"
+#include "../src/api/network_manager.h"
+#include "../src/api/response_cache.h"
+#include "../src/api/entity_store.h"
+#include "../src/models/resultitem.h"
 #include "../src/core/types.h"
 
+namespace {
+// 调度测试只关心请求何时离开队列，发出的请求连到本机的丢弃端口
+const QString LOCAL_URL = QStringLiteral("http://127.0.0.1:9/ws/2/artist");
+const QString TEST_USER_AGENT = QStringLiteral("MusicBrainzQt-Test/1.0");
+
+// 推进假时钟后立即调度，不等待内部定时器
+void dispatchNow(NetworkManager &manager)
+{
+    QVERIFY(QMetaObject::invokeMethod(&manager, "dispatchPending", Qt::DirectConnection));
+}
+} // namespace
+
 class TestMusicBrainzApi : public QObject
 {
     Q_OBJECT
@@ -14,6 +41,17 @@ private slots:
     void testSearchAlbum();
     void testSearchArtist();
     void testGetReleaseDetails();
+    void testTokenBucket();
+    void testPriorityScheduling();
+    void testRequestCoalescing();
+    void testResultItemClone();
+    void testSharedHub();
+    void testResponseCache();
+    void testRequestIds();
+    void testStoredDetails();
+    void testRetryPolicy();
+    void testCancellation();
+    void testParsePool();
 
 private:
     MusicBrainzApi *api;
@@ -47,5 +85,444 @@ void TestMusicBrainzApi::testGetReleaseDetails()
     api->getDetails("1e0eee38-a9f6-49bf-84d0-45d0647799af", EntityType::Release);
 }
 
+void TestMusicBrainzApi::testTokenBucket()
+{
+    NetworkManager manager;
+    qint64 now = 0;
+    manager.setClock([&now]() { return now; });
+
+    const int interval = manager.rateLimitInterval();
+    const int burst = manager.rateLimitBurst();
+    if (interval <= 0) {
+        QSKIP("Rate limiting is disabled in the configuration");
+    }
+
+    // 令牌桶初始是满的：前burst个请求立即发出，其余排队
+    for (int i = 0; i <= burst; ++i) {
+        manager.sendRequest(LOCAL_URL, TEST_USER_AGENT, RequestPriority::Bulk);
+    }
+    QCOMPARE(manager.schedulerMetrics().dispatchedCount, qint64(burst));
+    QCOMPARE(manager.schedulerMetrics().queueDepth, 1);
+
+    // 不足一个间隔时没有新令牌
+    now += interval / 2;
+    dispatchNow(manager);
+    QCOMPARE(manager.schedulerMetrics().dispatchedCount, qint64(burst));
+
+    // 满一个间隔补充一个令牌，等待时间按时钟计算
+    now += interval - interval / 2;
+    dispatchNow(manager);
+    NetworkManager::SchedulerMetrics metrics = manager.schedulerMetrics();
+    QCOMPARE(metrics.dispatchedCount, qint64(burst + 1));
+    QCOMPARE(metrics.queueDepth, 0);
+    QCOMPARE(metrics.lastWaitMs, qint64(interval));
+
+    // 重新配置不会补满令牌桶
+    manager.setRateLimit(100, 3);
+    manager.sendRequest(LOCAL_URL, TEST_USER_AGENT, RequestPriority::Bulk);
+    QCOMPARE(manager.schedulerMetrics().dispatchedCount, qint64(burst + 1));
+
+    // 空闲再久，积累的令牌也不超过容量
+    now += 10000;
+    dispatchNow(manager);
+    for (int i = 0; i < 4; ++i) {
+        manager.sendRequest(LOCAL_URL, TEST_USER_AGENT, RequestPriority::Bulk);
+    }
+    metrics = manager.schedulerMetrics();
+    QCOMPARE(metrics.dispatchedCount, qint64(burst + 4));
+    QCOMPARE(metrics.queueDepth, 2);
+
+    now += 100;
+    dispatchNow(manager);
+    QCOMPARE(manager.schedulerMetrics().dispatchedCount, qint64(burst + 5));
+    QCOMPARE(manager.schedulerMetrics().queueDepth, 1);
+}
+
+void TestMusicBrainzApi::testPriorityScheduling()
+{
+    const auto queueAndGrant = [](NetworkManager::SchedulingPolicy policy, const std::array<int, REQUEST_PRIORITY_COUNT> &counts) {
+        NetworkManager manager;
+        qint64 now = 0;
+        manager.setClock([&now]() { return now; });
+        manager.setSchedulingPolicy(policy);
+
+        // 暂停期间全部入队，然后一次给出10个令牌
+        manager.setDispatchPaused(true);
+        manager.setRateLimit(1000, 10);
+        for (int priority = 0; priority < REQUEST_PRIORITY_COUNT; ++priority) {
+            for (int i = 0; i < counts[priority]; ++i) {
+                manager.sendRequest(LOCAL_URL, TEST_USER_AGENT, static_cast<RequestPriority>(priority));
+            }
+        }
+        now += 10000;
+        manager.setDispatchPaused(false);
+
+        const NetworkManager::SchedulerMetrics metrics = manager.schedulerMetrics();
+        QVector<int> remaining;
+        for (int depth : metrics.queueDepthByPriority) {
+            remaining.append(depth);
+        }
+        return qMakePair(metrics.dispatchedCount, remaining);
+    };
+
+    // 加权轮转按6:3:1分配令牌，批量请求不会被饿死
+    auto weighted = queueAndGrant(NetworkManager::SchedulingPolicy::Weighted, {10, 10, 10});
+    QCOMPARE(weighted.first, qint64(10));
+    QCOMPARE(weighted.second, QVector<int>({4, 7, 9}));
+
+    // 严格优先级先发完交互请求，再发预加载请求
+    auto strict = queueAndGrant(NetworkManager::SchedulingPolicy::Strict, {4, 10, 10});
+    QCOMPARE(strict.first, qint64(10));
+    QCOMPARE(strict.second, QVector<int>({0, 4, 10}));
+}
+
+void TestMusicBrainzApi::testRequestCoalescing()
+{
+    MusicBrainzApiHub *hub = MusicBrainzApiHub::instance();
+    NetworkManager *network = hub->networkManager();
+
+    // 暂停发送，请求留在队列里，测试结束时恢复
+    network->setDispatchPaused(true);
+    auto resume = qScopeGuard([network]() { network->setDispatchPaused(false); });
+    const MusicBrainzApiHub::Metrics before = hub->metrics();
+
+    // 不同调用方的相同请求只发送一次
+    MusicBrainzApi first;
+    MusicBrainzApi second;
+    QVERIFY(first.search("coalescing test", EntityType::Artist) != 0);
+    QVERIFY(second.search("coalescing test", EntityType::Artist) != 0);
+
+    MusicBrainzApiHub::Metrics after = hub->metrics();
+    QCOMPARE(after.submittedCount - before.submittedCount, qint64(2));
+    QCOMPARE(after.coalescedCount - before.coalescedCount, qint64(1));
+    QCOMPARE(after.networkRequestCount - before.networkRequestCount, qint64(1));
+    QCOMPARE(after.scheduler.queueDepth - before.scheduler.queueDepth, 1);
+
+    // 参数不同的请求不合并
+    QVERIFY(second.search("coalescing test", EntityType::Artist, 25, 25) != 0);
+    after = hub->metrics();
+    QCOMPARE(after.coalescedCount - before.coalescedCount, qint64(1));
+    QCOMPARE(after.networkRequestCount - before.networkRequestCount, qint64(2));
+
+    first.cancelAllRequests();
+    second.cancelAllRequests();
+    QCOMPARE(hub->metrics().scheduler.queueDepth, before.scheduler.queueDepth);
+}
+
+void TestMusicBrainzApi::testResultItemClone()
+{
+    // 合并请求的其他调用方收到的是深拷贝，修改互不影响
+    auto original = QSharedPointer<ResultItem>::create("b10bbbfc-cf9e-42e0-be17-000000000000", "Artist", EntityType::Artist);
+    original->setDisambiguation("original");
+    original->setDetailProperty("country", "GB");
+
+    const QSharedPointer<ResultItem> copy = original->clone();
+    QVERIFY(copy != original);
+    QCOMPARE(copy->getId(), original->getId());
+    QCOMPARE(copy->getDisambiguation(), QString("original"));
+    QCOMPARE(copy->getDetailProperty("country").toString(), QString("GB"));
+
+    copy->setDisambiguation("copy");
+    copy->setDetailProperty("country", "DE");
+    QCOMPARE(original->getDisambiguation(), QString("original"));
+    QCOMPARE(original->getDetailProperty("country").toString(), QString("GB"));
+}
+
+void TestMusicBrainzApi::testSharedHub()
+{
+    MusicBrainzApiHub *hub = MusicBrainzApiHub::instance();
+    QCOMPARE(MusicBrainzApiHub::instance(), hub);
+    QCOMPARE(hub->thread(), QCoreApplication::instance()->thread());
+
+    // 工作线程上的外观对象使用同一个中心，请求转到中心线程执行
+    const qint64 submitted = hub->metrics().submittedCount;
+    MusicBrainzApiHub *workerHub = nullptr;
+    RequestId ticket = 0;
+    QThread *worker = QThread::create([&workerHub, &ticket]() {
+        workerHub = MusicBrainzApiHub::instance();
+        MusicBrainzApi api;
+        ticket = api.search("shared hub test", EntityType::Artist);
+    });
+    worker->start();
+    QVERIFY(worker->wait(5000));
+    delete worker;
+
+    QCOMPARE(workerHub, hub);
+    QVERIFY(ticket != 0);
+    QTRY_COMPARE(hub->metrics().submittedCount, submitted + 1);
+}
+
+void TestMusicBrainzApi::testResponseCache()
+{
+    QTemporaryDir dir;
+    QVERIFY(dir.isValid());
+
+    ResponseCache cache;
+    cache.setCacheDirectory(dir.path());
+    cache.setDefaultTtl(60);
+    cache.setEntityTtl(EntityType::Artist, 3600);
+
+    // 实体查询按类型取新鲜期，浏览和未配置的类型使用默认值
+    const QUrl lookup("https://musicbrainz.org/ws/2/artist/b10bbbfc-cf9e-42e0-be17-000000000000?inc=aliases");
+    QCOMPARE(cache.ttlForUrl(lookup), 3600);
+    QCOMPARE(cache.ttlForUrl(QUrl("https://musicbrainz.org/ws/2/release?artist=b10bbbfc-cf9e-42e0-be17-000000000000")), 60);
+    QCOMPARE(cache.ttlForUrl(QUrl("https://musicbrainz.org/ws/2/release/b10bbbfc-cf9e-42e0-be17-000000000000")), 60);
+    QVERIFY(!cache.isFresh(lookup));
+
+    const auto header = [](const QNetworkCacheMetaData &meta, const QByteArray &name) {
+        for (const auto &entry : meta.rawHeaders()) {
+            if (entry.first.compare(name, Qt::CaseInsensitive) == 0) {
+                return entry.second;
+            }
+        }
+        return QByteArray();
+    };
+
+    // 写入时服务器的Cache-Control被客户端的新鲜期替换，ETag保留用于重新验证
+    QNetworkCacheMetaData response;
+    response.setUrl(lookup);
+    response.setSaveToDisk(true);
+    response.setRawHeaders({{"ETag", "\"v1\""}, {"Cache-Control", "no-cache"}});
+    QIODevice *device = cache.prepare(response);
+    QVERIFY(device);
+    device->write("{}");
+    cache.insert(device);
+
+    const QDateTime now = QDateTime::currentDateTimeUtc();
+    QNetworkCacheMetaData stored = cache.metaData(lookup);
+    QVERIFY(cache.isFresh(lookup));
+    QVERIFY(stored.expirationDate() > now.addSecs(3500));
+    QCOMPARE(header(stored, "Cache-Control"), QByteArray("max-age=3600"));
+    QCOMPARE(header(stored, "ETag"), QByteArray("\"v1\""));
+
+    // 过期条目不算新鲜；304响应刷新元数据后重新开始新鲜期
+    stored.setExpirationDate(now.addSecs(-10));
+    cache.QNetworkDiskCache::updateMetaData(stored);
+    QVERIFY(!cache.isFresh(lookup));
+
+    cache.updateMetaData(stored);
+    QVERIFY(cache.isFresh(lookup));
+    QVERIFY(cache.metaData(lookup).expirationDate() > now.addSecs(3500));
+}
+
+void TestMusicBrainzApi::testRequestIds()
+{
+    MusicBrainzApiHub *hub = MusicBrainzApiHub::instance();
+    NetworkManager *network = hub->networkManager();
+    network->setDispatchPaused(true);
+    auto resume = qScopeGuard([network]() { network->setDispatchPaused(false); });
+
+    const QString artistId = "00000000-0000-4000-8000-000000000001";
+    const QString releaseId = "00000000-0000-4000-8000-000000000002";
+    MusicBrainzApi api;
+    QVERIFY(!api.hasStoredDetails(artistId, EntityType::Artist));
+    QVERIFY(!api.hasStoredDetails(releaseId, EntityType::Release));
+    const MusicBrainzApiHub::Metrics before = hub->metrics();
+
+    // 每个请求都有自己的非0请求ID，与直接分配的请求ID也不重复
+    const RequestId artist = api.getDetails(artistId, EntityType::Artist, RequestPriority::Prefetch);
+    const RequestId release = api.getDetails(releaseId, EntityType::Release, RequestPriority::Prefetch);
+    const RequestId reserved = hub->reserveTicket();
+    QVERIFY(artist != 0);
+    QVERIFY(release != 0);
+    QCOMPARE(QSet<RequestId>({artist, release, reserved}).size(), 3);
+    QCOMPARE(hub->metrics().inFlightCount - before.inFlightCount, 2);
+
+    // 按请求ID取消只影响对应的请求
+    api.cancelRequest(artist);
+    const MusicBrainzApiHub::Metrics after = hub->metrics();
+    QCOMPARE(after.abortedCount - before.abortedCount, qint64(1));
+    QCOMPARE(after.inFlightCount - before.inFlightCount, 1);
+
+    // 参数无效时同步报错，请求ID为0
+    QSignalSpy errors(&api, &MusicBrainzApi::errorOccurred);
+    QCOMPARE(api.search(QString(), EntityType::Artist), RequestId(0));
+    QCOMPARE(errors.count(), 1);
+    QCOMPARE(errors.first().at(1).value<RequestId>(), RequestId(0));
+}
+
+void TestMusicBrainzApi::testStoredDetails()
+{
+    MusicBrainzApiHub *hub = MusicBrainzApiHub::instance();
+    NetworkManager *network = hub->networkManager();
+    network->setDispatchPaused(true);
+    auto resume = qScopeGuard([network]() { network->setDispatchPaused(false); });
+
+    QTemporaryDir dir;
+    QVERIFY(dir.isValid());
+    EntityStore *store = hub->entityStore();
+    QVERIFY(store->open(dir.path()));
+    auto closeStore = qScopeGuard([store]() { store->close(); });
+
+    const QString artistId = "b10bbbfc-cf9e-42e0-be17-e2c3e1d2600d";
+    QJsonObject artist;
+    artist["id"] = artistId;
+    artist["name"] = "The Beatles";
+    artist["type"] = "Group";
+    QVariantMap context;
+    context["entityType"] = static_cast<int>(EntityType::Artist);
+    MusicBrainzParser parser;
+    MusicBrainzResponseHandler handler(&parser);
+    const EntityPayload payload = handler.handleResponse(RequestType::Details,
+                                                         QJsonDocument(artist).toJson(), context).entity;
+    QVERIFY(store->insert(payload, EntityUtils::getDefaultIncludes(EntityType::Artist)));
+
+    MusicBrainzApi api;
+    QVERIFY(api.hasStoredDetails(artistId, EntityType::Artist));
+    QSignalSpy details(&api, &MusicBrainzApi::detailsReady);
+    const MusicBrainzApiHub::Metrics before = hub->metrics();
+
+    // 存储命中不发送网络请求；读取在解析线程上进行，结果在返回之后才发出
+    const RequestId ticket = api.getDetails(artistId, EntityType::Artist);
+    QVERIFY(ticket != 0);
+    QCOMPARE(details.count(), 0);
+    QVERIFY(details.wait());
+    QCOMPARE(details.count(), 1);
+    QCOMPARE(details.first().at(0).value<EntityPayload>().id(), artistId);
+    QCOMPARE(details.first().at(2).value<RequestId>(), ticket);
+    QCOMPARE(hub->metrics().inFlightCount, before.inFlightCount);
+
+    // 读取完成前取消的请求不再发出结果
+    const RequestId cancelled = api.getDetails(artistId, EntityType::Artist);
+    api.cancelRequest(cancelled);
+    QVERIFY(!details.wait(200));
+    QCOMPARE(details.count(), 1);
+}
+
+void TestMusicBrainzApi::testRetryPolicy()
+{
+    using Kind = NetworkManager::FailureKind;
+
+    // 限流、服务器临时故障和连接问题可以重试，其他4xx不重试
+    QCOMPARE(NetworkManager::classifyFailure(QNetworkReply::UnknownContentError, 429), Kind::Throttled);
+    QCOMPARE(NetworkManager::classifyFailure(QNetworkReply::ServiceUnavailableError, 503), Kind::Throttled);
+    QCOMPARE(NetworkManager::classifyFailure(QNetworkReply::UnknownServerError, 502), Kind::Transient);
+    QCOMPARE(NetworkManager::classifyFailure(QNetworkReply::UnknownServerError, 504), Kind::Transient);
+    QCOMPARE(NetworkManager::classifyFailure(QNetworkReply::ContentNotFoundError, 404), Kind::Permanent);
+    QCOMPARE(NetworkManager::classifyFailure(QNetworkReply::ContentAccessDenied, 403), Kind::Permanent);
+    QCOMPARE(NetworkManager::classifyFailure(QNetworkReply::OperationCanceledError, 0), Kind::Transient);
+    QCOMPARE(NetworkManager::classifyFailure(QNetworkReply::RemoteHostClosedError, 0), Kind::Transient);
+    QCOMPARE(NetworkManager::classifyFailure(QNetworkReply::HostNotFoundError, 0), Kind::Permanent);
+
+    // Retry-After：秒数或HTTP日期，负数取0，上限10分钟
+    const QDateTime now(QDate(2015, 10, 21), QTime(7, 27, 30), Qt::UTC);
+    QCOMPARE(NetworkManager::parseRetryAfter("120", now), 120000);
+    QCOMPARE(NetworkManager::parseRetryAfter(" 2 ", now), 2000);
+    QCOMPARE(NetworkManager::parseRetryAfter("-5", now), 0);
+    QCOMPARE(NetworkManager::parseRetryAfter("86400", now), 600000);
+    QCOMPARE(NetworkManager::parseRetryAfter("Wed, 21 Oct 2015 07:28:00 GMT", now), 30000);
+    QCOMPARE(NetworkManager::parseRetryAfter("Wed, 21 Oct 2015 07:00:00 GMT", now), 0);
+    QCOMPARE(NetworkManager::parseRetryAfter(QByteArray(), now), -1);
+    QCOMPARE(NetworkManager::parseRetryAfter("soon", now), -1);
+
+    // 退避时间随重试次数翻倍，抖动在后一半区间内，单次最多60秒
+    for (int i = 0; i < 100; ++i) {
+        const int first = NetworkManager::backoffDelayMs(1000, 0);
+        QVERIFY(first >= 500 && first <= 1000);
+        const int third = NetworkManager::backoffDelayMs(1000, 3);
+        QVERIFY(third >= 4000 && third <= 8000);
+        const int capped = NetworkManager::backoffDelayMs(1000, 40);
+        QVERIFY(capped >= 30000 && capped <= 60000);
+    }
+}
+
+void TestMusicBrainzApi::testCancellation()
+{
+    // 排队中的请求直接出队，不消耗令牌
+    {
+        NetworkManager manager;
+        manager.setDispatchPaused(true);
+        manager.sendRequest(LOCAL_URL, TEST_USER_AGENT);
+        const quint64 cancelled = manager.sendRequest(LOCAL_URL, TEST_USER_AGENT);
+        QVERIFY(manager.cancelRequest(cancelled));
+        QVERIFY(!manager.cancelRequest(cancelled));
+        QVERIFY(!manager.cancelRequest(0));
+
+        const NetworkManager::SchedulerMetrics metrics = manager.schedulerMetrics();
+        QCOMPARE(metrics.cancelledCount, qint64(1));
+        QCOMPARE(metrics.queueDepth, 1);
+        QCOMPARE(metrics.dispatchedCount, qint64(0));
+    }
+
+    MusicBrainzApiHub *hub = MusicBrainzApiHub::instance();
+    NetworkManager *network = hub->networkManager();
+    network->setDispatchPaused(true);
+    auto resume = qScopeGuard([network]() { network->setDispatchPaused(false); });
+    const MusicBrainzApiHub::Metrics before = hub->metrics();
+
+    // 合并请求中只取消一个调用方时，网络请求继续等待另一个调用方
+    MusicBrainzApi *owner = new MusicBrainzApi();
+    MusicBrainzApi other;
+    const RequestId ticket = other.search("cancellation test", EntityType::Artist);
+    owner->search("cancellation test", EntityType::Artist);
+    other.cancelRequest(ticket);
+
+    MusicBrainzApiHub::Metrics after = hub->metrics();
+    QCOMPARE(after.cancelledCount - before.cancelledCount, qint64(1));
+    QCOMPARE(after.abortedCount - before.abortedCount, qint64(0));
+    QCOMPARE(after.scheduler.queueDepth - before.scheduler.queueDepth, 1);
+
+    // 最后一个调用方随所有者析构时，网络请求从调度队列移除
+    delete owner;
+    after = hub->metrics();
+    QCOMPARE(after.cancelledCount - before.cancelledCount, qint64(2));
+    QCOMPARE(after.abortedCount - before.abortedCount, qint64(1));
+    QCOMPARE(after.scheduler.queueDepth, before.scheduler.queueDepth);
+    QCOMPARE(after.scheduler.cancelledCount - before.scheduler.cancelledCount, qint64(1));
+}
+
+void TestMusicBrainzApi::testParsePool()
+{
+    // 配置的线程数原样使用，自动时给GUI线程留一个核心，最多4个
+    QCOMPARE(MusicBrainzApiHub::parseThreadCount(3), 3);
+    const int automatic = MusicBrainzApiHub::parseThreadCount(0);
+    QCOMPARE(automatic, qBound(1, QThread::idealThreadCount() - 1, 4));
+    QCOMPARE(MusicBrainzApiHub::parseThreadCount(-1), automatic);
+
+    QJsonArray artists;
+    for (int i = 0; i < 50; ++i) {
+        QJsonObject artist;
+        artist["id"] = QString("b10bbbfc-cf9e-42e0-be17-%1").arg(i, 12, 10, QChar('0'));
+        artist["name"] = QString("Artist %1").arg(i);
+        artist["country"] = "GB";
+        artists.append(artist);
+    }
+    QJsonObject root;
+    root["count"] = 50;
+    root["offset"] = 0;
+    root["artists"] = artists;
+    const QByteArray page = QJsonDocument(root).toJson(QJsonDocument::Compact);
+
+    QVariantMap context;
+    context["entityType"] = static_cast<int>(EntityType::Artist);
+
+    // 解析器和响应处理器无状态，多个工作线程共用一份时结果与单线程一致
+    MusicBrainzParser parser;
+    MusicBrainzResponseHandler handler(&parser);
+    const auto names = [](const ParsedResponse &response) {
+        QStringList result;
+        for (const auto &item : response.items) {
+            result.append(item->getName());
+        }
+        return result;
+    };
+    const QStringList expected = names(handler.handleResponse(RequestType::Search, page, context));
+    QCOMPARE(expected.size(), 50);
+
+    QThreadPool pool;
+    pool.setMaxThreadCount(4);
+    QVector<QStringList> results(16);
+    for (int job = 0; job < results.size(); ++job) {
+        QStringList *result = &results[job];
+        pool.start([&, result]() {
+            *result = names(handler.handleResponse(RequestType::Search, page, context));
+        });
+    }
+    QVERIFY(pool.waitForDone(30000));
+    for (const QStringList &result : results) {
+        QCOMPARE(result, expected);
+    }
+}
+
 QTEST_MAIN(TestMusicBrainzApi)
 #include "tst_api.moc"
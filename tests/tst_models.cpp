@@ -1,53 +1,450 @@
 #include <QtTest>
 #include <QCoreApplication>
-#include "album.h"
-#include "artist.h"
-#include "release.h"
-#include "track.h"
+#include "../src/models/resultitem.h"
+#include "../src/models/resulttablemodel.h"
+#include "../src/api/musicbrainzparser.h"
+#include "../src/api/musicbrainz_response_handler.h"
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+
+namespace {
+// 构造测试条目：ID按序号生成（有效的MBID），名称为"<前缀> <序号>"
+QSharedPointer<ResultItem> makeItem(int i, EntityType type = EntityType::Recording,
+                                    const QString &prefix = QStringLiteral("Recording"))
+{
+    const QString id = QString("489ce91b-6658-3307-9877-%1").arg(i, 12, 10, QChar('0'));
+    return QSharedPointer<ResultItem>::create(id, QString("%1 %2").arg(prefix).arg(i), type);
+}
+} // namespace
 
 class TestModels : public QObject
 {
     Q_OBJECT
 
 private slots:
-    void testAlbum();
-    void testArtist();
-    void testRelease();
-    void testTrack();
+    void testResultTableModel();
+    void benchmarkResultTableModelData();
+    void testResultTableModelSort();
+    void benchmarkResultTableModelSort();
+    void testResultTableModelIncremental();
+    void testResultTableModelPaging();
+    void testColumnSchema();
+    void testColumnDetectionLazyFields();
+
+private:
+    static QList<QSharedPointer<ResultItem>> makeArtistItems(int count);
 };
 
-void TestModels::testAlbum()
+QList<QSharedPointer<ResultItem>> TestModels::makeArtistItems(int count)
+{
+    // 构造与搜索结果字段相同的一组艺术家条目
+    QList<QSharedPointer<ResultItem>> items;
+    for (int i = 0; i < count; ++i) {
+        auto item = makeItem(i, EntityType::Artist, "Artist");
+        item->setScore(100 - i % 100);
+        item->setDisambiguation("test fixture");
+        item->setDetailProperty("sort_name", item->getName());
+        item->setDetailProperty("type", "Group");
+        item->setDetailProperty("country", "GB");
+        item->setDetailProperty("life_span", "1960 - ");
+        item->setDetailProperty("tags", QStringList{"tag 0", "tag 1", "tag 2", "tag 3", "tag 4"});
+        items.append(item);
+    }
+    return items;
+}
+
+void TestModels::testResultTableModel()
+{
+    QList<QSharedPointer<ResultItem>> items;
+    for (int i = 0; i < 3; ++i) {
+        auto item = makeItem(i);
+        item->setDetailProperty("title", item->getName());
+        item->setDetailProperty("length", qint64((i + 1) * 65000));
+        item->setDetailProperty("rating", 4.5 - i);
+        items.append(item);
+    }
+
+    ResultTableModel model;
+    model.setItems(items, EntityType::Recording);
+    model.setVisibleColumns({"title", "length", "rating"});
+    QCOMPARE(model.columnCount(), 3);
+    QCOMPARE(model.rowCount(), 3);
+
+    // 时长和评分按列的格式化函数显示
+    QCOMPARE(model.data(model.index(0, 0)).toString(), QString("Recording 0"));
+    QCOMPARE(model.data(model.index(0, 1)).toString(), QString("1:05"));
+    QCOMPARE(model.data(model.index(2, 2)).toString(), QString("2.5"));
+    QVERIFY(!model.data(model.index(0, 3)).isValid());
+
+    // 条目修改后缓存的显示值失效
+    items[0]->setDetailProperty("length", qint64(600000));
+    QCOMPARE(model.data(model.index(0, 1)).toString(), QString("10:00"));
+
+    // 排序比较原始值（毫秒），不比较格式化后的文本
+    model.sort(1, Qt::DescendingOrder);
+    QCOMPARE(model.getItem(0), items[0]);
+    QCOMPARE(model.data(model.index(0, 1)).toString(), QString("10:00"));
+    QCOMPARE(model.data(model.index(1, 1)).toString(), QString("3:15"));
+    QCOMPARE(model.data(model.index(2, 1)).toString(), QString("2:10"));
+
+    // 更换列后访问器重新解析
+    model.setVisibleColumns({"name", "rating"});
+    QCOMPARE(model.data(model.index(0, 0)).toString(), QString("Recording 0"));
+    QCOMPARE(model.data(model.index(0, 1)).toString(), QString("4.5"));
+}
+
+void TestModels::benchmarkResultTableModelData()
+{
+    const QList<QSharedPointer<ResultItem>> items = makeArtistItems(100);
+
+    ResultTableModel model;
+    model.setItems(items, EntityType::Artist);
+    const int rows = model.rowCount();
+    const int columns = model.columnCount();
+    QVERIFY(columns > 0);
+
+    // 模拟重绘：读取所有可见单元格
+    QBENCHMARK {
+        for (int row = 0; row < rows; ++row) {
+            for (int column = 0; column < columns; ++column) {
+                QVariant value = model.data(model.index(row, column));
+                Q_UNUSED(value)
+            }
+        }
+    }
+}
+
+void TestModels::testResultTableModelSort()
+{
+    const QStringList titles = {"beta", "Alpha", QString(), "alpha", "Gamma"};
+    QList<QSharedPointer<ResultItem>> items;
+    for (int i = 0; i < titles.size(); ++i) {
+        auto item = makeItem(i);
+        if (!titles[i].isNull()) {
+            item->setDetailProperty("title", titles[i]);
+        }
+        item->setDetailProperty("length", qint64(1000 * (i % 2)));
+        items.append(item);
+    }
+
+    ResultTableModel model;
+    model.setItems(items, EntityType::Recording);
+    model.setVisibleColumns({"title", "length"});
+    const QPersistentModelIndex gamma = model.index(4, 0);
+
+    // 文本忽略大小写比较，相等的行保持原有顺序，空值在升序时排在最前
+    model.sort(0, Qt::AscendingOrder);
+    QCOMPARE(model.getItem(0), items[2]);
+    QCOMPARE(model.getItem(1), items[1]);
+    QCOMPARE(model.getItem(2), items[3]);
+    QCOMPARE(model.getItem(3), items[0]);
+    QCOMPARE(model.getItem(4), items[4]);
+
+    // 降序时空值排在最后，相等的行仍保持原有顺序
+    model.sort(0, Qt::DescendingOrder);
+    QCOMPARE(model.getItem(0), items[4]);
+    QCOMPARE(model.getItem(1), items[0]);
+    QCOMPARE(model.getItem(2), items[1]);
+    QCOMPARE(model.getItem(3), items[3]);
+    QCOMPARE(model.getItem(4), items[2]);
+
+    // 持久索引跟随条目移动
+    QVERIFY(gamma.isValid());
+    QCOMPARE(gamma.row(), 0);
+    QCOMPARE(model.getItem(gamma.row()), items[4]);
+
+    // 数值列按数值比较
+    model.sort(1, Qt::AscendingOrder);
+    QCOMPARE(model.data(model.index(0, 1)).toLongLong(), qint64(0));
+    QCOMPARE(model.data(model.index(4, 1)).toString(), QString("0:01"));
+
+    // 超过并行阈值的大结果集与单线程稳定排序的结果相同
+    QList<QSharedPointer<ResultItem>> many;
+    for (int i = 0; i < 40000; ++i) {
+        auto item = makeItem(i);
+        item->setDetailProperty("length", qint64((i * 7919) % 1000));
+        many.append(item);
+    }
+    model.setItems(many, EntityType::Recording);
+    model.setVisibleColumns({"name", "length"});
+    model.sort(1, Qt::AscendingOrder);
+    QList<QSharedPointer<ResultItem>> expected = many;
+    std::stable_sort(expected.begin(), expected.end(), [](const auto &a, const auto &b) {
+        return a->getDetailProperty("length").toLongLong() < b->getDetailProperty("length").toLongLong();
+    });
+    for (int row = 0; row < expected.size(); ++row) {
+        QCOMPARE(model.getItem(row), expected[row]);
+    }
+}
+
+void TestModels::benchmarkResultTableModelSort()
 {
-    Album album;
-    album.setTitle("Test Album");
-    album.setArtist("Test Artist");
-    QCOMPARE(album.title(), QString("Test Album"));
-    QCOMPARE(album.artist(), QString("Test Artist"));
+    QList<QSharedPointer<ResultItem>> items;
+    for (int i = 0; i < 100000; ++i) {
+        // 7919与100000互质，序号是0..99999的一个乱序排列
+        auto item = makeItem((i * 7919) % 100000);
+        item->setDetailProperty("title", item->getName());
+        items.append(item);
+    }
+
+    ResultTableModel model;
+    model.setItems(items, EntityType::Recording);
+    model.setVisibleColumns({"title", "length"});
+
+    // 目标是十万行在100毫秒以内完成；结果与硬件有关，只报告不断言
+    QElapsedTimer timer;
+    timer.start();
+    model.sort(0, Qt::DescendingOrder);
+    qInfo().noquote() << QString("100k rows: text column sorted in %1 ms (target < 100 ms)").arg(timer.elapsed());
+
+    // 十万行按文本列排序：排序键提取一次，比较只比较排序键
+    Qt::SortOrder order = Qt::AscendingOrder;
+    QBENCHMARK {
+        model.sort(0, order);
+        order = order == Qt::AscendingOrder ? Qt::DescendingOrder : Qt::AscendingOrder;
+    }
 }
 
-void TestModels::testArtist()
+void TestModels::testResultTableModelIncremental()
 {
-    Artist artist;
-    artist.setName("Test Artist");
-    QCOMPARE(artist.name(), QString("Test Artist"));
+    auto makeRecording = [](int i) {
+        auto item = makeItem(i);
+        item->setDetailProperty("title", item->getName());
+        item->setDetailProperty("length", qint64(65000));
+        return item;
+    };
+
+    QList<QSharedPointer<ResultItem>> items = {makeRecording(0), makeRecording(1)};
+    ResultTableModel model;
+    model.setItems(items, EntityType::Recording);
+    const int columns = model.columnCount();
+    const int lengthColumn = model.getVisibleColumns().indexOf("length");
+    QVERIFY(lengthColumn >= 0);
+
+    QSignalSpy resets(&model, &QAbstractItemModel::modelReset);
+    QSignalSpy rowsInserted(&model, &QAbstractItemModel::rowsInserted);
+    QSignalSpy columnsInserted(&model, &QAbstractItemModel::columnsInserted);
+    QSignalSpy changed(&model, &QAbstractItemModel::dataChanged);
+
+    // 完整列表以已显示的条目开头（流式结果完成）：只插入新增的行
+    items << makeRecording(2) << makeRecording(3);
+    model.setItems(items, EntityType::Recording);
+    QCOMPARE(resets.count(), 0);
+    QCOMPARE(rowsInserted.count(), 1);
+    QCOMPARE(rowsInserted.at(0).at(1).toInt(), 2);
+    QCOMPARE(rowsInserted.at(0).at(2).toInt(), 3);
+    QCOMPARE(model.rowCount(), 4);
+    QCOMPARE(model.columnCount(), columns);
+
+    // 详情到达：多次刷新合并为一次，只通知值变化的单元格
+    QCOMPARE(model.data(model.index(1, lengthColumn)).toString(), QString("1:05"));
+    items[1]->setDetailProperty("length", qint64(600000));
+    model.refreshEntity(items[1]->getMbid());
+    model.refreshEntity(items[1]->getMbid());
+    QCOMPARE(changed.count(), 0);
+    model.flushPendingUpdates();
+    QCOMPARE(changed.count(), 1);
+    QCOMPARE(qvariant_cast<QModelIndex>(changed.at(0).at(0)), model.index(1, lengthColumn));
+    QCOMPARE(qvariant_cast<QModelIndex>(changed.at(0).at(1)), model.index(1, lengthColumn));
+    QCOMPARE(model.data(model.index(1, lengthColumn)).toString(), QString("10:00"));
+
+    // 未修改的条目不发出通知
+    model.refreshEntity(items[0]->getMbid());
+    model.data(model.index(0, 0));
+    model.flushPendingUpdates();
+    QCOMPARE(changed.count(), 1);
+
+    // 详情带来新字段时在末尾插入列，不重置模型
+    items[2]->setDetailProperty("disambiguation", QString("live"));
+    model.refreshEntity(items[2]->getMbid());
+    model.flushPendingUpdates();
+    QCOMPARE(columnsInserted.count(), 1);
+    QCOMPARE(model.columnCount(), columns + 1);
+    QCOMPARE(model.getVisibleColumns().last(), QString("disambiguation"));
+    QCOMPARE(model.data(model.index(2, columns)).toString(), QString("live"));
+    QCOMPARE(resets.count(), 0);
+
+    // 用户选择的列不会被自动扩展
+    model.setVisibleColumns({"title", "length"});
+    items[3]->setDetailProperty("isrcs", QString("GBAYE0601498"));
+    model.refreshEntity(items[3]->getMbid());
+    model.flushPendingUpdates();
+    QCOMPARE(model.columnCount(), 2);
 }
 
-void TestModels::testRelease()
+void TestModels::testResultTableModelPaging()
 {
-    Release release;
-    release.setTitle("Test Release");
-    release.setDate("2023-01-01");
-    QCOMPARE(release.title(), QString("Test Release"));
-    QCOMPARE(release.date(), QString("2023-01-01"));
+    auto makePage = [](int offset, int count) {
+        QList<QSharedPointer<ResultItem>> page;
+        for (int i = offset; i < offset + count; ++i) {
+            auto item = makeItem(i);
+            item->setDetailProperty("title", item->getName());
+            page.append(item);
+        }
+        return page;
+    };
+
+    ResultTableModel model;
+    const QList<QSharedPointer<ResultItem>> first = makePage(0, 25);
+    model.setItems(first, EntityType::Recording);
+    model.setPaging(1010, 25);
+    QVERIFY(model.isPaged());
+    QVERIFY(model.canFetchMore(QModelIndex()));
+    const int titleColumn = model.getVisibleColumns().indexOf("title");
+    QVERIFY(titleColumn >= 0);
+
+    // 滚动到末尾：插入下一页的占位行并请求该页
+    QSignalSpy requested(&model, &ResultTableModel::pageRequested);
+    model.fetchMore(QModelIndex());
+    QCOMPARE(model.rowCount(), 50);
+    QVERIFY(!model.getItem(30));
+    QCOMPARE(model.data(model.index(30, 0)).toString(), QString("Loading..."));
+    QTRY_COMPARE(requested.count(), 1);
+    QCOMPARE(requested.at(0).at(0).toInt(), 25);
+
+    // 页面到达后替换占位行
+    model.setPage(25, makePage(25, 25));
+    QVERIFY(model.getItem(30));
+    QCOMPARE(model.data(model.index(30, titleColumn)).toString(), QString("Recording 30"));
+
+    // 分页加载时行号即偏移量，未全部加载时不排序
+    model.sort(titleColumn, Qt::DescendingOrder);
+    QCOMPARE(model.getItem(0), first[0]);
+
+    // 加载到最后：已加载的页面数量有上限，离可见区域最远的页面被释放
+    while (model.canFetchMore(QModelIndex())) {
+        const int offset = model.rowCount();
+        model.fetchMore(QModelIndex());
+        model.data(model.index(model.rowCount() - 1, 0));
+        model.setPage(offset, makePage(offset, qMin(25, 1010 - offset)));
+    }
+    QCOMPARE(model.rowCount(), 1010);
+    QVERIFY(model.getItem(1009));
+    QVERIFY(!model.getItem(0));
+    int resident = 0;
+    for (int row = 0; row < model.rowCount(); ++row) {
+        resident += model.getItem(row) ? 1 : 0;
+    }
+    QVERIFY(resident <= 40 * 25);
+
+    // 滚动回已释放的页面时重新请求
+    requested.clear();
+    QCOMPARE(model.data(model.index(3, 0)).toString(), QString("Loading..."));
+    QTRY_COMPARE(requested.count(), 1);
+    QCOMPARE(requested.at(0).at(0).toInt(), 0);
+    model.setPageFailed(0);
+    QCOMPARE(model.data(model.index(3, 0)).toString(), QString("Failed to load"));
+
+    // 解析器丢弃了无效实体、第一页不满时，行号仍按请求的页面大小对应偏移量
+    QList<QSharedPointer<ResultItem>> shortPage = makePage(0, 25);
+    shortPage.removeAt(10);
+    model.setItems(shortPage, EntityType::Recording);
+    model.setPaging(60, 25);
+    QCOMPARE(model.rowCount(), 25);
+    QVERIFY(!model.getItem(24));
+    QVERIFY(model.data(model.index(24, 0)).toString().isEmpty());
+    requested.clear();
+    model.fetchMore(QModelIndex());
+    QCOMPARE(model.rowCount(), 50);
+    QTRY_COMPARE(requested.count(), 1);
+    QCOMPARE(requested.at(0).at(0).toInt(), 25);
+    QList<QSharedPointer<ResultItem>> secondPage = makePage(25, 25);
+    secondPage.removeLast();
+    model.setPage(25, secondPage);
+    model.fetchMore(QModelIndex());
+    model.setPage(50, makePage(50, 10));
+    QCOMPARE(model.rowCount(), 60);
+    QCOMPARE(model.getItem(25)->getName(), QString("Recording 25"));
+
+    // 全部页面加载后可以排序，空行不参与排序
+    model.sort(titleColumn, Qt::AscendingOrder);
+    QVERIFY(!model.isPaged());
+    QCOMPARE(model.rowCount(), 58);
+    QCOMPARE(model.getItem(0)->getName(), QString("Recording 0"));
+
+    // 新的结果集关闭分页
+    model.setItems(makePage(0, 3), EntityType::Recording);
+    QVERIFY(!model.isPaged());
+    QVERIFY(!model.canFetchMore(QModelIndex()));
+}
+
+void TestModels::testColumnSchema()
+{
+    ColumnSchema schema;
+    const QSharedPointer<ResultItem> a = makeItem(0);
+    a->setDetailProperty("title", a->getName());
+    a->setDetailProperty("length", qint64(1000));
+    a->setDetailProperty("first-release-date", QString());
+    a->setDetailProperty("tags", QVariantList{QString("rock")});
+    a->setDetailProperty("disambiguation", QString());
+
+    // 只统计有内容的标量字段：空文本和复合字段不会成为列
+    QVERIFY(schema.addItem(*a));
+    QCOMPARE(schema.count("name"), 1);
+    QCOMPARE(schema.count("id"), 1);
+    QCOMPARE(schema.count("title"), 1);
+    QCOMPARE(schema.count("length"), 1);
+    QCOMPARE(schema.count("first-release-date"), 0);
+    QCOMPARE(schema.count("tags"), 0);
+    QCOMPARE(schema.count("disambiguation"), 0);
+
+    // 没有新字段的条目只增加计数
+    const QSharedPointer<ResultItem> b = makeItem(1);
+    b->setDetailProperty("title", b->getName());
+    QVERIFY(!schema.addItem(*b));
+    QCOMPARE(schema.count("title"), 2);
+
+    // 修改后重新统计同一条目，不重复计数
+    b->setDetailProperty("video", true);
+    QVERIFY(schema.addItem(*b));
+    QCOMPARE(schema.count("title"), 2);
+    QCOMPARE(schema.count("video"), 1);
+
+    // 移除条目后其字段计数减少
+    schema.removeItem(*a);
+    QCOMPARE(schema.count("length"), 0);
+    QVERIFY(!schema.fields().contains("length"));
+    QCOMPARE(schema.fields(), QStringList({"name", "id", "title", "video"}));
 }
 
-void TestModels::testTrack()
+void TestModels::testColumnDetectionLazyFields()
 {
-    Track track;
-    track.setTitle("Test Track");
-    track.setDuration(180);
-    QCOMPARE(track.title(), QString("Test Track"));
-    QCOMPARE(track.duration(), 180);
+    // 与搜索接口结构相同的一页艺术家结果，带有会被延迟解码的复合字段
+    QJsonArray artists;
+    for (int i = 0; i < 10; ++i) {
+        QJsonObject lifeSpan;
+        lifeSpan["begin"] = "1960";
+        QJsonObject tag;
+        tag["count"] = 1;
+        tag["name"] = "rock";
+
+        QJsonObject artist;
+        artist["id"] = QString("b10bbbfc-cf9e-42e0-be17-%1").arg(i, 12, 10, QChar('0'));
+        artist["type"] = "Group";
+        artist["name"] = QString("Artist %1").arg(i);
+        artist["country"] = "GB";
+        artist["life-span"] = lifeSpan;
+        artist["tags"] = QJsonArray{tag};
+        artists.append(artist);
+    }
+    QJsonObject root;
+    root["count"] = 10;
+    root["offset"] = 0;
+    root["artists"] = artists;
+
+    QVariantMap context;
+    context["entityType"] = static_cast<int>(EntityType::Artist);
+    MusicBrainzParser parser;
+    MusicBrainzResponseHandler handler(&parser);
+    const ParsedResponse response = handler.handleResponse(RequestType::Search, QJsonDocument(root).toJson(), context);
+    QVERIFY(!response.items.isEmpty());
+
+    // 列检测不会解码列表结果的延迟字段
+    ResultTableModel model;
+    model.setItems(response.items, EntityType::Artist);
+    QVERIFY(model.getVisibleColumns().contains("country"));
+    QVERIFY(response.items.first()->hasLazyFields());
 }
 
 QTEST_MAIN(TestModels)
@@ -0,0 +1,624 @@
+#include <QtTest>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QJsonArray>
+#include "../src/api/musicbrainzparser.h"
+#include "../src/api/musicbrainz_response_handler.h"
+#include "../src/api/api_utils.h"
+#include "../src/models/resultitem.h"
+#include "../src/utils/string_pool.h"
+#include "../src/core/mbid.h"
+#include "../src/models/entitypayload.h"
+#include "../src/api/entity_store.h"
+#include <QRegularExpression>
+#include <QSet>
+#include <QTemporaryDir>
+#if defined(__GLIBC__)
+#include <malloc.h>
+#endif
+
+#include "../src/core/types.h"
+#include "test_pages.h"
+
+class TestParser : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void initTestCase();
+    void testSearchPage();
+    void testInvalidResponse();
+    void testTypedRecord();
+    void testLazyFields();
+    void testSchemaEntities();
+    void testEntityTypeLookup();
+    void testMbid();
+    void testEntityPayload();
+    void testEntityStore();
+    void testStreamingSearchPage();
+    void testStringInterning();
+    void reportSessionMemory();
+    void testStreamingTruncated();
+    void testStreamingMalformed();
+    void benchmarkSearchPageLegacy();
+    void benchmarkSearchPageSingleParse();
+    void benchmarkSearchPageEagerDecode();
+    void benchmarkEntityTypeLookup();
+    void benchmarkMbidValidationRegex();
+    void benchmarkMbidValidation();
+    void benchmarkEntityStoreLookup();
+
+private:
+    EntityPayload makeDetailsPayload(const QString &id);
+    static qint64 heapInUse();
+    qint64 measureSession(bool intern, int pages);
+
+    MusicBrainzParser *m_parser = nullptr;
+    MusicBrainzResponseHandler *m_handler = nullptr;
+    QByteArray m_page;
+    QVariantMap m_context;
+};
+
+void TestParser::initTestCase()
+{
+    m_parser = new MusicBrainzParser(this);
+    m_handler = new MusicBrainzResponseHandler(m_parser, this);
+    m_page = TestPages::makeArtistPage(100);
+    m_context["entityType"] = static_cast<int>(EntityType::Artist);
+}
+
+void TestParser::testSearchPage()
+{
+    const ParsedResponse response = m_handler->handleResponse(RequestType::Search, m_page, m_context);
+    QVERIFY(response.success);
+    QCOMPARE(response.items.size(), 100);
+    QCOMPARE(response.totalCount, 2500);
+    QCOMPARE(response.offset, 100);
+    QCOMPARE(response.items.first()->getName(), QString("Artist 0"));
+}
+
+void TestParser::testInvalidResponse()
+{
+    const ParsedResponse response = m_handler->handleResponse(RequestType::Search, "{\"artists\": [", m_context);
+    QVERIFY(!response.success);
+    QVERIFY(!response.errorMessage.isEmpty());
+}
+
+void TestParser::testTypedRecord()
+{
+    const ParsedResponse response = m_handler->handleResponse(RequestType::Search, m_page, m_context);
+    QVERIFY(!response.items.isEmpty());
+    const QSharedPointer<ResultItem> item = response.items.first();
+
+    // 常用字段进入定长记录，键值接口读取结果不变
+    const ArtistRecord *artist = item->record().artist();
+    QVERIFY(artist);
+    QCOMPARE(artist->country, QString("GB"));
+    QCOMPARE(artist->sortName, QString("Artist 0"));
+    QCOMPARE(item->getDetailProperty("type").toString(), QString("Group"));
+    QVERIFY(item->getDetailData().contains("country"));
+    QVERIFY(item->getDetailProperty("tags").isValid());
+
+    // 类型不匹配的值进入溢出映射，并覆盖记录中的旧值
+    item->setDetailProperty("country", QVariantList{"GB", "US"});
+    QVERIFY(!item->record().contains("country"));
+    QCOMPARE(item->getDetailProperty("country").toList().size(), 2);
+    item->setDetailProperty("country", "US");
+    QCOMPARE(item->record().artist()->country, QString("US"));
+    QCOMPARE(item->getDetailData().value("country").toString(), QString("US"));
+}
+
+void TestParser::testLazyFields()
+{
+    const ParsedResponse response = m_handler->handleResponse(RequestType::Search, m_page, m_context);
+    QVERIFY(!response.items.isEmpty());
+    const QSharedPointer<ResultItem> lazy = response.items.first();
+
+    // 列表结果的复合字段尚未解码，标量字段已经可用
+    QVERIFY(lazy->hasLazyFields());
+    QVERIFY(!lazy->getLoadedDetailData().contains("tags"));
+    QVERIFY(lazy->hasDetailProperty("life_span"));
+    QCOMPARE(lazy->getDetailProperty("country").toString(), QString("GB"));
+    QVERIFY(!lazy->getDetailProperty("no-such-field").isValid());
+    QVERIFY(lazy->hasLazyFields());
+
+    // 首次访问复合字段时解码，结果与完整解析相同
+    QJsonObject root;
+    QVERIFY(MusicBrainzParser::parseRootObject(m_page, &root));
+    const auto eager = m_parser->parseSearchResponse(root, EntityType::Artist, false);
+    QCOMPARE(lazy->getDetailProperty("tags").toList().size(), 5);
+    QVERIFY(!lazy->hasLazyFields());
+    QCOMPARE(lazy->getDetailData(), eager.first()->getDetailData());
+}
+
+void TestParser::testSchemaEntities()
+{
+    // 以前没有专用解析的实体类型，现在由字段表生成
+    const QByteArray data = R"({
+        "events": [{
+            "id": "0f7c1b4a-32e2-4cbe-9e64-96ea6bbd0a9c",
+            "name": "Glastonbury 2016",
+            "type": "Festival",
+            "life-span": {"begin": "2016-06-22", "end": "2016-06-26", "ended": true},
+            "tags": [{"name": "festival", "count": 3}],
+            "relations": [{"type": "held at", "direction": "forward",
+                           "place": {"id": "f8e4d8d0-7b0e-4b5c-9b1c-9b1f5a0f6c2e", "name": "Worthy Farm"}}]
+        }]
+    })";
+    const auto events = m_parser->parseSearchResponse(data, EntityType::Event);
+    QCOMPARE(events.size(), 1);
+    const QSharedPointer<ResultItem> event = events.first();
+    QCOMPARE(event->getDetailProperty("life_span").toMap().value("begin").toString(), QString("2016-06-22"));
+    QVERIFY(event->getDetailProperty("life-span").isValid());
+    QCOMPARE(event->getDetailProperty("tags").toList().first().toMap().value("name").toString(), QString("festival"));
+    QCOMPARE(event->getDetailProperty("relationships").toList().size(), 1);
+    QVERIFY(event->getDetailProperty("relations").isValid());
+
+    // 延迟模式按同一张字段表报告改名保存的字段
+    QJsonObject root;
+    QVERIFY(MusicBrainzParser::parseRootObject(data, &root));
+    const auto lazy = m_parser->parseSearchResponse(root, EntityType::Event, true);
+    QVERIFY(lazy.first()->hasDetailProperty("life_span"));
+    QVERIFY(!lazy.first()->hasDetailProperty("area_info"));
+    QCOMPARE(lazy.first()->getDetailData(), event->getDetailData());
+}
+
+void TestParser::testEntityTypeLookup()
+{
+    for (const EntityMapping &mapping : ENTITY_MAPPINGS) {
+        const QString singular = QString::fromLatin1(mapping.singular.data(), qsizetype(mapping.singular.size()));
+        const QString plural = QString::fromLatin1(mapping.plural.data(), qsizetype(mapping.plural.size()));
+        QCOMPARE(EntityUtils::stringToEntityType(singular), mapping.type);
+        QCOMPARE(EntityUtils::pluralNameToEntityType(plural), mapping.type);
+        QCOMPARE(EntityUtils::entityTypeToString(mapping.type), singular);
+    }
+    QCOMPARE(EntityUtils::stringToEntityType(QString("artists")), EntityType::Unknown);
+    QCOMPARE(EntityUtils::stringToEntityType(QString("Artist")), EntityType::Unknown);
+    QCOMPARE(EntityUtils::stringToEntityType(QString()), EntityType::Unknown);
+    QCOMPARE(EntityUtils::pluralNameToEntityType(QString("count")), EntityType::Unknown);
+
+    // 根对象未指定类型时按实体数组的键名推断
+    QCOMPARE(m_parser->parseSearchResponse(m_page).size(), 100);
+
+    QJsonObject root;
+    QVERIFY(MusicBrainzParser::parseRootObject(m_page, &root));
+    const QJsonObject artist = root.value("artists").toArray().first().toObject();
+    QCOMPARE(MusicBrainzParser::detectEntityType(artist), EntityType::Artist);
+    QCOMPARE(MusicBrainzParser::detectEntityType(QJsonObject{{"title", "Yesterday"}}), EntityType::Work);
+    QCOMPARE(MusicBrainzParser::detectEntityType(QJsonObject{{"title", "Yesterday"}, {"artist-credit", QJsonArray()}}),
+             EntityType::Recording);
+}
+
+void TestParser::testMbid()
+{
+    const QString text("b10bbbfc-cf9e-42e0-be17-e2c3e1d2600d");
+    bool ok = false;
+    const Mbid mbid = Mbid::fromString(text, &ok);
+    QVERIFY(ok);
+    QCOMPARE(mbid.high(), Q_UINT64_C(0xb10bbbfccf9e42e0));
+    QCOMPARE(mbid.low(), Q_UINT64_C(0xbe17e2c3e1d2600d));
+    QCOMPARE(mbid.toString(), text);
+    QCOMPARE(Mbid::fromString(text.toUpper()), mbid);
+
+    // 与原正则表达式接受的格式一致
+    QVERIFY(!Mbid::isValid(QString()));
+    QVERIFY(!Mbid::isValid(QString("b10bbbfc-cf9e-42e0-be17-e2c3e1d2600")));
+    QVERIFY(!Mbid::isValid(QString("b10bbbfc-cf9e-42e0-be17-e2c3e1d2600d0")));
+    QVERIFY(!Mbid::isValid(QString("b10bbbfc-cf9e-42e0-be17-e2c3e1d2600g")));
+    QVERIFY(!Mbid::isValid(QString("b10bbbfc_cf9e-42e0-be17-e2c3e1d2600d")));
+    QVERIFY(!Mbid::isValid(QString("{10bbbfc-cf9e-42e0-be17-e2c3e1d2600d")));
+    QVERIFY(!Mbid::isValid(QString::fromUtf8("b10bbbfc-cf9e-42e0-be17-e2c3e1d260\u00e9d")));
+    QVERIFY(Mbid::fromString(QString("not an mbid")).isNull());
+    QVERIFY(Validator::isValidMbid(text));
+
+    // 作为集合的键
+    QSet<Mbid> ids;
+    ids.insert(mbid);
+    ids.insert(Mbid::fromString(text.toUpper()));
+    QCOMPARE(ids.size(), 1);
+    QVERIFY(std::hash<Mbid>()(mbid) == std::hash<Mbid>()(Mbid::fromString(text)));
+
+    // 解析结果带有128位ID
+    const ParsedResponse response = m_handler->handleResponse(RequestType::Search, m_page, m_context);
+    QCOMPARE(response.items.first()->getMbid().toString(), response.items.first()->getId());
+}
+
+EntityPayload TestParser::makeDetailsPayload(const QString &id)
+{
+    QJsonObject artist;
+    artist["id"] = id;
+    artist["name"] = "The Beatles";
+    artist["type"] = "Group";
+    artist["country"] = "GB";
+    artist["tags"] = QJsonArray{QJsonObject{{"name", "rock"}, {"count", 12}}};
+
+    QVariantMap context;
+    context["entityType"] = static_cast<int>(EntityType::Artist);
+    return m_handler->handleResponse(RequestType::Details, QJsonDocument(artist).toJson(), context).entity;
+}
+
+void TestParser::testEntityPayload()
+{
+    const QByteArray data = R"({
+        "id": "b10bbbfc-cf9e-42e0-be17-e2c3e1d2600d",
+        "name": "The Beatles",
+        "type": "Group",
+        "country": "GB",
+        "disambiguation": "British rock band",
+        "life-span": {"begin": "1960", "ended": true},
+        "tags": [{"name": "rock", "count": 12}],
+        "aliases": [{"name": "Beatles", "locale": null}]
+    })";
+    QVariantMap context;
+    context["entityType"] = static_cast<int>(EntityType::Artist);
+    const ParsedResponse response = m_handler->handleResponse(RequestType::Details, data, context);
+    QVERIFY(response.success);
+
+    const EntityPayload &payload = response.entity;
+    QVERIFY(!payload.isNull());
+    QCOMPARE(payload.id(), QString("b10bbbfc-cf9e-42e0-be17-e2c3e1d2600d"));
+    QCOMPARE(payload.mbid(), Mbid::fromString(payload.id()));
+    QCOMPARE(payload.name(), QString("The Beatles"));
+    QCOMPARE(payload.type(), EntityType::Artist);
+    QCOMPARE(payload.disambiguation(), QString("British rock band"));
+    QCOMPARE(payload.value("country").toString(), QString("GB"));
+    QCOMPARE(payload.value("life_span").toMap().value("begin").toString(), QString("1960"));
+    QVERIFY(!payload.contains("missing"));
+    QVERIFY(!payload.value("missing").isValid());
+
+    // 旧的扁平映射：详细数据中的type（艺术家类型）优先
+    const QVariantMap flat = payload.toVariantMap();
+    QCOMPARE(flat.value("id").toString(), payload.id());
+    QCOMPARE(flat.value("type").toString(), QString("Group"));
+
+    // 二进制形式往返
+    const QByteArray bytes = payload.toCbor();
+    QVERIFY(bytes.size() < data.size());
+    QString error;
+    const EntityPayload decoded = EntityPayload::fromCbor(bytes, &error);
+    QVERIFY2(!decoded.isNull(), qPrintable(error));
+    QCOMPARE(decoded.toCbor(), bytes);
+    QCOMPARE(decoded.keys(), payload.keys());
+
+    const QSharedPointer<ResultItem> item = decoded.toItem();
+    QCOMPARE(item->getMbid(), payload.mbid());
+    QCOMPARE(item->getDisambiguation(), payload.disambiguation());
+    QCOMPARE(item->getDetailProperty("country").toString(), QString("GB"));
+    QCOMPARE(item->getDetailProperty("tags").toList().first().toMap().value("name").toString(), QString("rock"));
+
+    // 写入已有条目：所有字段一次合并，附加字段优先于同名的详细数据
+    ResultItem existing(payload.id(), payload.name(), EntityType::Artist);
+    existing.setDetailProperty("score_note", "kept");
+    const quint32 revision = existing.revision();
+    payload.applyTo(existing, QVariantMap{{"tags", QStringList{"rock"}}, {"origin", "Liverpool"}});
+    QVERIFY(existing.revision() != revision);
+    QVERIFY(existing.revision() - revision <= 2);
+    QCOMPARE(existing.getDetailProperty("country").toString(), QString("GB"));
+    QCOMPARE(existing.getDetailProperty("tags").toStringList(), QStringList{"rock"});
+    QCOMPARE(existing.getDetailProperty("origin").toString(), QString("Liverpool"));
+    QCOMPARE(existing.getDetailProperty("score_note").toString(), QString("kept"));
+
+    // 损坏或格式不符的数据
+    QVERIFY(EntityPayload::fromCbor(bytes.left(bytes.size() / 2), &error).isNull());
+    QVERIFY(!error.isEmpty());
+    QVERIFY(EntityPayload::fromCbor(QCborValue(42).toCbor()).isNull());
+}
+
+void TestParser::testEntityStore()
+{
+    QTemporaryDir dir;
+    QVERIFY(dir.isValid());
+    const QString includes = EntityUtils::getDefaultIncludes(EntityType::Artist);
+    const QString id("b10bbbfc-cf9e-42e0-be17-e2c3e1d2600d");
+    const Mbid mbid = Mbid::fromString(id);
+    const EntityPayload payload = makeDetailsPayload(id);
+    QVERIFY(!payload.isNull());
+
+    {
+        EntityStore store;
+        QVERIFY(store.open(dir.path()));
+        QVERIFY(store.find(mbid, EntityType::Artist, includes, -1).isNull());
+        QVERIFY(store.insert(payload, includes));
+
+        const EntityPayload found = store.find(mbid, EntityType::Artist, includes, 3600);
+        QCOMPARE(found.toCbor(), payload.toCbor());
+        QVERIFY(store.contains(mbid, EntityType::Artist, includes, 3600));
+
+        // 类型或include集合不同的请求不能使用这份副本
+        QVERIFY(!store.contains(mbid, EntityType::Release, includes, -1));
+        QVERIFY(!store.contains(mbid, EntityType::Artist, includes + "+recordings", -1));
+
+        // 过期
+        QVERIFY(store.insert(payload, includes, QDateTime::currentDateTimeUtc().addDays(-30)));
+        QVERIFY(store.find(mbid, EntityType::Artist, includes, 7 * 24 * 3600).isNull());
+        QVERIFY(!store.find(mbid, EntityType::Artist, includes, -1).isNull());
+        QCOMPARE(store.stats().staleMisses, qint64(1));
+
+        // 足以触发索引扩容的实体数
+        for (int i = 0; i < 1500; ++i) {
+            const QString otherId = QString("489ce91b-6658-3307-9877-%1").arg(i, 12, 10, QChar('0'));
+            QVERIFY(store.insert(makeDetailsPayload(otherId), includes));
+        }
+        QCOMPARE(store.stats().records, 1501);
+        QCOMPARE(store.find(mbid, EntityType::Artist, includes, -1).name(), QString("The Beatles"));
+    }
+
+    // 重新打开后仍然存在；覆盖写入的旧记录在压缩时丢弃
+    {
+        EntityStore store;
+        QVERIFY(store.open(dir.path()));
+        QCOMPARE(store.stats().records, 1501);
+        QVERIFY(store.insert(payload, includes));
+        const EntityStore::Stats before = store.stats();
+        QVERIFY(before.liveBytes < before.dataBytes - 16);
+        QVERIFY(store.compact());
+        QCOMPARE(store.stats().dataBytes, before.liveBytes + 16);
+        QCOMPARE(store.stats().records, 1501);
+        QVERIFY(store.contains(mbid, EntityType::Artist, includes, 3600));
+    }
+
+    // 索引丢失时从数据文件重建；数据文件末尾不完整的记录被丢弃
+    QVERIFY(QFile::remove(dir.filePath("entities.idx")));
+    {
+        QFile data(dir.filePath("entities.dat"));
+        QVERIFY(data.open(QIODevice::Append));
+        data.write(QByteArray(20, 'x'));
+    }
+    {
+        EntityStore store;
+        QVERIFY(store.open(dir.path()));
+        QCOMPARE(store.stats().records, 1501);
+        QCOMPARE(store.stats().dataBytes, store.stats().liveBytes + 16);
+        QCOMPARE(store.find(mbid, EntityType::Artist, includes, 3600).toCbor(), payload.toCbor());
+
+        store.clear();
+        QCOMPARE(store.stats().records, 0);
+        QVERIFY(!store.contains(mbid, EntityType::Artist, includes, -1));
+    }
+}
+
+void TestParser::testStreamingSearchPage()
+{
+    // 以很小的块输入，确保实体和成员名跨块切分
+    QSharedPointer<StreamingParseState> state = m_handler->createStreamingState(RequestType::Search, m_context);
+    QVERIFY(state);
+
+    int partialItems = 0;
+    const int chunkSize = 37;
+    for (int pos = 0; pos < m_page.size(); pos += chunkSize) {
+        const ParsedResponse partial = m_handler->feedStreaming(state.data(), m_page.mid(pos, chunkSize), false);
+        QVERIFY(partial.success);
+        QVERIFY(partial.partial);
+        partialItems += partial.items.size();
+        QVERIFY(state->reader.bufferedBytes() < m_page.size() / 10);
+    }
+    QCOMPARE(partialItems, 100);
+
+    const ParsedResponse response = m_handler->feedStreaming(state.data(), QByteArray(), true);
+    const ParsedResponse expected = m_handler->handleResponse(RequestType::Search, m_page, m_context);
+    QVERIFY(response.success);
+    QVERIFY(!response.partial);
+    QCOMPARE(response.items.size(), expected.items.size());
+    QCOMPARE(response.totalCount, expected.totalCount);
+    QCOMPARE(response.offset, expected.offset);
+    QCOMPARE(response.items.last()->getId(), expected.items.last()->getId());
+}
+
+void TestParser::testStreamingTruncated()
+{
+    QSharedPointer<StreamingParseState> state = m_handler->createStreamingState(RequestType::Search, m_context);
+    QVERIFY(state);
+
+    m_handler->feedStreaming(state.data(), m_page.left(m_page.size() / 2), false);
+    const ParsedResponse response = m_handler->feedStreaming(state.data(), QByteArray(), true);
+    QVERIFY(!response.success);
+    QVERIFY(!response.errorMessage.isEmpty());
+}
+
+void TestParser::testStreamingMalformed()
+{
+    // 实体和分页成员各自解析失败时，整个响应按解析错误处理，而不是静默丢弃
+    const QList<QByteArray> pages = {
+        R"({"count":1,"offset":0,"artists":[{"id":}]})",
+        R"({"count":1,"offset":0,"artists":["not an object"]})",
+        R"({"count":12x,"offset":0,"artists":[]})",
+    };
+    for (const QByteArray &page : pages) {
+        QSharedPointer<StreamingParseState> state = m_handler->createStreamingState(RequestType::Search, m_context);
+        QVERIFY(state);
+        const ParsedResponse response = m_handler->feedStreaming(state.data(), page, true);
+        QVERIFY2(!response.success, page.constData());
+        QVERIFY(!response.partial);
+        QVERIFY(response.errorMessage.startsWith("Failed to parse response"));
+    }
+
+    // 详情响应不流式解析
+    QVERIFY(!m_handler->createStreamingState(RequestType::Details, m_context));
+}
+
+qint64 TestParser::heapInUse()
+{
+#if defined(__GLIBC__)
+#if __GLIBC_PREREQ(2, 33)
+    return qint64(mallinfo2().uordblks);
+#endif
+#endif
+    return -1;
+}
+
+qint64 TestParser::measureSession(bool intern, int pages)
+{
+    StringPool::instance().clear();
+    StringPool::instance().setEnabled(intern);
+
+    // 模拟一次会话：多页结果同时保留在内存中
+    const qint64 before = heapInUse();
+    QList<QSharedPointer<ResultItem>> session;
+    for (int page = 0; page < pages; ++page) {
+        session.append(m_handler->handleResponse(RequestType::Search, m_page, m_context).items);
+    }
+    const qint64 after = heapInUse();
+
+    StringPool::instance().setEnabled(true);
+    return before < 0 ? -1 : after - before;
+}
+
+void TestParser::testStringInterning()
+{
+    StringPool &pool = StringPool::instance();
+    pool.clear();
+
+    const QString a = pool.intern(QString("United Kingdom"));
+    const QString b = pool.intern(QString("United") + QString(" Kingdom"));
+    QCOMPARE(a, b);
+    QCOMPARE(a.constData(), b.constData());
+    QCOMPARE(pool.stats().hits, qint64(1));
+
+    // 过长的文本不参与驻留
+    const QString longText(StringPool::MAX_INTERN_LENGTH + 1, QChar('x'));
+    QVERIFY(pool.intern(longText).constData() == longText.constData());
+    QCOMPARE(pool.stats().entries, 1);
+
+    // 解析出的实体共享键名和重复值
+    const ParsedResponse response = m_handler->handleResponse(RequestType::Search, m_page, m_context);
+    const QVariantList first = response.items.at(0)->getDetailProperty("tags").toList();
+    const QVariantList second = response.items.at(1)->getDetailProperty("tags").toList();
+    QCOMPARE(first.first().toMap().value("name").toString().constData(),
+             second.first().toMap().value("name").toString().constData());
+
+    // ID、名称等各不相同的值不进入驻留池：池里只有键名和少量类型、国家、标签名
+    pool.clear();
+    const ParsedResponse fresh = m_handler->handleResponse(RequestType::Search, m_page, m_context);
+    for (const auto &item : fresh.items) {
+        item->getDetailProperty("tags");
+        item->getDetailProperty("area");
+    }
+    QVERIFY(pool.stats().entries > 0);
+    QVERIFY2(pool.stats().entries < fresh.items.size(),
+             qPrintable(QString::number(pool.stats().entries)));
+}
+
+void TestParser::reportSessionMemory()
+{
+    // 100页 × 100个实体 = 10k实体的会话，报告驻留前后的堆占用
+    const int pages = 100;
+    measureSession(true, 1);
+    const int onePageEntries = StringPool::instance().stats().entries;
+    const qint64 plain = measureSession(false, pages);
+    const qint64 interned = measureSession(true, pages);
+    const StringPool::Stats stats = StringPool::instance().stats();
+
+    qInfo().noquote() << QString("10k entities: pool %1 entries, %2/%3 lookups shared, %4 KiB of string data shared")
+                         .arg(stats.entries).arg(stats.hits).arg(stats.lookups).arg(stats.sharedBytes / 1024);
+    if (plain >= 0) {
+        qInfo().noquote() << QString("10k entities: heap %1 KiB without interning, %2 KiB with interning")
+                             .arg(plain / 1024).arg(interned / 1024);
+    }
+
+    // 堆统计受分配器影响，只作报告；驻留池的计数是确定的：
+    // 池的大小只取决于不同的键名和字段值，不随会话中的实体数量增长，
+    // 除每个字符串的第一次驻留外，其余请求都共享已有副本
+    QVERIFY(onePageEntries > 0);
+    QCOMPARE(stats.entries, onePageEntries);
+    QCOMPARE(stats.hits, stats.lookups - stats.entries);
+    QVERIFY(stats.sharedBytes > 0);
+}
+
+void TestParser::benchmarkSearchPageLegacy()
+{
+    // 旧流程：处理器、验证和解析器各构建一次文档
+    QBENCHMARK {
+        QString error;
+        const QJsonObject obj = ResponseParser::parseJsonResponse(m_page, &error);
+        QVERIFY(MusicBrainzParser::validateJsonData(m_page));
+        const QJsonObject root = QJsonDocument::fromJson(m_page).object();
+        const auto items = m_parser->parseSearchResponse(root, EntityType::Artist);
+        const auto pagination = ResponseParser::extractPagination(obj);
+        QCOMPARE(items.size(), 100);
+        QCOMPARE(pagination.first, 2500);
+    }
+}
+
+void TestParser::benchmarkSearchPageSingleParse()
+{
+    QBENCHMARK {
+        const ParsedResponse response = m_handler->handleResponse(RequestType::Search, m_page, m_context);
+        QCOMPARE(response.items.size(), 100);
+    }
+}
+
+void TestParser::benchmarkSearchPageEagerDecode()
+{
+    // 对照：所有复合字段在解析时立即转换
+    QBENCHMARK {
+        QJsonObject root;
+        QVERIFY(MusicBrainzParser::parseRootObject(m_page, &root));
+        const auto items = m_parser->parseSearchResponse(root, EntityType::Artist, false);
+        QCOMPARE(items.size(), 100);
+    }
+}
+
+void TestParser::benchmarkEntityTypeLookup()
+{
+    QStringList names;
+    for (const EntityMapping &mapping : ENTITY_MAPPINGS) {
+        names.append(QString::fromLatin1(mapping.singular.data(), qsizetype(mapping.singular.size())));
+    }
+    QJsonObject root;
+    QVERIFY(MusicBrainzParser::parseRootObject(m_page, &root));
+    const QJsonObject artist = root.value("artists").toArray().first().toObject();
+
+    QBENCHMARK {
+        int found = 0;
+        for (const QString &name : names) {
+            found += EntityUtils::stringToEntityType(name) != EntityType::Unknown;
+        }
+        found += MusicBrainzParser::detectEntityType(artist) == EntityType::Artist;
+        QCOMPARE(found, names.size() + 1);
+    }
+}
+
+void TestParser::benchmarkMbidValidationRegex()
+{
+    // 对照：原Validator::isValidMbid的实现
+    const QString text("b10bbbfc-cf9e-42e0-be17-e2c3e1d2600d");
+    QBENCHMARK {
+        QRegularExpression uuidRegex("^[0-9a-fA-F]{8}-[0-9a-fA-F]{4}-[0-9a-fA-F]{4}-[0-9a-fA-F]{4}-[0-9a-fA-F]{12}$");
+        QVERIFY(uuidRegex.match(text).hasMatch());
+    }
+}
+
+void TestParser::benchmarkMbidValidation()
+{
+    const QString text("b10bbbfc-cf9e-42e0-be17-e2c3e1d2600d");
+    QBENCHMARK {
+        QVERIFY(Validator::isValidMbid(text));
+    }
+}
+
+void TestParser::benchmarkEntityStoreLookup()
+{
+    QTemporaryDir dir;
+    QVERIFY(dir.isValid());
+    EntityStore store;
+    QVERIFY(store.open(dir.path()));
+
+    const QString includes = EntityUtils::getDefaultIncludes(EntityType::Artist);
+    QList<Mbid> ids;
+    for (int i = 0; i < 1000; ++i) {
+        const QString id = QString("489ce91b-6658-3307-9877-%1").arg(i, 12, 10, QChar('0'));
+        QVERIFY(store.insert(makeDetailsPayload(id), includes));
+        ids.append(Mbid::fromString(id));
+    }
+
+    // 热查找：一次索引探测加一次数据文件读取和CBOR解码
+    int index = 0;
+    QBENCHMARK {
+        const EntityPayload payload = store.find(ids.at(index), EntityType::Artist, includes, -1);
+        QVERIFY(!payload.isNull());
+        index = (index + 1) % ids.size();
+    }
+}
+
+QTEST_GUILESS_MAIN(TestParser)
+#include "tst_parser.moc"